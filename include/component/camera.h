@@ -70,14 +70,14 @@ public:
 
 	void OnDrawInspector(Entity entity) override;
 
-	void OnEntityResize(int newSize) override;
-
 	void UpdateAspect(const float newAspect);
 
 	void DecodeComponent(json& componentJson, const Entity entity) override;
 
 	void EncodeComponent(json& componentJson, const Entity entity) override;
 private:
+	void RefreshMainCamera();
+
 	GraphicManager* m_GraphicManager;
 };
 }
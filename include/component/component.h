@@ -26,10 +26,10 @@ SOFTWARE.
 #define COMPONENT_H
 #include <entity/entity.h>
 #include <component/component_type.h>
+#include <component/component_storage.h>
 #include <engine/metadata.h>
 #include "utility/json_utility.h"
 
-#define INIT_COMPONENT_NMB 100
 
 namespace dm
 {
@@ -48,47 +48,53 @@ public:
 
 	virtual ~ComponentBaseManager()
 	{
-		m_Components.clear();
+		m_Components.Clear();
 	};
 
 	virtual void Init() = 0;
 	 
 	virtual void Update() = 0;
 
-	void Clear()
+	virtual void Clear()
 	{
-		m_Components.clear();
-		m_Components.resize(INIT_COMPONENT_NMB);
+		m_Components.Clear();
 	}
 
 	virtual T* CreateComponent(Entity entity) = 0;
 	
 	virtual T* AddComponent(const Entity entity, T& component)
 	{
-		m_Components[entity - 1] = std::move(component);
-		return &m_Components[entity - 1];
+		return m_Components.Insert(entity, std::move(component));
 	};
 
 	virtual void DestroyComponent(Entity entity) = 0;
 
 	T* GetComponent(const Entity entity)
 	{
-		return &m_Components[entity - 1];
+		return m_Components.Get(entity);
 	};
 
-	std::vector<T>& GetComponents()
+	bool HasComponent(const Entity entity) const
+	{
+		return m_Components.Contains(entity);
+	}
+
+	ComponentStorage<T>& GetComponents()
 	{
 		return m_Components;
 	}
 
 	virtual void OnDrawInspector(Entity entity) = 0;
 
-	virtual void OnEntityResize(int newSize)
+	/**
+	 * \brief Make room for count more components so a batch of insertions does not grow the storage several times
+	 */
+	void ReserveComponents(const size_t count)
 	{
-		m_Components.resize(newSize);
+		m_Components.Reserve(m_Components.Size() + count);
 	}
 protected:
-	std::vector<T> m_Components{INIT_COMPONENT_NMB};
+	ComponentStorage<T> m_Components;
 };
 }
 
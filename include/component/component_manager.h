@@ -41,6 +41,8 @@ SOFTWARE.
 #include "debug_info.h"
 #include "materials/material_metal_roughness.h"
 
+#include <type_traits>
+
 namespace dm {
 class ComponentManagerContainer final : public Module
 {
@@ -70,6 +72,35 @@ public:
 
 	void DestroyComponent(Entity entity, ComponentType componentType) const;
 
+	/**
+	 * \brief Reserve count more components in the manager of every component of the mask
+	 */
+	void ReserveComponents(ComponentMask mask, size_t count) const;
+
+	/**
+	 * \brief Get the manager of a component, resolved at compile time instead of switching on the ComponentType
+	 */
+	template<typename T>
+	ComponentBaseManager<T>* GetManager() const
+	{
+		if constexpr (std::is_same_v<T, Transform>) { return m_TransformManager.get(); }
+		else if constexpr (std::is_same_v<T, Camera>) { return m_CameraManager.get(); }
+		else if constexpr (std::is_same_v<T, MaterialDefault>) { return m_MaterialDefaultManager.get(); }
+		else if constexpr (std::is_same_v<T, MaterialSkybox>) { return m_MaterialSkyboxManager.get(); }
+		else if constexpr (std::is_same_v<T, Model>) { return m_MeshManager.get(); }
+		else if constexpr (std::is_same_v<T, BoundingSphere>) { return m_BoundingSphereManager.get(); }
+		else if constexpr (std::is_same_v<T, Drawable>) { return m_DrawableManager.get(); }
+		else if constexpr (std::is_same_v<T, MeshRenderer>) { return m_MeshRendererManager.get(); }
+		else if constexpr (std::is_same_v<T, PointLight>) { return m_PointLightManager.get(); }
+		else if constexpr (std::is_same_v<T, DirectionalLight>) { return m_DirectionalLightManager.get(); }
+		else if constexpr (std::is_same_v<T, SpotLight>) { return m_SpotLightManager.get(); }
+		else if constexpr (std::is_same_v<T, ShadowRenderer>) { return m_ShadowRendererManager.get(); }
+		else if constexpr (std::is_same_v<T, MaterialTerrain>) { return m_MaterialTerrainManager.get(); }
+		else if constexpr (std::is_same_v<T, DebugInfo>) { return m_DebugInfoManager.get(); }
+		else if constexpr (std::is_same_v<T, MaterialMetalRoughness>) { return m_MaterialMetalRoughnessManager.get(); }
+		else { static_assert(sizeof(T) == 0, "Component without manager"); return nullptr; }
+	}
+
 	CameraManager* GetCameraManager() const { return m_CameraManager.get(); }
 
 	MaterialDefaultManager* GetMaterialManager() const { return m_MaterialDefaultManager.get(); }
@@ -83,8 +114,6 @@ public:
 	SpotLightManager* GetSpotLightManager() const { return m_SpotLightManager.get(); }
 
 	void DrawOnInspector(Entity entity) const;
-
-	void OnEntityResize(int newSize) const;
 private:
 	std::unique_ptr<TransformManager> m_TransformManager;
 	std::unique_ptr<CameraManager> m_CameraManager;
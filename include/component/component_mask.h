@@ -27,22 +27,51 @@ SOFTWARE.
 
 #include <component/component_type.h>
 
+#include <cstdint>
+#include <cstddef>
+
 namespace dm
 {
-
+/**
+ * \brief Fixed width bitset with one bit per ComponentType, stored in 128 bits words so Matches is a handful of SIMD instructions
+ */
 struct ComponentMask final
 {
-	unsigned int mask = 0;
+	static constexpr uint32_t BIT_NMB = 128;
+	static constexpr uint32_t WORD_NMB = BIT_NMB / 64;
+
+	alignas(16) uint64_t words[WORD_NMB] = {};
 
 	void AddComponent(ComponentType componentType);
 
 	void RemoveComponent(ComponentType componentType);
 
+	bool HasComponent(ComponentType componentType) const;
+
 	bool Matches(const ComponentMask systemMask) const;
 
+	bool Intersects(const ComponentMask other) const;
+
+	bool IsEmpty() const;
+
 	bool IsNewMatch(ComponentMask oldMask, const ComponentMask systemMask) const;
 
 	bool IsNoLongerMatch(ComponentMask oldMask, const ComponentMask systemMask) const;
+
+	ComponentMask& operator|=(const ComponentMask& other);
+
+	bool operator==(const ComponentMask& other) const;
+
+	bool operator!=(const ComponentMask& other) const;
+
+	size_t Hash() const;
+};
+
+static_assert(static_cast<uint32_t>(ComponentType::LENGTH) <= ComponentMask::BIT_NMB, "ComponentMask is too small for every ComponentType");
+
+struct ComponentMaskHash
+{
+	size_t operator()(const ComponentMask& mask) const { return mask.Hash(); }
 };
 }
 
@@ -0,0 +1,258 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef COMPONENT_STORAGE_H
+#define COMPONENT_STORAGE_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <type_traits>
+
+#include <entity/entity.h>
+
+namespace dm
+{
+/**
+ * \brief Sparse set used to store components. The sparse array map an entity index to a slot, components live in
+ * fixed size pages that are never reallocated and a removed component leaves a hole that is reused by the next insertion.
+ * A component therefore never moves while it is attached, raw pointers on it stay valid until it is removed.
+ * The owner list store the entity of each slot (INVALID_ENTITY for holes), iterating skips the holes.
+ */
+template<typename T>
+class ComponentStorage
+{
+public:
+	static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+	static constexpr uint32_t PAGE_SIZE = 256;
+
+	template<typename Storage, typename Value>
+	class SlotIterator
+	{
+	public:
+		SlotIterator(Storage* storage, const uint32_t slot) : m_Storage(storage), m_Slot(slot)
+		{
+			SkipHoles();
+		}
+
+		Value& operator*() const { return m_Storage->At(m_Slot); }
+		Value* operator->() const { return &m_Storage->At(m_Slot); }
+
+		Entity GetEntity() const { return m_Storage->m_Owners[m_Slot]; }
+
+		SlotIterator& operator++()
+		{
+			m_Slot++;
+			SkipHoles();
+			return *this;
+		}
+
+		bool operator==(const SlotIterator& other) const { return m_Slot == other.m_Slot; }
+		bool operator!=(const SlotIterator& other) const { return m_Slot != other.m_Slot; }
+
+	private:
+		void SkipHoles()
+		{
+			const auto& owners = m_Storage->m_Owners;
+			while (m_Slot < owners.size() && owners[m_Slot] == INVALID_ENTITY)
+			{
+				m_Slot++;
+			}
+		}
+
+		Storage* m_Storage;
+		uint32_t m_Slot;
+	};
+
+	using Iterator = SlotIterator<ComponentStorage, T>;
+	using ConstIterator = SlotIterator<const ComponentStorage, const T>;
+
+	ComponentStorage() = default;
+
+	~ComponentStorage()
+	{
+		Clear();
+	}
+
+	ComponentStorage(const ComponentStorage&) = delete;
+	ComponentStorage& operator=(const ComponentStorage&) = delete;
+
+	/**
+	 * \brief Attach a component to the entity, if the entity already has one it is replaced in place
+	 */
+	T* Insert(const Entity entity, T component)
+	{
+		const auto entityIndex = GetEntityIndex(entity);
+
+		if(entityIndex >= m_Sparse.size())
+		{
+			m_Sparse.resize(entityIndex + 1, INVALID_INDEX);
+		}
+
+		auto& slot = m_Sparse[entityIndex];
+
+		if(slot != INVALID_INDEX)
+		{
+			At(slot) = std::move(component);
+			m_Owners[slot] = entity;
+			return &At(slot);
+		}
+
+		if(!m_FreeSlots.empty())
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+			m_Owners[slot] = entity;
+		}
+		else
+		{
+			slot = static_cast<uint32_t>(m_Owners.size());
+			if(slot / PAGE_SIZE >= m_Pages.size())
+			{
+				m_Pages.push_back(std::make_unique<Page>());
+			}
+			m_Owners.push_back(entity);
+		}
+
+		m_Size++;
+
+		return new(&At(slot)) T(std::move(component));
+	}
+
+	/**
+	 * \brief Remove the component of the entity, its slot is kept as a hole until the next insertion
+	 */
+	void Remove(const Entity entity)
+	{
+		const auto entityIndex = GetEntityIndex(entity);
+
+		if(entityIndex >= m_Sparse.size() || m_Sparse[entityIndex] == INVALID_INDEX)
+		{
+			return;
+		}
+
+		const auto slot = m_Sparse[entityIndex];
+
+		At(slot).~T();
+		m_Owners[slot] = INVALID_ENTITY;
+		m_FreeSlots.push_back(slot);
+		m_Sparse[entityIndex] = INVALID_INDEX;
+		m_Size--;
+	}
+
+	bool Contains(const Entity entity) const
+	{
+		const auto entityIndex = GetEntityIndex(entity);
+		return entityIndex < m_Sparse.size() && m_Sparse[entityIndex] != INVALID_INDEX;
+	}
+
+	/**
+	 * \brief Return the component of the entity or nullptr if the entity doesn't have one
+	 */
+	T* Get(const Entity entity)
+	{
+		const auto entityIndex = GetEntityIndex(entity);
+
+		if(entityIndex >= m_Sparse.size() || m_Sparse[entityIndex] == INVALID_INDEX)
+		{
+			return nullptr;
+		}
+
+		return &At(m_Sparse[entityIndex]);
+	}
+
+	const T* Get(const Entity entity) const
+	{
+		return const_cast<ComponentStorage*>(this)->Get(entity);
+	}
+
+	/**
+	 * \brief Allocate the pages needed to hold size components, existing components are not moved
+	 */
+	void Reserve(const size_t size)
+	{
+		while(m_Pages.size() * PAGE_SIZE < size)
+		{
+			m_Pages.push_back(std::make_unique<Page>());
+		}
+		m_Owners.reserve(size);
+	}
+
+	void Clear()
+	{
+		for(uint32_t slot = 0; slot < m_Owners.size(); slot++)
+		{
+			if(m_Owners[slot] != INVALID_ENTITY)
+			{
+				At(slot).~T();
+			}
+		}
+
+		m_Sparse.clear();
+		m_Owners.clear();
+		m_FreeSlots.clear();
+		m_Pages.clear();
+		m_Size = 0;
+	}
+
+	size_t Size() const { return m_Size; }
+
+	bool Empty() const { return m_Size == 0; }
+
+	/**
+	 * \brief Entities owning each slot, in the same order as the iteration. Holes are INVALID_ENTITY
+	 */
+	const std::vector<Entity>& GetEntities() const { return m_Owners; }
+
+	Iterator begin() { return Iterator(this, 0); }
+	Iterator end() { return Iterator(this, static_cast<uint32_t>(m_Owners.size())); }
+	ConstIterator begin() const { return ConstIterator(this, 0); }
+	ConstIterator end() const { return ConstIterator(this, static_cast<uint32_t>(m_Owners.size())); }
+
+private:
+	struct Page
+	{
+		std::aligned_storage_t<sizeof(T), alignof(T)> components[PAGE_SIZE];
+	};
+
+	T& At(const uint32_t slot)
+	{
+		return *std::launder(reinterpret_cast<T*>(&m_Pages[slot / PAGE_SIZE]->components[slot % PAGE_SIZE]));
+	}
+
+	const T& At(const uint32_t slot) const
+	{
+		return *std::launder(reinterpret_cast<const T*>(&m_Pages[slot / PAGE_SIZE]->components[slot % PAGE_SIZE]));
+	}
+
+	std::vector<uint32_t> m_Sparse;
+	std::vector<std::unique_ptr<Page>> m_Pages;
+	std::vector<Entity> m_Owners;
+	std::vector<uint32_t> m_FreeSlots;
+	size_t m_Size = 0;
+};
+}
+
+#endif COMPONENT_STORAGE_H
@@ -0,0 +1,97 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef COMPONENT_VIEW_H
+#define COMPONENT_VIEW_H
+
+#include <tuple>
+#include <vector>
+
+#include <component/component_manager.h>
+
+namespace dm
+{
+/**
+ * \brief Typed access to the storages of a set of components. Storages are resolved once at construction,
+ * iterating does neither build EntityHandle nor go through the ComponentType switch
+ */
+template<typename... Ts>
+class View
+{
+public:
+	explicit View(const ComponentManagerContainer& componentManager) :
+		m_Storages(&componentManager.GetManager<Ts>()->GetComponents()...)
+	{}
+
+	/**
+	 * \brief Call func(Entity, Ts&...) for each given entity, every entity must own all the components (e.g. registered entities of a system)
+	 */
+	template<typename Entities, typename Func>
+	void ForEach(const Entities& entities, Func func) const
+	{
+		for (const auto entity : entities)
+		{
+			func(entity, *std::get<ComponentStorage<Ts>*>(m_Storages)->Get(entity)...);
+		}
+	}
+
+	/**
+	 * \brief Call func(Entity, Ts&...) for each entity owning all the components, driven by the slots of the first component
+	 */
+	template<typename Func>
+	void ForEach(Func func) const
+	{
+		auto& leading = *std::get<0>(m_Storages);
+		const auto& entities = leading.GetEntities();
+
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			const auto entity = entities[i];
+			if (entity == INVALID_ENTITY || !(std::get<ComponentStorage<Ts>*>(m_Storages)->Contains(entity) && ...))
+			{
+				continue;
+			}
+
+			func(entity, *std::get<ComponentStorage<Ts>*>(m_Storages)->Get(entity)...);
+		}
+	}
+
+	template<typename T>
+	T& Get(const Entity entity) const
+	{
+		return *std::get<ComponentStorage<T>*>(m_Storages)->Get(entity);
+	}
+
+	template<typename T>
+	bool Has(const Entity entity) const
+	{
+		return std::get<ComponentStorage<T>*>(m_Storages)->Contains(entity);
+	}
+
+private:
+	std::tuple<ComponentStorage<Ts>*...> m_Storages;
+};
+}
+
+#endif COMPONENT_VIEW_H
@@ -32,6 +32,11 @@ namespace dm
 struct Drawable : public ComponentBase
 {
 	bool isDrawable = false;
+
+	/**
+	 * \brief Rasterized in the occlusion buffer to hide the drawables behind it, meant for a few large meshes (needs a bounding sphere)
+	 */
+	bool isOccluder = false;
 };
 
 class DrawableManager : public ComponentBaseManager<Drawable>
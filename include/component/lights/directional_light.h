@@ -26,6 +26,7 @@ SOFTWARE.
 
 #include <component/lights/light.h>
 #include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
 
 namespace dm
 {
@@ -34,9 +35,16 @@ struct DirectionalLight : Light
 	glm::vec3 direction = glm::vec3(0, -1.0, -1.0);
 };
 
+struct Camera;
 class DirectionalLightManager : public ComponentBaseManager<DirectionalLight>
 {
 public:
+	/**
+	 * \brief Orthographic projection * view of the light enclosing the bounding sphere of the camera frustum,
+	 * shared by the shadow pass and the culling of the shadow casters
+	 */
+	static glm::mat4x4 ComputeLightSpaceMatrix(const Camera& camera, const glm::vec3& lightDirection);
+
 	void Init() override;
 
 	void Update() override;
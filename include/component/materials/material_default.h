@@ -29,6 +29,7 @@ SOFTWARE.
 #include <engine/color.h>
 #include <graphics/buffers/uniform_handle.h>
 #include <graphics/descriptor_handle.h>
+#include <graphics/object_buffer.h>
 #include <glm/mat4x4.hpp>
 
 namespace dm
@@ -65,11 +66,22 @@ public:
 
 	void DestroyComponent(Entity entity) override;
 
-	static std::vector<Shader::Define> GetDefines(const MaterialDefault &component);
+	/**
+	 * \brief By default the shaders read the objects from an ObjectBuffer at gl_InstanceIndex, gpuDriven selects the variant
+	 * reading them through the visible instances written by GpuCulling. The textures are sampled from the table of the
+	 * TextureManager when it is bindless, one pipeline then draws the materials of any textures
+	 */
+	static std::vector<Shader::Define> GetDefines(const MaterialDefault &component, bool gpuDriven = false);
 
+	/**
+	 * \brief Push the textures of the material, bindless pipelines have no samplers to push
+	 */
 	static void PushDescriptor(MaterialDefault& material, DescriptorHandle &descriptorSet);
 
-	static void PushUniform(MaterialDefault& material, const glm::mat4x4 worldPos, UniformHandle& uniformObject);
+	/**
+	 * \brief Object of the ObjectBuffer for a world matrix with the slots of the textures, the bounding sphere is left to the caller
+	 */
+	static ObjectData GetObjectData(const MaterialDefault& material, const glm::mat4x4& worldMatrix);
 
 	MaterialDefault& Get(const Entity entity);
 
@@ -25,14 +25,14 @@ SOFTWARE.
 #ifndef SHADOW_RENDERER_H
 #define SHADOW_RENDERER_H
 #include "component/component.h"
-#include "graphics/descriptor_handle.h"
 
 namespace dm
 {
+/**
+ * \brief Tag of the shadow casters, their matrix is written in the uniform ring by the shadow renderer
+ */
 struct ShadowRenderer : public ComponentBase
 {
-	DescriptorHandle descriptorSet;
-	UniformHandle uniformScene;
 };
 
 class ShadowRendererManager : public ComponentBaseManager<ShadowRenderer>
@@ -26,6 +26,7 @@ SOFTWARE.
 #define TRANSFORM_H
 
 #include <string>
+#include <vector>
 
 #include <component/component.h>
 
@@ -40,6 +41,29 @@ struct Transform final : ComponentBase
 	glm::vec3 scale = glm::vec3(1.0f);
 	glm::mat4 worldMatrix = glm::mat4x4(1.0f);
 
+	/**
+	 * \brief Set when position, rotation or scale change, the world matrix is recomputed by the next TransformManager::Update
+	 */
+	bool dirty = true;
+
+	void SetPosition(const glm::vec3& newPosition)
+	{
+		position = newPosition;
+		dirty = true;
+	}
+
+	void SetRotation(const glm::vec3& newRotation)
+	{
+		rotation = newRotation;
+		dirty = true;
+	}
+
+	void SetScale(const glm::vec3& newScale)
+	{
+		scale = newScale;
+		dirty = true;
+	}
+
 	friend std::ostream & operator<<(std::ostream & out, const Transform transform)
 	{
 		
@@ -48,6 +72,30 @@ struct Transform final : ComponentBase
 	}
 };
 
+/**
+ * \brief Positions, rotations and scales of a set of transforms split per axis, consecutive transforms fill the lanes of a SIMD register
+ */
+struct TransformSoA
+{
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> positionZ;
+	std::vector<float> rotationX;
+	std::vector<float> rotationY;
+	std::vector<float> rotationZ;
+	std::vector<float> scaleX;
+	std::vector<float> scaleY;
+	std::vector<float> scaleZ;
+
+	void Add(const Transform& transform);
+
+	void Reserve(size_t size);
+
+	void Clear();
+
+	size_t Size() const { return positionX.size(); }
+};
+
 class TransformManager final : public ComponentBaseManager<Transform>
 {
 public:
@@ -63,13 +111,70 @@ public:
 
 	void DestroyComponent(Entity entity) override;
 
-	static glm::mat4x4 GetWorldMatrix(Transform &component);
+	void Clear() override;
+
+	/**
+	 * \brief Attach the child to the parent, position, rotation and scale of the child become relative to the parent.
+	 * INVALID_ENTITY as parent detaches the child
+	 */
+	void SetParent(Entity child, Entity parent);
+
+	/**
+	 * \brief Return the parent of the entity or INVALID_ENTITY if its transform is a root
+	 */
+	Entity GetParent(Entity child) const;
+
+	/**
+	 * \brief Return the world matrix cached by the last Update, it is not recomputed
+	 */
+	static const glm::mat4x4& GetWorldMatrix(const Transform& component) { return component.worldMatrix; }
+
+	static glm::mat4x4 ComputeWorldMatrix(const Transform& component);
+
+	/**
+	 * \brief Compute the world matrices of the transforms in batches of SimdNative::WIDTH, worldMatrices[i] receives the matrix of the i-th transform
+	 */
+	static void ComputeWorldMatrices(const TransformSoA& transforms, glm::mat4x4* const* worldMatrices);
+
+	/**
+	 * \brief Entities whose world matrix changed during the last Update, children moved by their parent included
+	 */
+	const std::vector<Entity>& GetUpdatedEntities() const { return m_UpdatedEntities; }
 
 	void OnDrawInspector(Entity entity) override;
 
 	void DecodeComponent(json& componentJson, Entity entity) override;
 
 	void EncodeComponent(json& componentJson, const Entity entity) override;
+private:
+	/**
+	 * \brief Transform owning a parent. Nodes are sorted by depth so that a linear pass updates parents before their children
+	 */
+	struct HierarchyNode
+	{
+		Entity entity;
+		Entity parent;
+		uint32_t depth;
+		Transform* transform;
+		Transform* parentTransform;
+	};
+
+	static constexpr uint32_t INVALID_NODE = 0xFFFFFFFF;
+
+	void RemoveHierarchyNode(Entity entity);
+
+	void SortHierarchy();
+
+	void UpdateHierarchy();
+
+	TransformSoA m_DirtyTransforms;
+	std::vector<glm::mat4x4*> m_DirtyWorldMatrices;
+	std::vector<Transform*> m_UpdatedTransforms;
+	std::vector<Entity> m_UpdatedEntities;
+
+	std::vector<HierarchyNode> m_Hierarchy;
+	std::vector<uint32_t> m_HierarchyIndices;
+	bool m_IsHierarchySorted = true;
 };
 }
 
@@ -36,6 +36,17 @@ namespace dm
 struct EngineSettings
 {
 	Vec2i windowSize = Vec2i(800, 600);
+
+	/**
+	 * \brief Cull and submit the default meshes from a compute pass, see GpuCulling
+	 */
+	bool gpuDrivenMeshes = false;
+
+	/**
+	 * \brief Draw the directional shadow casters sharing a mesh with one instanced draw, the default meshes are already
+	 * drawn by runs of consecutive objects with one instanced draw
+	 */
+	bool instancedMeshes = false;
 };
 
 class Engine
@@ -72,6 +83,8 @@ public:
 
 	PipelineMaterialManager* GetPipelineMaterialManager() const;
 
+	JobSystem* GetJobSystem() const;
+
 	void SetApplication(EngineApplication* app);
 
 	EngineApplication* GetApplication() const { return m_App.get(); }
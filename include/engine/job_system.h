@@ -0,0 +1,223 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+#include <engine/module.h>
+
+namespace dm
+{
+class JobSystem;
+
+/**
+ * \brief Count the unfinished jobs of a group, used to wait on a group and to chain jobs after it
+ */
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	bool IsDone() const
+	{
+		if (m_Value.load(std::memory_order_acquire) != 0)
+		{
+			return false;
+		}
+
+		//The last job releases the lock after its decrement, once we get it the counter is not used by a worker anymore
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Value.load(std::memory_order_relaxed) == 0;
+	}
+
+private:
+	friend class JobSystem;
+
+	std::atomic<uint32_t> m_Value{ 0 };
+
+	//Decrements and continuations are done under this lock
+	mutable std::mutex m_Mutex;
+
+	//Jobs scheduled once the counter reaches zero
+	std::vector<std::pair<std::function<void()>, JobCounter*>> m_Continuations;
+};
+
+struct Job
+{
+	std::function<void()> function;
+	JobCounter* counter = nullptr;
+};
+
+/**
+ * \brief Chase-Lev work stealing deque. Only the owner thread pushes and pops at the bottom, other threads steal at the top
+ */
+class JobDeque
+{
+public:
+	JobDeque();
+
+	bool Push(Job* job);
+
+	Job* Pop();
+
+	Job* Steal();
+
+private:
+	static const int64_t CAPACITY = 4096;
+
+	std::atomic<int64_t> m_Top;
+	std::atomic<int64_t> m_Bottom;
+	std::array<std::atomic<Job*>, CAPACITY> m_Buffer;
+};
+
+/**
+ * \brief Run jobs on a pool of worker threads. Each worker owns a deque and steals from the others when it is empty,
+ * the thread which created the job system owns the first deque and helps while it waits.
+ */
+class JobSystem final : public Module
+{
+public:
+	/**
+	 * \param workerNmb number of worker threads, 0 uses one worker per hardware thread minus the main thread
+	 */
+	explicit JobSystem(size_t workerNmb = 0);
+	~JobSystem();
+
+	void Init() override;
+
+	void Update() override;
+
+	void Clear() override;
+
+	void Draw() override;
+
+	/**
+	 * \brief Schedule a job, the counter is incremented now and decremented when the job is done
+	 */
+	void Schedule(std::function<void()> function, JobCounter* counter = nullptr);
+
+	/**
+	 * \brief Schedule a job once every job of the dependency is done
+	 */
+	void ScheduleAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter = nullptr);
+
+	/**
+	 * \brief Execute jobs until the counter is done
+	 */
+	void Wait(const JobCounter& counter);
+
+	/**
+	 * \brief Call func(start, end) on sub ranges of [begin, end[ and wait for all of them
+	 */
+	template<typename Func>
+	void ParallelFor(const size_t begin, const size_t end, const size_t grainSize, Func func)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		const auto grain = std::max<size_t>(grainSize, 1);
+		if (end - begin <= grain || m_Workers.empty())
+		{
+			func(begin, end);
+			return;
+		}
+
+		JobCounter counter;
+		for (auto start = begin; start < end; start += grain)
+		{
+			const auto stop = std::min(start + grain, end);
+			Schedule([&func, start, stop]() { func(start, stop); }, &counter);
+		}
+
+		Wait(counter);
+	}
+
+	/**
+	 * \brief ParallelFor with a grain size giving a few ranges per thread
+	 */
+	template<typename Func>
+	void ParallelFor(const size_t begin, const size_t end, Func func)
+	{
+		const auto rangeNmb = GetThreadCount() * 4;
+		ParallelFor(begin, end, (end - begin + rangeNmb - 1) / rangeNmb, func);
+	}
+
+	/**
+	 * \brief Number of threads executing jobs, workers and main thread
+	 */
+	size_t GetThreadCount() const { return m_Workers.size() + 1; }
+
+private:
+	void WorkerLoop(size_t workerIndex);
+
+	/**
+	 * \brief Take a job from the own deque, the global queue or another deque, nullptr when nothing is queued
+	 */
+	Job* FindJob();
+
+	Job* TakeJob();
+
+	void Execute(Job* job);
+
+	void Enqueue(Job* job);
+
+	void Finish(JobCounter* counter);
+
+	size_t m_WorkerNmb;
+	std::atomic<bool> m_Running;
+	//Scheduled and not finished, including the jobs being executed
+	std::atomic<uint32_t> m_PendingJobs;
+	//Waiting in a deque or in the global queue, the idle workers only wake up for these
+	std::atomic<int32_t> m_QueuedJobs;
+
+	//deque 0 is owned by the main thread, deque i by the worker i - 1
+	std::vector<std::unique_ptr<JobDeque>> m_Deques;
+	std::vector<std::thread> m_Workers;
+
+	//Jobs scheduled from threads which don't belong to the job system
+	std::mutex m_GlobalMutex;
+	std::deque<Job*> m_GlobalQueue;
+
+	std::mutex m_SleepMutex;
+	std::condition_variable m_SleepCondition;
+};
+}
+
+#endif JOB_SYSTEM_H
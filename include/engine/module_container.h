@@ -36,6 +36,7 @@ class MeshManager;
 class EngineApplication;
 class PhysicManager;
 class PipelineMaterialManager;
+class JobSystem;
 
 class ModuleContainer
 {
@@ -64,6 +65,8 @@ public:
 	MeshManager* GetModelManager() const;
 
 	PipelineMaterialManager* GetPipelineMaterialManager() const;
+
+	JobSystem* GetJobSystem() const;
 private:
 	GraphicManager* m_GraphicManager;
 	InputManager* m_InputManager;
@@ -73,6 +76,7 @@ private:
 	MeshManager* m_ModelManager;
 	PhysicManager* m_PhysicManager;
 	PipelineMaterialManager* m_PipelineMaterialManager;
+	JobSystem* m_JobSystem;
 };
 }
 
@@ -0,0 +1,198 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DM_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DM_SIMD_SSE2
+#endif
+
+namespace dm
+{
+/**
+ * \brief Thin wrappers over the SIMD instruction sets. Each one exposes the same static functions so batched
+ * algorithms are written once as templates and instantiated with the widest set enabled at compile time.
+ */
+#if defined(DM_SIMD_SSE2) || defined(DM_SIMD_AVX2)
+struct SimdSse
+{
+	using Float = __m128;
+	using Int = __m128i;
+
+	static constexpr uint32_t WIDTH = 4;
+
+	static Float Load(const float* data) { return _mm_loadu_ps(data); }
+	static void Store(float* data, const Float a) { _mm_storeu_ps(data, a); }
+	static Float Set(const float value) { return _mm_set1_ps(value); }
+	static Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+	static Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+	static Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+	static Float Min(const Float a, const Float b) { return _mm_min_ps(a, b); }
+	static Float And(const Float a, const Float b) { return _mm_and_ps(a, b); }
+	static Float AndNot(const Float a, const Float b) { return _mm_andnot_ps(a, b); }
+	static Float Xor(const Float a, const Float b) { return _mm_xor_ps(a, b); }
+	static Float Or(const Float a, const Float b) { return _mm_or_ps(a, b); }
+	static Float GreaterEqual(const Float a, const Float b) { return _mm_cmpge_ps(a, b); }
+	static int MoveMask(const Float a) { return _mm_movemask_ps(a); }
+
+	static Int SetInt(const int32_t value) { return _mm_set1_epi32(value); }
+	static Int ToInt(const Float a) { return _mm_cvttps_epi32(a); }
+	static Float ToFloat(const Int a) { return _mm_cvtepi32_ps(a); }
+	static Int AddInt(const Int a, const Int b) { return _mm_add_epi32(a, b); }
+	static Int SubInt(const Int a, const Int b) { return _mm_sub_epi32(a, b); }
+	static Int AndInt(const Int a, const Int b) { return _mm_and_si128(a, b); }
+	static Int AndNotInt(const Int a, const Int b) { return _mm_andnot_si128(a, b); }
+	static Int EqualInt(const Int a, const Int b) { return _mm_cmpeq_epi32(a, b); }
+	static Int ShiftLeft29(const Int a) { return _mm_slli_epi32(a, 29); }
+	static Float AsFloat(const Int a) { return _mm_castsi128_ps(a); }
+
+	/**
+	 * \brief Store four 4-lane vectors transposed, lane i of (x, y, z, w) is written at outputs[i]
+	 */
+	static void StoreTransposed(Float x, Float y, Float z, Float w, float* const* outputs)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(outputs[0], x);
+		_mm_storeu_ps(outputs[1], y);
+		_mm_storeu_ps(outputs[2], z);
+		_mm_storeu_ps(outputs[3], w);
+	}
+};
+#endif
+
+#if defined(DM_SIMD_AVX2)
+struct SimdAvx2
+{
+	using Float = __m256;
+	using Int = __m256i;
+
+	static constexpr uint32_t WIDTH = 8;
+
+	static Float Load(const float* data) { return _mm256_loadu_ps(data); }
+	static void Store(float* data, const Float a) { _mm256_storeu_ps(data, a); }
+	static Float Set(const float value) { return _mm256_set1_ps(value); }
+	static Float Add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+	static Float Sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+	static Float Mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+	static Float Min(const Float a, const Float b) { return _mm256_min_ps(a, b); }
+	static Float And(const Float a, const Float b) { return _mm256_and_ps(a, b); }
+	static Float AndNot(const Float a, const Float b) { return _mm256_andnot_ps(a, b); }
+	static Float Xor(const Float a, const Float b) { return _mm256_xor_ps(a, b); }
+	static Float Or(const Float a, const Float b) { return _mm256_or_ps(a, b); }
+	static Float GreaterEqual(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static int MoveMask(const Float a) { return _mm256_movemask_ps(a); }
+
+	static Int SetInt(const int32_t value) { return _mm256_set1_epi32(value); }
+	static Int ToInt(const Float a) { return _mm256_cvttps_epi32(a); }
+	static Float ToFloat(const Int a) { return _mm256_cvtepi32_ps(a); }
+	static Int AddInt(const Int a, const Int b) { return _mm256_add_epi32(a, b); }
+	static Int SubInt(const Int a, const Int b) { return _mm256_sub_epi32(a, b); }
+	static Int AndInt(const Int a, const Int b) { return _mm256_and_si256(a, b); }
+	static Int AndNotInt(const Int a, const Int b) { return _mm256_andnot_si256(a, b); }
+	static Int EqualInt(const Int a, const Int b) { return _mm256_cmpeq_epi32(a, b); }
+	static Int ShiftLeft29(const Int a) { return _mm256_slli_epi32(a, 29); }
+	static Float AsFloat(const Int a) { return _mm256_castsi256_ps(a); }
+
+	/**
+	 * \brief Store four 8-lane vectors transposed, lane i of (x, y, z, w) is written at outputs[i]
+	 */
+	static void StoreTransposed(const Float x, const Float y, const Float z, const Float w, float* const* outputs)
+	{
+		SimdSse::StoreTransposed(
+			_mm256_castps256_ps128(x), _mm256_castps256_ps128(y),
+			_mm256_castps256_ps128(z), _mm256_castps256_ps128(w),
+			outputs);
+		SimdSse::StoreTransposed(
+			_mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1),
+			_mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1),
+			outputs + 4);
+	}
+};
+
+using SimdNative = SimdAvx2;
+#define DM_SIMD_ENABLED
+#elif defined(DM_SIMD_SSE2)
+using SimdNative = SimdSse;
+#define DM_SIMD_ENABLED
+#endif
+
+/**
+ * \brief Sine and cosine of every lane, Cephes single precision approximation (range reduction on pi / 4
+ * followed by a polynomial), accurate to a few ulps for angles up to a few thousand radians
+ */
+template<typename Simd>
+void SinCos(const typename Simd::Float x, typename Simd::Float& sin, typename Simd::Float& cos)
+{
+	using Float = typename Simd::Float;
+
+	const auto signMask = Simd::AsFloat(Simd::SetInt(static_cast<int32_t>(0x80000000)));
+
+	auto signSin = Simd::And(x, signMask);
+	auto absX = Simd::AndNot(signMask, x);
+
+	//Octant of the angle, rounded to an even value so the reduced angle lies in [-pi / 4, pi / 4]
+	auto octant = Simd::ToInt(Simd::Mul(absX, Simd::Set(1.27323954473516f)));
+	octant = Simd::AndInt(Simd::AddInt(octant, Simd::SetInt(1)), Simd::SetInt(~1));
+	const Float octantFloat = Simd::ToFloat(octant);
+
+	signSin = Simd::Xor(signSin, Simd::AsFloat(Simd::ShiftLeft29(Simd::AndInt(octant, Simd::SetInt(4)))));
+	const auto signCos = Simd::AsFloat(Simd::ShiftLeft29(Simd::AndNotInt(Simd::SubInt(octant, Simd::SetInt(2)), Simd::SetInt(4))));
+	const auto polynomialMask = Simd::AsFloat(Simd::EqualInt(Simd::AndInt(octant, Simd::SetInt(2)), Simd::SetInt(0)));
+
+	//Extended precision reduction, pi / 4 is split in three constants
+	absX = Simd::Sub(absX, Simd::Mul(octantFloat, Simd::Set(0.78515625f)));
+	absX = Simd::Sub(absX, Simd::Mul(octantFloat, Simd::Set(2.4187564849853515625e-4f)));
+	absX = Simd::Sub(absX, Simd::Mul(octantFloat, Simd::Set(3.77489497744594108e-8f)));
+
+	const auto z = Simd::Mul(absX, absX);
+
+	auto cosPolynomial = Simd::Set(2.443315711809948e-5f);
+	cosPolynomial = Simd::Add(Simd::Mul(cosPolynomial, z), Simd::Set(-1.388731625493765e-3f));
+	cosPolynomial = Simd::Add(Simd::Mul(cosPolynomial, z), Simd::Set(4.166664568298827e-2f));
+	cosPolynomial = Simd::Mul(Simd::Mul(cosPolynomial, z), z);
+	cosPolynomial = Simd::Sub(cosPolynomial, Simd::Mul(z, Simd::Set(0.5f)));
+	cosPolynomial = Simd::Add(cosPolynomial, Simd::Set(1.0f));
+
+	auto sinPolynomial = Simd::Set(-1.9515295891e-4f);
+	sinPolynomial = Simd::Add(Simd::Mul(sinPolynomial, z), Simd::Set(8.3321608736e-3f));
+	sinPolynomial = Simd::Add(Simd::Mul(sinPolynomial, z), Simd::Set(-1.6666654611e-1f));
+	sinPolynomial = Simd::Mul(Simd::Mul(sinPolynomial, z), absX);
+	sinPolynomial = Simd::Add(sinPolynomial, absX);
+
+	sin = Simd::Or(Simd::And(polynomialMask, sinPolynomial), Simd::AndNot(polynomialMask, cosPolynomial));
+	cos = Simd::Or(Simd::And(polynomialMask, cosPolynomial), Simd::AndNot(polynomialMask, sinPolynomial));
+
+	sin = Simd::Xor(sin, signSin);
+	cos = Simd::Xor(cos, signCos);
+}
+}
+
+#endif SIMD_H
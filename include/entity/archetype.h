@@ -0,0 +1,259 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ARCHETYPE_H
+#define ARCHETYPE_H
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <new>
+#include <cstdint>
+
+#include <entity/entity.h>
+#include <component/component_mask.h>
+#include <component/component_type.h>
+
+#define ARCHETYPE_CHUNK_SIZE (16 * 1024)
+
+namespace dm
+{
+/**
+ * \brief Type erased description of a component, used by archetypes to construct, move and destroy the component columns
+ */
+struct ArchetypeComponentInfo
+{
+	size_t size = 0;
+	size_t alignment = 1;
+
+	void (*construct)(void* dst) = nullptr;
+	void (*destruct)(void* dst) = nullptr;
+	void (*move)(void* dst, void* src) = nullptr;
+
+	template<typename T>
+	static ArchetypeComponentInfo Create()
+	{
+		ArchetypeComponentInfo info;
+		info.size = sizeof(T);
+		info.alignment = alignof(T);
+		info.construct = [](void* dst) { new(dst) T(); };
+		info.destruct = [](void* dst) { static_cast<T*>(dst)->~T(); };
+		info.move = [](void* dst, void* src) { *static_cast<T*>(dst) = std::move(*static_cast<T*>(src)); };
+		return info;
+	}
+};
+
+/**
+ * \brief Fixed size block of memory storing the entities of an archetype, one SoA column per component
+ */
+struct alignas(64) ArchetypeChunk
+{
+	unsigned char data[ARCHETYPE_CHUNK_SIZE];
+};
+
+/**
+ * \brief All entities sharing the same ComponentMask, packed in chunks. Rows are dense: every chunk is full except the last one
+ */
+class Archetype
+{
+public:
+	Archetype(ComponentMask mask, const std::vector<ComponentType>& componentTypes, const std::array<ArchetypeComponentInfo, static_cast<int>(ComponentType::LENGTH)>& infos);
+
+	~Archetype();
+
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	/**
+	 * \brief Add a row for the entity, its components are default constructed
+	 * \return the row of the entity
+	 */
+	uint32_t Add(Entity entity);
+
+	/**
+	 * \brief Remove a row by moving the last row in its place
+	 * \return the entity moved in the row or INVALID_ENTITY if the removed row was the last one
+	 */
+	Entity Remove(uint32_t row);
+
+	bool HasComponent(ComponentType componentType) const { return m_ColumnIndex[static_cast<int>(componentType)] >= 0; }
+
+	void* GetComponent(uint32_t row, ComponentType componentType) const;
+
+	void* GetColumn(size_t chunkIndex, ComponentType componentType) const;
+
+	Entity* GetEntities(size_t chunkIndex) const;
+
+	uint32_t GetChunkEntityCount(size_t chunkIndex) const;
+
+	size_t GetChunkCount() const { return m_Chunks.size(); }
+
+	uint32_t GetChunkCapacity() const { return m_ChunkCapacity; }
+
+	uint32_t GetEntityCount() const { return m_EntityCount; }
+
+	ComponentMask GetMask() const { return m_Mask; }
+
+	const std::vector<ComponentType>& GetComponentTypes() const { return m_ComponentTypes; }
+
+private:
+	void* GetElement(uint32_t row, size_t column) const;
+
+	ComponentMask m_Mask;
+	std::vector<ComponentType> m_ComponentTypes;
+	std::vector<ArchetypeComponentInfo> m_Infos;
+	std::array<int, static_cast<int>(ComponentType::LENGTH)> m_ColumnIndex;
+
+	//Offset of the entity column and of each component column inside a chunk
+	size_t m_EntitiesOffset;
+	std::vector<size_t> m_ColumnOffsets;
+
+	uint32_t m_ChunkCapacity;
+	uint32_t m_EntityCount;
+	std::vector<std::unique_ptr<ArchetypeChunk>> m_Chunks;
+};
+
+/**
+ * \brief View on the entities of one chunk, given to the systems when streaming an archetype storage
+ */
+class ArchetypeChunkView
+{
+public:
+	ArchetypeChunkView(const Archetype& archetype, const size_t chunkIndex) :
+		m_Archetype(archetype),
+		m_ChunkIndex(chunkIndex)
+	{}
+
+	uint32_t Size() const { return m_Archetype.GetChunkEntityCount(m_ChunkIndex); }
+
+	const Entity* GetEntities() const { return m_Archetype.GetEntities(m_ChunkIndex); }
+
+	template<typename T>
+	T* GetColumn(const ComponentType componentType) const
+	{
+		return static_cast<T*>(m_Archetype.GetColumn(m_ChunkIndex, componentType));
+	}
+
+private:
+	const Archetype& m_Archetype;
+	size_t m_ChunkIndex;
+};
+
+/**
+ * \brief Archetype storage mode: entities with the same ComponentMask live together in fixed size chunks,
+ * so systems stream contiguous component columns instead of gathering each component from its own manager.
+ */
+class ArchetypeStorage
+{
+public:
+	ArchetypeStorage();
+
+	~ArchetypeStorage();
+
+	template<typename T>
+	void RegisterComponent(const ComponentType componentType)
+	{
+		m_ComponentInfos[static_cast<int>(componentType)] = ArchetypeComponentInfo::Create<T>();
+	}
+
+	template<typename T>
+	T* AddComponent(const Entity entity, const ComponentType componentType, T component)
+	{
+		auto result = static_cast<T*>(AddComponent(entity, componentType));
+		*result = std::move(component);
+		return result;
+	}
+
+	/**
+	 * \brief Move the entity in the archetype with the new component, the new component is default constructed.
+	 * If the entity already has the component it stays in its row and the existing component is returned
+	 */
+	void* AddComponent(Entity entity, ComponentType componentType);
+
+	void RemoveComponent(Entity entity, ComponentType componentType);
+
+	void RemoveEntity(Entity entity);
+
+	bool HasComponent(Entity entity, ComponentType componentType) const;
+
+	template<typename T>
+	T* GetComponent(const Entity entity, const ComponentType componentType) const
+	{
+		return static_cast<T*>(GetComponent(entity, componentType));
+	}
+
+	void* GetComponent(Entity entity, ComponentType componentType) const;
+
+	/**
+	 * \brief Call func(ArchetypeChunkView&) for each non empty chunk whose archetype matches the signature
+	 */
+	template<typename Func>
+	void ForEachChunk(const ComponentMask signature, Func func) const
+	{
+		for (const auto& archetype : m_Archetypes)
+		{
+			if (!archetype->GetMask().Matches(signature))
+			{
+				continue;
+			}
+
+			for (size_t chunkIndex = 0; chunkIndex < archetype->GetChunkCount(); chunkIndex++)
+			{
+				ArchetypeChunkView view(*archetype, chunkIndex);
+
+				if (view.Size() == 0)
+				{
+					continue;
+				}
+
+				func(view);
+			}
+		}
+	}
+
+	size_t GetArchetypeCount() const { return m_Archetypes.size(); }
+
+	void Clear();
+
+private:
+	struct EntityLocation
+	{
+		Archetype* archetype = nullptr;
+		uint32_t row = 0;
+	};
+
+	Archetype* GetOrCreateArchetype(ComponentMask mask);
+
+	void MoveEntity(Entity entity, ComponentMask newMask);
+
+	std::array<ArchetypeComponentInfo, static_cast<int>(ComponentType::LENGTH)> m_ComponentInfos;
+	std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+	std::unordered_map<ComponentMask, Archetype*, ComponentMaskHash> m_ArchetypeMap;
+	std::vector<EntityLocation> m_EntityLocations;
+};
+}
+
+#endif ARCHETYPE_H
@@ -25,6 +25,9 @@ SOFTWARE.
 #ifndef ENTITY_H
 #define ENTITY_H
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include <component/component_type.h>
 #include <component/component_mask.h>
@@ -34,15 +37,52 @@ SOFTWARE.
 
 namespace dm
 {
+/**
+ * \brief An entity is a 32 bits id split in two parts:
+ *  - the lower ENTITY_INDEX_BITS bits store the slot index + 1 (0 is kept for INVALID_ENTITY)
+ *  - the upper ENTITY_GENERATION_BITS bits store the generation of the slot, incremented each time the slot is recycled
+ */
 using Entity = unsigned int ;
+using EntityIndex = unsigned int;
+using EntityGeneration = unsigned int;
+
 const Entity INVALID_ENTITY = 0U;
 
+const unsigned int ENTITY_INDEX_BITS = 24;
+const unsigned int ENTITY_GENERATION_BITS = 8;
+const Entity ENTITY_INDEX_MASK = (1U << ENTITY_INDEX_BITS) - 1;
+const Entity ENTITY_GENERATION_MASK = (1U << ENTITY_GENERATION_BITS) - 1;
+
+/**
+ * \brief Index of INVALID_ENTITY, also used to mark the end of the free list
+ */
+const EntityIndex INVALID_ENTITY_INDEX = ENTITY_INDEX_MASK;
+
+inline EntityIndex GetEntityIndex(const Entity entity)
+{
+	return ((entity & ENTITY_INDEX_MASK) - 1) & ENTITY_INDEX_MASK;
+}
+
+inline EntityGeneration GetEntityGeneration(const Entity entity)
+{
+	return (entity >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK;
+}
+
+inline Entity MakeEntity(const EntityIndex index, const EntityGeneration generation)
+{
+	return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | ((index + 1) & ENTITY_INDEX_MASK);
+}
+
+class EntityCommandBuffer;
+class EntityQueryCache;
+class EntitySet;
+
 class EntityManager final : public Module
 {
 public:
 	EntityManager();
 
-	~EntityManager() = default;
+	~EntityManager();
 
 	void Init() override;
 
@@ -55,8 +95,29 @@ public:
 	EntityManager(const EntityManager &) = delete; //delete copy constructor
 
 	Entity CreateEntity();
+
+	/**
+	 * \brief Release every component of the entity then free its slot for the next created entity
+	 */
 	void DestroyEntity(Entity entity);
 
+	/**
+	 * \brief Create count entities at once, masks and component storages are resized a single time
+	 */
+	std::vector<Entity> CreateEntities(size_t count);
+
+	/**
+	 * \brief Attach the components of the mask on every entity, every component storage is grown a single time.
+	 * Components missing from their manager are created with their default values, the masks and the query caches
+	 * are updated once per group of entities sharing the same signature
+	 */
+	void AddComponents(const std::vector<Entity>& entities, ComponentMask mask);
+
+	/**
+	 * \brief Check if the entity is still alive, an entity destroyed and whose index has been recycled is not alive
+	 */
+	bool IsAlive(Entity entity) const;
+
 	void AddComponent(Entity entity, ComponentType componentType);
 
 	void DestroyComponent(Entity entity, ComponentType componentType);
@@ -67,17 +128,49 @@ public:
 
 	ComponentMask GetEntityMask(Entity entity);
 
-	std::vector<Entity> GetEntities()
-	{
-		return m_EntityInfos;
-	}
+	/**
+	 * \brief Return all alive entities
+	 */
+	std::vector<Entity> GetEntities() const;
+
+	size_t GetEntityCount() const { return m_EntityCount; }
+
+	/**
+	 * \brief Alive entities whose mask matches the signature. The set is shared by every caller using the same signature
+	 * and kept up to date each time a mask changes, the reference stays valid for the life time of the manager
+	 */
+	const EntitySet& GetQuery(ComponentMask signature);
+
+	/**
+	 * \brief Command buffer of the calling thread, its commands are applied at the next PlaybackCommandBuffers
+	 */
+	EntityCommandBuffer& GetCommandBuffer();
+
+	/**
+	 * \brief Sync point: apply the structural changes recorded by every thread since the last playback
+	 */
+	void PlaybackCommandBuffers();
 
 private:
 	void ResizeEntity();
 
-	unsigned int m_LastEntity = 0;
+	void SetEntityMask(EntityIndex index, ComponentMask newMask);
+
+	//Each slot store the alive entity or, if the slot is free, the next free index and the generation the slot will be reused with
 	std::vector<Entity> m_EntityInfos;
 	std::vector<ComponentMask> m_EntityMask;
+
+	EntityIndex m_FreeEntityIndex = INVALID_ENTITY_INDEX;
+	size_t m_EntityCount = 0;
+
+	//One command buffer per recording thread, kept between two playbacks
+	std::mutex m_CommandBufferMutex;
+	std::vector<std::unique_ptr<EntityCommandBuffer>> m_CommandBuffers;
+	std::vector<std::thread::id> m_CommandBufferThreads;
+
+	//Queries are created lazily by systems which may update in parallel
+	std::mutex m_QueryMutex;
+	std::unique_ptr<EntityQueryCache> m_QueryCache;
 };
 }
 
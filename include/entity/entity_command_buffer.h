@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ENTITY_COMMAND_BUFFER_H
+#define ENTITY_COMMAND_BUFFER_H
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+#include <entity/entity.h>
+#include <component/component_type.h>
+
+namespace dm
+{
+class ComponentManagerContainer;
+struct ComponentBase;
+
+/**
+ * \brief Entity created by a command buffer, only valid inside the buffer which created it until the playback
+ */
+struct DeferredEntity
+{
+	uint32_t index = 0;
+};
+
+/**
+ * \brief Record structural changes (create/destroy entities, add/remove components) to apply them later at a sync point.
+ * A buffer is used by only one thread, the EntityManager gives one buffer per thread and plays them back together.
+ */
+class EntityCommandBuffer
+{
+public:
+	DeferredEntity CreateEntity();
+
+	void DestroyEntity(Entity entity);
+
+	/**
+	 * \brief Create a default component with its manager at playback
+	 */
+	void CreateComponent(Entity entity, ComponentType componentType);
+
+	void CreateComponent(DeferredEntity entity, ComponentType componentType);
+
+	template<typename T>
+	void AddComponent(const Entity entity, const ComponentType componentType, T component)
+	{
+		Record(entity, INVALID_DEFERRED, CommandType::ADD_COMPONENT, componentType, MakeAddFunction(componentType, std::move(component)));
+	}
+
+	template<typename T>
+	void AddComponent(const DeferredEntity entity, const ComponentType componentType, T component)
+	{
+		Record(INVALID_ENTITY, entity.index, CommandType::ADD_COMPONENT, componentType, MakeAddFunction(componentType, std::move(component)));
+	}
+
+	void DestroyComponent(Entity entity, ComponentType componentType);
+
+	bool Empty() const { return m_Commands.empty(); }
+
+	size_t Size() const { return m_Commands.size(); }
+
+	void Clear();
+
+	/**
+	 * \brief Apply every recorded command of the buffers in one batched pass and clear the buffers.
+	 * Commands are sorted per entity so each entity is resolved in a single pass.
+	 */
+	static void Playback(const std::vector<std::unique_ptr<EntityCommandBuffer>>& commandBuffers);
+
+private:
+	enum class CommandType : uint8_t
+	{
+		CREATE_COMPONENT,
+		ADD_COMPONENT,
+		DESTROY_COMPONENT,
+		DESTROY_ENTITY
+	};
+
+	using AddFunction = std::function<void(ComponentManagerContainer&, Entity)>;
+
+	struct Command
+	{
+		Entity entity = INVALID_ENTITY;
+		uint32_t deferredIndex = 0;
+		uint32_t sequence = 0;
+		CommandType type = CommandType::CREATE_COMPONENT;
+		ComponentType componentType = ComponentType::NONE;
+		AddFunction addFunction;
+	};
+
+	static const uint32_t INVALID_DEFERRED = 0xFFFFFFFF;
+
+	template<typename T>
+	static AddFunction MakeAddFunction(const ComponentType componentType, T component)
+	{
+		component.componentType = componentType;
+
+		return [component](ComponentManagerContainer& componentManager, const Entity entity) mutable
+		{
+			AddComponentToManager(componentManager, entity, component);
+		};
+	}
+
+	static void AddComponentToManager(ComponentManagerContainer& componentManager, Entity entity, ComponentBase& component);
+
+	void Record(Entity entity, uint32_t deferredIndex, CommandType type, ComponentType componentType, AddFunction addFunction = nullptr);
+
+	std::vector<Command> m_Commands;
+	uint32_t m_DeferredEntityNmb = 0;
+};
+}
+
+#endif ENTITY_COMMAND_BUFFER_H
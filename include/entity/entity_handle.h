@@ -28,8 +28,6 @@ SOFTWARE.
 #include <entity/entity.h>
 #include <component/component_manager.h>
 #include <component/component_type.h>
-#include <system/system_manager.h>
-#include "graphics/renderer_container.h"
 
 namespace dm
 {
@@ -61,13 +59,15 @@ public:
 		return static_cast<T*>(m_ComponentManager->GetComponent(m_Entity, componentType));
 	}
 
+	template<class T>
+	T* GetComponent() const
+	{
+		return m_ComponentManager->GetManager<T>()->GetComponent(m_Entity);
+	}
+
 	void AddComponentType(const ComponentType componentType) const
 	{
-		const auto oldMask = m_EntityManager->GetEntityMask(m_Entity);
 		m_EntityManager->AddComponent(m_Entity, componentType);
-		m_SystemManager->AddComponent(m_Entity, oldMask, m_EntityManager->GetEntityMask(m_Entity));
-		if (m_RendererContainer != nullptr)
-			m_RendererContainer->AddComponent(m_Entity, oldMask, m_EntityManager->GetEntityMask(m_Entity));
 	}
 
 	bool HasComponent(ComponentType componentType) const;
@@ -82,8 +82,6 @@ private:
 	Entity m_Entity;
 	ComponentManagerContainer* m_ComponentManager = nullptr;
 	EntityManager* m_EntityManager = nullptr;
-	SystemManager* m_SystemManager = nullptr;
-	RendererContainer* m_RendererContainer = nullptr;
 };
 }
 
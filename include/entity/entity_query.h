@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ENTITY_QUERY_H
+#define ENTITY_QUERY_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include <entity/entity.h>
+#include <entity/entity_set.h>
+#include <component/component_mask.h>
+
+namespace dm
+{
+/**
+ * \brief Entity sets indexed by signature. Each set is shared by every system and renderer using the same signature
+ * and is updated incrementally each time the mask of an entity changes, nobody has to rescan the entities
+ */
+class EntityQueryCache
+{
+public:
+	/**
+	 * \brief Return the set of the signature or nullptr if no query has been created for it
+	 */
+	EntitySet* FindQuery(ComponentMask signature);
+
+	/**
+	 * \brief Create an empty set for the signature, the set is never moved so references on it stay valid
+	 */
+	EntitySet& AddQuery(ComponentMask signature);
+
+	/**
+	 * \brief Insert or remove the entity in the sets whose signature it starts or stops matching
+	 */
+	void OnMaskChanged(Entity entity, ComponentMask oldMask, ComponentMask newMask);
+
+	/**
+	 * \brief Same as OnMaskChanged for entities sharing their old and new masks, each set is tested once for the whole group
+	 */
+	void OnMasksChanged(const std::vector<Entity>& entities, ComponentMask oldMask, ComponentMask newMask);
+
+	/**
+	 * \brief Empty every set, the queries themselves are kept
+	 */
+	void Clear();
+
+private:
+	struct Query
+	{
+		ComponentMask signature;
+		std::unique_ptr<EntitySet> entities;
+	};
+
+	std::vector<Query> m_Queries;
+	std::unordered_map<ComponentMask, size_t, ComponentMaskHash> m_QueryIndices;
+};
+}
+
+#endif ENTITY_QUERY_H
@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef ENTITY_SET_H
+#define ENTITY_SET_H
+
+#include <vector>
+#include <cstdint>
+
+#include <entity/entity.h>
+
+namespace dm
+{
+/**
+ * \brief Dense list of entities with an entity -> slot map, insertion and removal are O(1). Removal swaps the last entity in the freed slot.
+ * The slots are indexed by entity index, an entity of another generation at the same index is not contained
+ */
+class EntitySet
+{
+public:
+	using ConstIterator = std::vector<Entity>::const_iterator;
+
+	/**
+	 * \brief Add the entity, does nothing if it is already in the set. A dead entity left at the same index is replaced
+	 */
+	void Insert(const Entity entity)
+	{
+		const auto entityIndex = GetEntityIndex(entity);
+
+		if (entityIndex >= m_Slots.size())
+		{
+			m_Slots.resize(entityIndex + 1, INVALID_SLOT);
+		}
+		else if (m_Slots[entityIndex] != INVALID_SLOT)
+		{
+			if (m_Entities[m_Slots[entityIndex]] != entity)
+			{
+				m_Entities[m_Slots[entityIndex]] = entity;
+				m_Version++;
+			}
+			return;
+		}
+
+		m_Slots[entityIndex] = static_cast<uint32_t>(m_Entities.size());
+		m_Entities.push_back(entity);
+		m_Version++;
+	}
+
+	void Insert(const std::vector<Entity>& entities)
+	{
+		m_Entities.reserve(m_Entities.size() + entities.size());
+
+		for (const auto entity : entities)
+		{
+			Insert(entity);
+		}
+	}
+
+	void Remove(const Entity entity)
+	{
+		if (!Contains(entity))
+		{
+			return;
+		}
+
+		const auto entityIndex = GetEntityIndex(entity);
+
+		const auto slot = m_Slots[entityIndex];
+		const auto lastEntity = m_Entities.back();
+
+		m_Entities[slot] = lastEntity;
+		m_Slots[GetEntityIndex(lastEntity)] = slot;
+
+		m_Entities.pop_back();
+		m_Slots[entityIndex] = INVALID_SLOT;
+		m_Version++;
+	}
+
+	bool Contains(const Entity entity) const
+	{
+		const auto entityIndex = GetEntityIndex(entity);
+		return entityIndex < m_Slots.size() && m_Slots[entityIndex] != INVALID_SLOT && m_Entities[m_Slots[entityIndex]] == entity;
+	}
+
+	void Reserve(const size_t size) { m_Entities.reserve(size); }
+
+	/**
+	 * \brief Only the slots of the contained entities are reset, clearing a small set each frame stays cheap
+	 */
+	void Clear()
+	{
+		for (const auto entity : m_Entities)
+		{
+			m_Slots[GetEntityIndex(entity)] = INVALID_SLOT;
+		}
+
+		m_Entities.clear();
+		m_Version++;
+	}
+
+	size_t Size() const { return m_Entities.size(); }
+
+	bool Empty() const { return m_Entities.empty(); }
+
+	/**
+	 * \brief Incremented by every insertion and removal, lets a reader skip its work when the set did not change
+	 */
+	uint32_t GetVersion() const { return m_Version; }
+
+	const std::vector<Entity>& GetEntities() const { return m_Entities; }
+
+	Entity operator[](const size_t index) const { return m_Entities[index]; }
+
+	ConstIterator begin() const { return m_Entities.begin(); }
+	ConstIterator end() const { return m_Entities.end(); }
+
+private:
+	static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+	std::vector<Entity> m_Entities;
+	std::vector<uint32_t> m_Slots;
+	uint32_t m_Version = 0;
+};
+}
+
+#endif ENTITY_SET_H
@@ -25,16 +25,29 @@ SOFTWARE.
 #ifndef MODEL_H
 #define MODEL_H
 #include <memory>
+#include <vector>
 #include <graphics/command_buffer.h>
 #include <graphics/buffers/buffer.h>
 #include "mesh_vertex.h"
+#include <physic/aabb.h>
 #include <glm/glm.hpp>
+#include <limits>
+#include <mutex>
 
 namespace dm
 {
 class Mesh
 {
 public:
+	/**
+	 * \brief CPU copy of the triangles of a mesh, rasterized by the occlusion culling
+	 */
+	struct OccluderGeometry
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<uint32_t> indices;
+	};
+
 	Mesh();
 
 	virtual ~Mesh() = default;
@@ -50,6 +63,17 @@ public:
 
 	bool CmdRender(const CommandBuffer &commandBuffer, const uint32_t &instance = 1) const;
 
+	/**
+	 * \brief Bind the vertex and index buffers without drawing, e.g. before an indirect draw
+	 */
+	bool CmdBind(const CommandBuffer &commandBuffer) const;
+
+	/**
+	 * \brief Draw with the buffers bound by a previous CmdBind, consecutive draws of the same mesh bind it once.
+	 * firstInstance offsets the per instance attributes, e.g. the range of a group in an InstanceBuffer
+	 */
+	bool CmdDraw(const CommandBuffer &commandBuffer, const uint32_t &instance = 1, const uint32_t &firstInstance = 0) const;
+
 	const Buffer *GetVertexBuffer() const { return m_VertexBuffer.get(); }
 
 	const Buffer *GetIndexBuffer() const { return m_IndexBuffer.get(); }
@@ -58,8 +82,24 @@ public:
 
 	const uint32_t &GetIndexCount() const { return m_IndexCount; }
 
+	/**
+	 * \brief Radius of the sphere around GetCenter enclosing every vertex
+	 */
 	const float &GetRadius() const { return m_Radius; }
 
+	/**
+	 * \brief Center of the mesh space bounding box, also used as center of the bounding sphere
+	 */
+	glm::vec3 GetCenter() const { return m_Aabb.GetCenter(); }
+
+	const Aabb &GetAabb() const { return m_Aabb; }
+
+	/**
+	 * \brief Only the meshes used as occluders keep a CPU copy, it is built on the first call by loading the mesh again
+	 * without uploading it
+	 */
+	const OccluderGeometry &GetOccluderGeometry();
+
 	static VkIndexType GetIndexType() { return VK_INDEX_TYPE_UINT32; }
 protected:
 	template<typename T>
@@ -67,6 +107,18 @@ protected:
 	{
 		static_assert(std::is_base_of<VertexMesh, T>::value, "T must derive from ModelVertex");
 
+		if (m_LoadingOccluder)
+		{
+			//Called from GetOccluderGeometry, the buffers and the bounds are already there
+			m_OccluderGeometry->positions.reserve(vertices.size());
+			for (const auto &vertex : vertices)
+			{
+				m_OccluderGeometry->positions.emplace_back(vertex.position.x, vertex.position.y, vertex.position.z);
+			}
+			m_OccluderGeometry->indices = indices;
+			return;
+		}
+
 		m_VertexBuffer = nullptr;
 		m_IndexBuffer = nullptr;
 
@@ -104,18 +156,31 @@ protected:
 			commandBuffer.SubmitIdle();
 		}
 
-		m_MinExtents = glm::vec3(std::numeric_limits<float>::max());
-		m_MaxExtents = glm::vec3(std::numeric_limits<float>::min());
+		m_Aabb.min = glm::vec3(std::numeric_limits<float>::max());
+		m_Aabb.max = glm::vec3(std::numeric_limits<float>::lowest());
 
 		for (const auto &vertex : vertices)
 		{
 			glm::vec3 position = glm::vec3(vertex.position.x, vertex.position.y, vertex.position.z);
-			m_MinExtents = glm::vec3(std::min(m_MinExtents.x, position.x), std::min(m_MinExtents.y, position.y), std::min(m_MinExtents.z, position.z));
-			m_MaxExtents = glm::vec3(std::max(m_MaxExtents.x, position.x), std::max(m_MaxExtents.y, position.y), std::max(m_MaxExtents.z, position.z));
-			//m_MaxExtents = glm::max(m_MaxExtents, position);
+			m_Aabb.min = glm::min(m_Aabb.min, position);
+			m_Aabb.max = glm::max(m_Aabb.max, position);
 		}
-		
-		m_Radius = std::max(glm::length(m_MinExtents), glm::length(m_MaxExtents));
+
+		if (vertices.empty())
+		{
+			m_Aabb = Aabb();
+		}
+
+		//Sphere around the box center instead of the origin, meshes not centered on their pivot get a tight radius
+		const auto center = m_Aabb.GetCenter();
+		auto squaredRadius = 0.0f;
+		for (const auto &vertex : vertices)
+		{
+			const auto offset = glm::vec3(vertex.position.x, vertex.position.y, vertex.position.z) - center;
+			squaredRadius = std::max(squaredRadius, glm::dot(offset, offset));
+		}
+
+		m_Radius = std::sqrt(squaredRadius);
 	}
 private:
 	std::unique_ptr<Buffer> m_VertexBuffer;
@@ -124,8 +189,11 @@ private:
 	uint32_t m_VertexCount;
 	uint32_t m_IndexCount;
 
-	glm::vec3 m_MinExtents;
-	glm::vec3 m_MaxExtents;
+	std::mutex m_OccluderMutex;
+	std::unique_ptr<OccluderGeometry> m_OccluderGeometry;
+	bool m_LoadingOccluder = false;
+
+	Aabb m_Aabb;
 	float m_Radius;
 };
 }
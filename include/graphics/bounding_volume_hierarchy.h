@@ -0,0 +1,135 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef BOUNDING_VOLUME_HIERARCHY_H
+#define BOUNDING_VOLUME_HIERARCHY_H
+
+#include <vector>
+#include <cstdint>
+
+#include <entity/entity.h>
+#include <physic/aabb.h>
+#include <graphics/frustum.h>
+
+namespace dm
+{
+/**
+ * \brief Dynamic AABB tree over bounding spheres. Leaves keep a box enlarged by a margin so small moves only refit
+ * the leaf sphere, larger moves reinsert the leaf. Inserting and removing rebalance the tree with rotations.
+ * Frustum queries accept or reject whole subtrees, only the subtrees crossing a plane are visited down to the leaves
+ */
+class BoundingVolumeHierarchy
+{
+public:
+	using ProxyId = uint32_t;
+	static constexpr ProxyId INVALID_PROXY = 0xFFFFFFFF;
+	static constexpr size_t MAX_QUERY_NMB = 8;
+
+	/**
+	 * \brief Frustum tested by a query, only the planes of planeMask are tested (e.g. a shadow view ignores its near plane)
+	 */
+	struct FrustumQuery
+	{
+		const Frustum* frustum;
+		uint32_t planeMask;
+		std::vector<Entity>* visibleEntities;
+	};
+
+	/**
+	 * \brief Add a leaf for the sphere, the returned id stays valid until the leaf is removed
+	 */
+	ProxyId Insert(Entity entity, const glm::vec3& center, float radius);
+
+	void Remove(ProxyId proxy);
+
+	/**
+	 * \brief Update the sphere of a leaf, return true if the leaf left its enlarged box and was reinserted
+	 */
+	bool Move(ProxyId proxy, const glm::vec3& center, float radius);
+
+	/**
+	 * \brief Append the entities of every leaf whose sphere intersects the frustum
+	 */
+	void Query(const Frustum& frustum, std::vector<Entity>& visibleEntities) const;
+
+	/**
+	 * \brief Run up to MAX_QUERY_NMB frustum queries in a single traversal, a node is visited once for all the views
+	 * that did not reject it yet. Each query appends its visible entities to its own list
+	 */
+	void Query(const FrustumQuery* queries, size_t queryNmb) const;
+
+	Entity GetEntity(const ProxyId proxy) const { return m_Nodes[proxy].entity; }
+
+	size_t Size() const { return m_LeafCount; }
+
+	int GetHeight() const { return m_Root == INVALID_PROXY ? 0 : m_Nodes[m_Root].height; }
+
+	void Clear();
+
+private:
+	static constexpr float FAT_MARGIN = 0.2f;
+
+	struct Node
+	{
+		Aabb box;
+		glm::vec3 center = glm::vec3(0.0f);
+		float radius = 0.0f;
+		Entity entity = INVALID_ENTITY;
+		ProxyId parent = INVALID_PROXY;
+		ProxyId child1 = INVALID_PROXY;
+		ProxyId child2 = INVALID_PROXY;
+		//Leaves are at height 0, free nodes at -1
+		int height = -1;
+
+		bool IsLeaf() const { return child1 == INVALID_PROXY; }
+	};
+
+	ProxyId AllocateNode();
+
+	void FreeNode(ProxyId node);
+
+	void InsertLeaf(ProxyId leaf);
+
+	void RemoveLeaf(ProxyId leaf);
+
+	/**
+	 * \brief Rotate the subtree if its children heights differ by more than one, return the new subtree root
+	 */
+	ProxyId Balance(ProxyId node);
+
+	/**
+	 * \brief Recompute the boxes and heights from the node up to the root, balancing on the way
+	 */
+	void Refit(ProxyId node);
+
+	void ReplaceChild(ProxyId parent, ProxyId oldChild, ProxyId newChild);
+
+	std::vector<Node> m_Nodes;
+	ProxyId m_Root = INVALID_PROXY;
+	ProxyId m_FreeNode = INVALID_PROXY;
+	size_t m_LeafCount = 0;
+};
+}
+
+#endif BOUNDING_VOLUME_HIERARCHY_H
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include <graphics/buffers/buffer.h>
 
+#include <memory>
+
 namespace dm
 {
 class CommandBuffer;
@@ -37,7 +39,10 @@ class CommandBuffer;
 class InstanceBuffer: public Buffer
 {
 public:
-	explicit InstanceBuffer(const VkDeviceSize &size);
+	/**
+	 * \brief The buffer holds one region of frameSize bytes per frame in flight
+	 */
+	explicit InstanceBuffer(const VkDeviceSize &frameSize, const uint32_t &frameCount = 1);
 
 	/**
 	 * \brief Update data in the buffer
@@ -45,6 +50,20 @@ public:
 	 * \param newData 
 	 */
 	void Update(const CommandBuffer &commandBuffer, const void *newData);
+
+	const VkDeviceSize &GetFrameSize() const { return m_FrameSize; }
+
+	const uint32_t &GetFrameCount() const { return m_FrameCount; }
+
+	/**
+	 * \brief Copy size bytes in the region of the current frame, the previous frames may still read theirs.
+	 * The buffer is recreated half larger than needed when it is too small
+	 * \return The offset of the region to bind the buffer at
+	 */
+	static VkDeviceSize Upload(std::unique_ptr<InstanceBuffer> &buffer, const void *data, const VkDeviceSize &size);
+private:
+	VkDeviceSize m_FrameSize;
+	uint32_t m_FrameCount;
 };
 }
 #endif
\ No newline at end of file
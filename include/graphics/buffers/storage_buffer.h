@@ -36,7 +36,10 @@ namespace dm
 class StorageBuffer : public Descriptor, public Buffer
 {
 public:
-	explicit StorageBuffer(const VkDeviceSize &size, const void *data = nullptr);
+	/**
+	 * \brief usage is added to the storage usage, e.g. VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT for draw commands written by a compute shader
+	 */
+	explicit StorageBuffer(const VkDeviceSize &size, const void *data = nullptr, const VkBufferUsageFlags &usage = 0);
 
 	/**
 	 * \brief Change data inside the buffer
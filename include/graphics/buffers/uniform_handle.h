@@ -26,6 +26,7 @@ SOFTWARE.
 #define UNIFORM_HANDLE_H
 
 #include <graphics/buffers/uniform_buffer.h>
+#include <graphics/buffers/uniform_ring_buffer.h>
 #include <graphics/pipelines/shader.h>
 
 namespace dm
@@ -77,6 +78,18 @@ public:
 
 	bool Update(const std::optional<Shader::UniformBlock> &uniformBlock);
 
+	/**
+	 * \brief Follow the layout of a dynamic uniform block without creating a buffer, the data is copied in a ring by Allocate
+	 * \return false if the layout changed, the data pushed before was discarded
+	 */
+	bool UpdateLayout(const std::optional<Shader::UniformBlock> &uniformBlock);
+
+	/**
+	 * \brief Copy the data in the current frame of the ring
+	 * \return the dynamic offset of the copy
+	 */
+	uint32_t Allocate(UniformRingBuffer &uniformRing) const;
+
 	const UniformBuffer *GetUniformBuffer() const { return m_UniformBuffer.get(); }
 private:
 	bool m_MultiPipeline;
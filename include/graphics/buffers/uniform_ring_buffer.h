@@ -0,0 +1,77 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef UNIFORM_RING_BUFFER_H
+#define UNIFORM_RING_BUFFER_H
+
+#include <graphics/descriptor.h>
+#include <graphics/buffers/buffer.h>
+
+namespace dm
+{
+/**
+ * \brief Persistently mapped uniform buffer split in one region per frame in flight. Transient uniforms are copied at the
+ * cursor of the current frame and bound as VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC with the returned offset,
+ * the region is reused once the fence of its frame is signaled
+ */
+class UniformRingBuffer : public Descriptor, public Buffer
+{
+public:
+	UniformRingBuffer(const VkDeviceSize &frameSize, const uint32_t &frameCount);
+
+	~UniformRingBuffer();
+
+	/**
+	 * \brief Move the cursor at the start of the region of the frame, must be called after waiting its fence
+	 */
+	void BeginFrame(const uint32_t &frame);
+
+	/**
+	 * \brief Copy size bytes at the cursor and return their dynamic offset, the cursor is aligned on minUniformBufferOffsetAlignment
+	 */
+	uint32_t Allocate(const void *data, const VkDeviceSize &size);
+
+	const VkDeviceSize &GetFrameSize() const { return m_FrameSize; }
+
+	/**
+	 * \brief Bytes allocated in the current frame
+	 */
+	VkDeviceSize GetUsedSize() const { return m_Cursor - m_FrameOffset; }
+
+	static VkDeviceSize AlignUp(const VkDeviceSize &size, const VkDeviceSize &alignment);
+
+	/**
+	 * \brief The offset of the descriptor stays 0, offsetSize gives the range read by the shader from the dynamic offset
+	 */
+	WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const std::optional<OffsetSize> &offsetSize) const override;
+private:
+	VkDeviceSize m_Alignment;
+	VkDeviceSize m_FrameSize;
+	VkDeviceSize m_FrameOffset;
+	VkDeviceSize m_Cursor;
+	char *m_Mapped;
+};
+}
+
+#endif UNIFORM_RING_BUFFER_H
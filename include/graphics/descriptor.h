@@ -37,15 +37,8 @@ class OffsetSize
 public:
 	OffsetSize(const uint32_t &offset, const uint32_t &size) :
 		m_Offset(offset),
-		m_Size(offset)
-	{
-		std::cout << offset << ", " << size << "\n";
-
-		if(offset > size)
-		{
-			m_Size = offset;
-		}
-	}
+		m_Size(size)
+	{}
 
 	const uint32_t &GetOffset() const { return m_Offset; }
 
@@ -30,6 +30,7 @@ SOFTWARE.
 
 #include <iostream>
 #include <graphics/buffers/uniform_handle.h>
+#include <graphics/buffers/uniform_ring_buffer.h>
 #include <graphics/buffers/storage_handle.h>
 #include <graphics/buffers/push_handle.h>
 
@@ -144,6 +145,11 @@ public:
 
 	void Push(const std::string &descriptorName, UniformHandle &uniformHandle, const std::optional<OffsetSize> &offsetSize = {});
 
+	/**
+	 * \brief Bind the ring to a dynamic uniform block, the shader reads the size of the block from the offset given to BindDescriptor
+	 */
+	void Push(const std::string &descriptorName, UniformRingBuffer &uniformRing);
+
 	void Push(const std::string &descriptorName, StorageHandle &storageHandle, const std::optional<OffsetSize> &offsetSize = {});
 
 	void Push(const std::string &descriptorName, PushHandle &pushHandle, const std::optional<OffsetSize> &offsetSize = {});
@@ -152,6 +158,11 @@ public:
 
 	void BindDescriptor(const CommandBuffer &commandBuffer, const Pipeline &pipeline);
 
+	/**
+	 * \brief Bind with the offset returned by UniformRingBuffer::Allocate for the dynamic uniform block
+	 */
+	void BindDescriptor(const CommandBuffer &commandBuffer, const Pipeline &pipeline, const uint32_t &dynamicOffset);
+
 	const DescriptorSet *GetDescriptorSet() const { return m_DescriptorSet.get(); }
 private:
 	struct DescriptorValue
@@ -44,6 +44,11 @@ public:
 
 	void BindDescriptor(const CommandBuffer &commandBuffer);
 
+	/**
+	 * \brief Bind the set with the offset of its dynamic uniform buffer
+	 */
+	void BindDescriptor(const CommandBuffer &commandBuffer, const uint32_t &dynamicOffset);
+
 	const VkDescriptorSet &GetDescriptorSet() const { return m_DescriptorSet; }
 private:
 	VkPipelineLayout m_PipelineLayout;
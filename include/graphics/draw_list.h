@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include <graphics/command_buffer.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace dm
+{
+class Mesh;
+class Pipeline;
+class PipelineMaterial;
+class DescriptorHandle;
+
+/**
+ * \brief Binds recorded by a renderer during the last frame, the saved state changes are the binds skipped because the state was already bound
+ */
+struct DrawStats
+{
+	uint32_t drawCount = 0;
+	uint32_t instanceCount = 0;
+	uint32_t pipelineBinds = 0;
+	uint32_t descriptorBinds = 0;
+	uint32_t meshBinds = 0;
+	uint32_t savedStateChanges = 0;
+
+	DrawStats& operator+=(const DrawStats& other);
+};
+
+/**
+ * \brief Draws of a renderer sorted by a 64 bits key. From the most to the least significant bits the key holds the subpass,
+ * the pipeline, the material, the mesh and the quantized depth, consecutive draws then share as much state as possible.
+ * Replaying the list through BindPipeline, BindDescriptor and DrawMesh skips the binds of the state already bound
+ */
+class DrawList
+{
+public:
+	enum class State : uint8_t
+	{
+		PIPELINE = 0,
+		MATERIAL,
+		MESH,
+		LENGTH
+	};
+
+	struct Draw
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	static constexpr uint32_t SUBPASS_BITS = 4;
+	static constexpr uint32_t PIPELINE_BITS = 12;
+	static constexpr uint32_t MATERIAL_BITS = 16;
+	static constexpr uint32_t MESH_BITS = 16;
+	static constexpr uint32_t DEPTH_BITS = 16;
+
+	/**
+	 * \brief Fields wider than their bits are masked, it only breaks the grouping as the replay compares the real states.
+	 * The depth is normalized between 0 and 1, 0 being drawn first
+	 */
+	static uint64_t MakeKey(uint32_t subpass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+	/**
+	 * \brief Dense id of a state for the current frame, ids follow the order of first appearance since Clear
+	 */
+	uint32_t GetStateId(State state, const void* object);
+
+	void Clear();
+
+	/**
+	 * \brief Add a draw, index is the slot of the draw in the arrays of the renderer
+	 */
+	void Add(uint64_t key, uint32_t index);
+
+	/**
+	 * \brief Stable least significant digit radix sort on the keys, 8 bits per pass. Passes where every key shares the digit are skipped
+	 */
+	void Sort();
+
+	const std::vector<Draw>& GetDraws() const { return m_Draws; }
+
+	/**
+	 * \brief Forget the bound states, must be called before replaying the list in a new command buffer
+	 */
+	void BeginReplay();
+
+	bool BindPipeline(const CommandBuffer& commandBuffer, PipelineMaterial& pipelineMaterial);
+
+	void BindDescriptor(const CommandBuffer& commandBuffer, DescriptorHandle& descriptorSet, const Pipeline& pipeline);
+
+	/**
+	 * \brief Bind a set holding a dynamic uniform buffer, the bind is only skipped if the set and the offset are already bound
+	 */
+	void BindDescriptor(const CommandBuffer& commandBuffer, DescriptorHandle& descriptorSet, const Pipeline& pipeline, uint32_t dynamicOffset);
+
+	/**
+	 * \brief Bind the vertex and index buffers if the mesh changed, then draw instanceCount instances starting at firstInstance
+	 */
+	bool DrawMesh(const CommandBuffer& commandBuffer, const Mesh& mesh, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
+
+	const DrawStats& GetStats() const { return m_Stats; }
+private:
+	std::vector<Draw> m_Draws;
+	std::vector<Draw> m_SortBuffer;
+
+	std::array<std::unordered_map<const void*, uint32_t>, static_cast<size_t>(State::LENGTH)> m_StateIds;
+
+	const PipelineMaterial* m_BoundPipeline = nullptr;
+	const DescriptorHandle* m_BoundDescriptor = nullptr;
+	std::optional<uint32_t> m_BoundDynamicOffset;
+	const Mesh* m_BoundMesh = nullptr;
+
+	DrawStats m_Stats;
+};
+}
+
+#endif DRAW_LIST_H
@@ -0,0 +1,66 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <vector>
+#include <cstdint>
+
+#include <physic/bounding_sphere.h>
+
+namespace dm
+{
+/**
+ * \brief Six planes of a view volume, normals point inside and are normalized so a plane gives the signed distance of a point
+ */
+struct Frustum
+{
+	static constexpr size_t PLANE_NMB = 6;
+	static constexpr size_t NEAR_PLANE = 4;
+	static constexpr uint32_t ALL_PLANES = (1u << PLANE_NMB) - 1;
+
+	glm::vec4 planes[PLANE_NMB]{};
+
+	/**
+	 * \brief Extract the left, right, bottom, top, near and far planes (in this order) from projection * view
+	 */
+	static Frustum FromMatrix(const glm::mat4x4& viewProjection);
+
+	/**
+	 * \brief Only the planes of planeMask are tested
+	 */
+	bool IsVisible(const glm::vec3& center, float radius, uint32_t planeMask = ALL_PLANES) const;
+
+	/**
+	 * \brief Test every sphere against the planes of planeMask, Simd::WIDTH spheres at a time.
+	 * The indices of the spheres intersecting the frustum are written in increasing order in visibleIndices
+	 */
+	void CullSpheres(const BoundingSphereSoA& spheres, std::vector<uint32_t>& visibleIndices, uint32_t planeMask = ALL_PLANES) const;
+};
+}
+
+#endif FRUSTUM_H
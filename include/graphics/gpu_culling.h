@@ -0,0 +1,131 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef GPU_CULLING_H
+#define GPU_CULLING_H
+
+#include <graphics/pipelines/pipeline_compute.h>
+#include <graphics/buffers/storage_buffer.h>
+#include <graphics/buffers/uniform_handle.h>
+#include <graphics/descriptor_handle.h>
+#include <graphics/frustum.h>
+#include <graphics/object_buffer.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace dm
+{
+class Mesh;
+
+/**
+ * \brief GPU driven submission. The objects of a frame are grouped in batches sharing a mesh, a compute pass (culling.comp)
+ * tests their bounding sphere against the frustum and appends the visible ones to the instances of their batch.
+ * Each batch is then drawn with vkCmdDrawIndexedIndirect, the instance count never comes back to the CPU
+ */
+class GpuCulling
+{
+public:
+	/**
+	 * \brief Object read by culling.comp, same layout as the ObjectBuffer of the CPU path
+	 */
+	using ObjectData = dm::ObjectData;
+
+	static constexpr uint32_t INVALID_BATCH = std::numeric_limits<uint32_t>::max();
+
+	GpuCulling();
+
+	/**
+	 * \brief Batches start at their first instance, the device needs drawIndirectFirstInstance
+	 */
+	static bool IsSupported();
+
+	/**
+	 * \brief Remove the batches of the previous frame
+	 */
+	void Clear();
+
+	/**
+	 * \brief Add the objects drawn with the given mesh and return the index of their batch, INVALID_BATCH if the mesh has no index buffer
+	 */
+	uint32_t AddBatch(const Mesh& mesh, const std::vector<ObjectData>& objects);
+
+	/**
+	 * \brief Upload the objects in the buffers of the current frame, then record the write of the draw commands resetting their
+	 * instance counts, the culling dispatch and the barrier protecting the indirect reads. Must be recorded outside of a render pass
+	 */
+	void Dispatch(const CommandBuffer& commandBuffer, const Frustum& frustum);
+
+	/**
+	 * \brief Draw the visible instances of a batch, the mesh and the pipeline must be bound
+	 */
+	void DrawBatch(const CommandBuffer& commandBuffer, uint32_t batch) const;
+
+	/**
+	 * \brief Frame in flight of the last dispatch, the sets reading its buffers must be kept per frame as well
+	 */
+	uint32_t GetFrame() const { return m_Frame; }
+
+	const StorageBuffer* GetObjectBuffer() const { return m_Frames.empty() ? nullptr : m_Frames[m_Frame].objectBuffer.get(); }
+
+	const StorageBuffer* GetInstanceBuffer() const { return m_Frames.empty() ? nullptr : m_Frames[m_Frame].instanceBuffer.get(); }
+
+	/**
+	 * \brief Wait the frames in flight and read back the number of instances kept by the last dispatch, meant for tests and debugging
+	 */
+	uint32_t ReadVisibleCount() const;
+private:
+	/**
+	 * \brief Buffers and set used by the culling of a frame in flight, they are only written or regrown once its fence is signaled
+	 */
+	struct Frame
+	{
+		DescriptorHandle descriptorSet;
+		UniformHandle uniformCulling;
+		std::unique_ptr<StorageBuffer> objectBuffer;
+		std::unique_ptr<StorageBuffer> commandBuffer;
+		std::unique_ptr<StorageBuffer> instanceBuffer;
+	};
+
+	/**
+	 * \brief Recreate the buffer half larger than needed when it is too small
+	 */
+	static void Reserve(std::unique_ptr<StorageBuffer>& buffer, VkDeviceSize size, VkBufferUsageFlags usage);
+
+	/**
+	 * \brief Largest size written by one vkCmdUpdateBuffer
+	 */
+	static constexpr VkDeviceSize MAX_UPDATE_SIZE = 65536;
+
+	PipelineCompute m_Pipeline;
+
+	std::vector<ObjectData> m_Objects;
+	std::vector<VkDrawIndexedIndirectCommand> m_Commands;
+
+	std::vector<Frame> m_Frames;
+	uint32_t m_Frame;
+};
+}
+
+#endif GPU_CULLING_H
@@ -37,6 +37,8 @@ SOFTWARE.
 #include <graphics/render_stage.h>
 #include <graphics/render_manager.h>
 #include "texture_manager.h"
+#include <graphics/visibility_view.h>
+#include <graphics/buffers/uniform_ring_buffer.h>
 
 namespace dm
 {
@@ -147,6 +149,43 @@ public:
 
 	TextureManager* GetTextureManager() { return m_TextureManager.get(); };
 
+	/**
+	 * \brief Per draw uniforms of the frame being recorded, the region of the frame is reset when its fence is signaled
+	 */
+	UniformRingBuffer* GetUniformRing() const { return m_UniformRing.get(); }
+
+	/**
+	 * \brief Size of the region of each frame in flight of the uniform ring
+	 */
+	static constexpr VkDeviceSize UNIFORM_RING_FRAME_SIZE = 4 * 1024 * 1024;
+
+	/**
+	 * \brief Frame in flight being recorded, per frame data is written in its region once its fence is signaled
+	 */
+	uint32_t GetCurrentFrame() const { return static_cast<uint32_t>(m_CurrentFrame); }
+
+	uint32_t GetFrameCount() const { return static_cast<uint32_t>(m_InFlightFences.size()); }
+
+	/**
+	 * \brief Wait the fences of all the frames in flight, a buffer they read can then be replaced while recording
+	 */
+	void WaitFramesInFlight() const;
+
+	/**
+	 * \brief Drawable entities that passed the culling of the culling camera, filled by FrustumCulling before the renderers draw
+	 */
+	EntitySet& GetVisibleEntities() { return m_Views.front().visibleEntities; }
+
+	/**
+	 * \brief Views culled during the frame, the first one is always the culling camera
+	 */
+	std::vector<VisibilityView>& GetViews() { return m_Views; }
+
+	/**
+	 * \brief Return the view built from the entity this frame or nullptr
+	 */
+	const VisibilityView* FindView(ViewType type, Entity entity) const;
+
 private:
 	void CreatePipelineCache();
 	/**
@@ -195,6 +234,10 @@ private:
 	std::unique_ptr<RenderManager> m_RenderManager;
 
 	std::unique_ptr<TextureManager> m_TextureManager;
+
+	std::unique_ptr<UniformRingBuffer> m_UniformRing;
+
+	std::vector<VisibilityView> m_Views = std::vector<VisibilityView>(1);
 };
 }
 
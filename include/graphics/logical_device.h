@@ -53,7 +53,14 @@ public:
 	const uint32_t &GetPresentFamily() const { return m_PresentFamily; }
 	const uint32_t &GetComputeFamily() const { return m_ComputeFamily; }
 	const uint32_t &GetTransferFamily() const { return m_TransferFamily; }
+
+	/**
+	 * \brief Sampled image arrays can be indexed with non uniform values, partially bound and updated after being bound
+	 */
+	const bool &IsDescriptorIndexingEnabled() const { return m_DescriptorIndexing; }
 private:
+	bool IsExtensionSupported(const char* extensionName) const;
+
 	void CreateQueueIndices();
 	void CreateLogicalDevice();
 
@@ -74,6 +81,8 @@ private:
 	VkQueue m_PresentQueue;
 	VkQueue m_ComputeQueue;
 	VkQueue m_TransferQueue;
+
+	bool m_DescriptorIndexing;
 };
 }
 
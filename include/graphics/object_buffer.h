@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef OBJECT_BUFFER_H
+#define OBJECT_BUFFER_H
+
+#include <graphics/buffers/storage_buffer.h>
+#include <graphics/texture_manager.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace dm
+{
+class DescriptorHandle;
+
+/**
+ * \brief Drawable read by the shaders from the ObjectBuffer storage block, std430 layout.
+ * The sphere is the world bounding sphere, the batch is only written by GpuCulling and the textures are slots of the TextureManager table
+ */
+struct ObjectData
+{
+	glm::mat4x4 transform{ 1.0f };
+	glm::vec4 sphere{ 0.0f };
+	glm::vec4 baseDiffuse{ 1.0f };
+	float metallic = 0.0f;
+	float roughness = 0.0f;
+	float ignoreFog = 0.0f;
+	float ignoreLighting = 0.0f;
+	uint32_t batch = 0;
+	uint32_t diffuseTexture = TextureManager::NO_TEXTURE;
+	uint32_t materialTexture = TextureManager::NO_TEXTURE;
+	uint32_t normalTexture = TextureManager::NO_TEXTURE;
+};
+
+/**
+ * \brief Objects drawn during a frame stored in one array. The shaders read their object at gl_InstanceIndex, a draw starts
+ * at the index of its first object with firstInstance so consecutive objects sharing a mesh and a material are one instanced draw.
+ * The storage buffer holds one region per frame in flight so a frame never overwrites the objects read by the previous ones
+ */
+class ObjectBuffer
+{
+public:
+	ObjectBuffer();
+
+	void Clear();
+
+	/**
+	 * \brief Append an object and return its index
+	 */
+	uint32_t Add(const ObjectData& object);
+
+	uint32_t GetCount() const { return m_Count; }
+
+	/**
+	 * \brief Copy the objects in the region of the current frame. The capacity grows by half, the buffer is only recreated
+	 * when the objects don't fit in a region and after waiting the frames in flight still reading it
+	 */
+	void Upload();
+
+	/**
+	 * \brief Index of the first object of the current frame in the storage block, added to the firstInstance of the draws
+	 */
+	uint32_t GetFirstIndex() const { return m_FirstIndex; }
+
+	/**
+	 * \brief Push the storage buffer as the ObjectBuffer block of the set, the set is only rewritten when the buffer is recreated
+	 */
+	void PushDescriptor(DescriptorHandle& descriptorSet);
+private:
+	std::vector<ObjectData> m_Objects;
+	uint32_t m_Count;
+	uint32_t m_FirstIndex;
+	uint32_t m_Capacity;
+	uint32_t m_FrameCount;
+	std::unique_ptr<StorageBuffer> m_Storage;
+};
+}
+
+#endif OBJECT_BUFFER_H
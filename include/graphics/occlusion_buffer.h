@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include <physic/aabb.h>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace dm
+{
+/**
+ * \brief Low resolution depth buffer filled on the CPU with the triangles of a few occluders. A pyramid on top of it keeps
+ * in each texel the farthest depth of the four texels below, a sphere whose nearest point is behind the farthest occluder
+ * depth over its screen rectangle is hidden
+ */
+class OcclusionBuffer
+{
+public:
+	static constexpr uint32_t DEFAULT_WIDTH = 256;
+	static constexpr uint32_t DEFAULT_HEIGHT = 128;
+
+	/**
+	 * \brief The width is rounded up to a multiple of eight so a row is covered by whole SIMD spans
+	 */
+	explicit OcclusionBuffer(uint32_t width = DEFAULT_WIDTH, uint32_t height = DEFAULT_HEIGHT);
+
+	/**
+	 * \brief Reset every texel to an infinite depth and set the view projection used by the following calls
+	 */
+	void Clear(const glm::mat4x4& viewProjection);
+
+	/**
+	 * \brief Rasterize the triangles of an occluder, Simd::WIDTH pixels at a time. Only the texels fully covered by a triangle are
+	 * written, with its farthest depth over the texel, and triangles reaching behind the camera are skipped so an occluder never
+	 * hides more than it covers. Without indices the positions are read three by three
+	 */
+	void Rasterize(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4x4& worldMatrix);
+
+	/**
+	 * \brief Build the max depth pyramid from the rasterized depths, must be called before IsOccluded
+	 */
+	void BuildHierarchy();
+
+	/**
+	 * \brief Conservative test, the screen rectangle and the nearest depth come from the corners of the box around the sphere
+	 */
+	bool IsOccluded(const glm::vec3& center, float radius) const;
+
+	/**
+	 * \brief Conservative test, the screen rectangle and the nearest depth come from the corners of the world space box
+	 */
+	bool IsOccluded(const Aabb& box) const;
+
+	uint32_t GetWidth() const { return m_Levels.front().width; }
+
+	uint32_t GetHeight() const { return m_Levels.front().height; }
+
+	float GetDepth(const uint32_t x, const uint32_t y) const { return m_Levels.front().depths[y * GetWidth() + x]; }
+private:
+	struct Level
+	{
+		uint32_t width;
+		uint32_t height;
+		std::vector<float> depths;
+	};
+
+	void RasterizeTriangle(const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2);
+
+	glm::mat4x4 m_ViewProjection{ 1.0f };
+
+	std::vector<Level> m_Levels;
+	std::vector<glm::vec4> m_ClipPositions;
+};
+}
+
+#endif OCCLUSION_BUFFER_H
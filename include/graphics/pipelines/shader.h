@@ -42,6 +42,16 @@ class Shader
 public:
 	using Define = std::pair<std::string, std::string>;
 
+	/**
+	 * \brief Uniform blocks of this name hold per draw data, they are read from a UniformRingBuffer at a dynamic offset
+	 */
+	static constexpr const char* DYNAMIC_UNIFORM_BLOCK = "UboObject";
+
+	/**
+	 * \brief Descriptor set of the texture table of the TextureManager, its uniforms are not part of the set of the pipeline
+	 */
+	static constexpr uint32_t BINDLESS_SET = 1;
+
 	class VertexInput
 	{
 	public:
@@ -128,9 +138,12 @@ public:
 	class UniformBlock
 	{
 	public:
+		/**
+		 * \brief Dynamic blocks are uniform blocks bound as VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+		 */
 		enum class Type
 		{
-			Uniform, Storage, Push
+			Uniform, Storage, Push, Dynamic
 		};
 
 		explicit UniformBlock(const int32_t &binding = -1, const int32_t &size = -1, const VkShaderStageFlags &stageFlags = 0, const Type &type = Type::Uniform):
@@ -262,6 +275,11 @@ public:
 
 	const std::array<std::optional<uint32_t>, 3> &GetLocalSizes() const { return m_LocalSizes; }
 
+	/**
+	 * \brief The shader samples the texture table bound at BINDLESS_SET
+	 */
+	const bool &IsBindless() const { return m_Bindless; }
+
 	const std::vector<VkDescriptorSetLayoutBinding> &GetDescriptorSetLayouts() const
 	{
 		return m_DescriptorSetLayout;
@@ -300,6 +318,7 @@ private:
 	std::map<std::string, Attribute> m_Attribute;
 
 	std::array<std::optional<uint32_t>, 3> m_LocalSizes;
+	bool m_Bindless;
 
 	std::map<std::string, uint32_t> m_DescriptorLocations;
 	std::map<std::string, uint32_t> m_DescriptorSizes;
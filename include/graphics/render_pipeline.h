@@ -26,8 +26,10 @@ SOFTWARE.
 #define RENDER_PIPELINE_H
 
 #include <graphics/command_buffer.h>
+#include <graphics/draw_list.h>
 #include <graphics/pipelines/pipeline.h>
 #include <entity/entity.h>
+#include <entity/entity_set.h>
 
 namespace dm
 {
@@ -43,6 +45,16 @@ public:
 
 	virtual void Draw(const CommandBuffer &commandBuffer) = 0;
 
+	/**
+	 * \brief Record the work that can't happen inside a render pass (e.g. compute dispatches), called once per frame before the first render pass
+	 */
+	virtual void PreDraw(const CommandBuffer &commandBuffer) {}
+
+	/**
+	 * \brief Binds of the last Draw, nullptr if the renderer doesn't replay a DrawList
+	 */
+	virtual const DrawStats* GetDrawStats() const { return nullptr; }
+
 	const Pipeline::Stage &GetStage() const
 	{
 		return m_Stage;
@@ -52,36 +64,33 @@ public:
 
 	void SetEnabled(const bool &enable) { m_Enabled = enable; }
 
-	virtual void RegisterEntity(const Entity entity)
-	{
-		m_RegisteredEntities.push_back(entity);
-	}
-
-	void UnRegisterEntity(const Entity entity)
-	{
-		for (auto it = m_RegisteredEntities.begin(); it != m_RegisteredEntities.end(); ++it)
-		{
-			const auto e = *it;
-
-			if (e == entity)
-			{
-				m_RegisteredEntities.erase(it);
-				return;
-			}
-		}
-	}
-
 	ComponentMask GetSignature() const
 	{
 		return m_Signature;
 	}
 
+	/**
+	 * \brief Entities matching the signature, the set is shared with every system and renderer of the same signature
+	 */
+	const EntitySet& GetRegisteredEntities();
+
+	/**
+	 * \brief Visible entities of the frame matching the signature, compacted from GraphicManager::GetVisibleEntities
+	 */
+	const std::vector<Entity>& GetVisibleEntities();
+
+	/**
+	 * \brief Entities of the visible set matching the signature, e.g. the visible list of a shadow view
+	 */
+	const std::vector<Entity>& GetVisibleEntities(const EntitySet& visibleEntities);
+
 private:
 	Pipeline::Stage m_Stage;
 	bool m_Enabled;
+	const EntitySet* m_RegisteredEntities = nullptr;
+	std::vector<Entity> m_VisibleEntities;
 
 protected:
-	std::vector<Entity> m_RegisteredEntities;
 	ComponentMask m_Signature;
 };
 }
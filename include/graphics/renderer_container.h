@@ -112,36 +112,6 @@ public:
 		}
 	}
 
-	void AddComponent(const Entity entity, const ComponentMask oldMask, ComponentMask newMask)
-	{
-		for (const auto &[key, renderer] : m_Stages)
-		{
-			for (auto& system : renderer)
-			{
-				const auto systemMask = system->GetSignature();
-				if (newMask.IsNewMatch(oldMask, systemMask))
-				{
-					system->RegisterEntity(entity);
-				}
-			}
-		}
-	}
-
-	void DestroyComponent(const Entity entity, const ComponentMask oldMask, ComponentMask newMask)
-	{
-		for (auto& stages : m_Stages)
-		{
-			for (auto& system : stages.second)
-			{
-				const auto systemMask = system->GetSignature();
-				if (newMask.IsNoLongerMatch(oldMask, systemMask))
-				{
-					system->UnRegisterEntity(entity);
-				}
-			}
-		}
-	}
-
 	void RenderStage(const Pipeline::Stage &stage, const CommandBuffer &commandBuffer);
 private:
 
@@ -27,12 +27,41 @@ SOFTWARE.
 #include <graphics/render_pipeline.h>
 #include "pipelines/pipeline_graphic.h"
 #include "Mesh.h"
+#include <graphics/buffers/instance_buffer.h>
+#include <graphics/buffers/uniform_handle.h>
+#include <graphics/descriptor_handle.h>
+
+#include <map>
+#include <memory>
 
 namespace dm
 {
 class RendererDirectionalShadow : public RenderPipeline
 {
 public:
+	/**
+	 * \brief World matrix of a caster, per instance attribute of the INSTANCING variant of shadow_directional.vert
+	 */
+	struct Instance
+	{
+		static Shader::VertexInput GetVertexInput(const uint32_t &baseBinding = 1)
+		{
+			std::vector<VkVertexInputBindingDescription> bindingDescription = {
+				VkVertexInputBindingDescription{ baseBinding, sizeof(Instance), VK_VERTEX_INPUT_RATE_INSTANCE }
+			};
+
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
+				VkVertexInputAttributeDescription{ 3, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, model) },
+				VkVertexInputAttributeDescription{ 4, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, model) + 16 },
+				VkVertexInputAttributeDescription{ 5, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, model) + 32 },
+				VkVertexInputAttributeDescription{ 6, baseBinding, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Instance, model) + 48 },
+			};
+			return Shader::VertexInput(baseBinding, bindingDescription, attributeDescriptions);
+		}
+
+		glm::mat4x4 model;
+	};
+
 	explicit RendererDirectionalShadow(const Pipeline::Stage& stage);
 
 	static Shader::VertexInput GetVertexInput(const uint32_t &binding = 0)
@@ -65,9 +94,31 @@ public:
 
 	void Draw(const CommandBuffer& commandBuffer) override;
 
-	void RegisterEntity(const Entity entity) override;
+	/**
+	 * \brief Draw the casters sharing a mesh with one instanced draw, the light space matrix is written once per frame
+	 */
+	void SetInstanced(bool instanced) { m_Instanced = instanced; }
+
+	bool IsInstanced() const { return m_Instanced; }
 private:
+	struct InstanceGroup
+	{
+		std::vector<Instance> instances;
+		uint32_t firstInstance = 0;
+	};
+
+	void DrawInstanced(const CommandBuffer& commandBuffer, const glm::mat4x4& lightSpaceMatrix, const std::vector<Entity>& casters);
+
 	PipelineGraphics m_Pipeline;
+	PipelineGraphics m_PipelineInstanced;
+
+	bool m_Instanced = false;
+	UniformHandle m_UniformObject;
+	DescriptorHandle m_DescriptorSet;
+	DescriptorHandle m_DescriptorSetInstanced;
+	std::map<const Mesh*, InstanceGroup> m_InstanceGroups;
+	std::vector<Instance> m_Instances;
+	std::unique_ptr<InstanceBuffer> m_InstanceBuffer;
 };
 }
 
@@ -28,6 +28,15 @@ SOFTWARE.
 #include <system/system.h>
 #include <graphics/buffers/uniform_handle.h>
 #include "descriptor_handle.h"
+#include <graphics/draw_list.h>
+#include <graphics/gpu_culling.h>
+#include <graphics/object_buffer.h>
+#include <component/materials/material_default.h>
+#include <component/model.h>
+
+#include <map>
+#include <memory>
+#include <tuple>
 
 namespace dm
 {
@@ -42,9 +51,79 @@ public:
 
 	void Draw(const CommandBuffer &commandBuffer) override;
 
-	void RegisterEntity(const Entity entity) override;
+	const DrawStats* GetDrawStats() const override { return &m_DrawList.GetStats(); }
+
+	/**
+	 * \brief In GPU driven mode the meshes are culled by a compute pass against the frustum of the main camera and drawn
+	 * with one indirect draw per (mesh, material) batch
+	 */
+	void PreDraw(const CommandBuffer &commandBuffer) override;
+
+	/**
+	 * \brief Switch between the CPU and the GPU driven path, stays on the CPU if the device can't draw indirect instances at an offset
+	 */
+	void SetGpuDriven(bool gpuDriven);
+
+	bool IsGpuDriven() const { return m_GpuCulling != nullptr; }
+
+	const GpuCulling* GetGpuCulling() const { return m_GpuCulling.get(); }
 private:
+	/**
+	 * \brief Objects of the same batch share a mesh, a pipeline and the textures of their material. Bindless pipelines read
+	 * the slots of the textures from the objects, their batches only share a mesh and a pipeline
+	 */
+	struct BatchKey
+	{
+		const Mesh* mesh;
+		const PipelineMaterial* pipelineMaterial;
+		const Image2d* diffuseTexture;
+		const Image2d* materialTexture;
+		const Image2d* normalTexture;
+
+		bool operator<(const BatchKey& other) const
+		{
+			return std::tie(mesh, pipelineMaterial, diffuseTexture, materialTexture, normalTexture) <
+				std::tie(other.mesh, other.pipelineMaterial, other.diffuseTexture, other.materialTexture, other.normalTexture);
+		}
+
+		bool operator==(const BatchKey& other) const
+		{
+			return std::tie(mesh, pipelineMaterial, diffuseTexture, materialTexture, normalTexture) ==
+				std::tie(other.mesh, other.pipelineMaterial, other.diffuseTexture, other.materialTexture, other.normalTexture);
+		}
+	};
+
+	struct IndirectBatch
+	{
+		PipelineMaterial* pipelineMaterial = nullptr;
+		MaterialDefault material;
+		/**
+		 * \brief One set per frame in flight, each one points to the buffers culled for its frame
+		 */
+		std::vector<DescriptorHandle> descriptorSets;
+		std::vector<GpuCulling::ObjectData> objects;
+		uint32_t batch = GpuCulling::INVALID_BATCH;
+	};
+
+	static BatchKey GetBatchKey(const Model& mesh, const MaterialDefault& material, bool bindless);
+
+	using MaterialTextures = std::tuple<const Image2d*, const Image2d*, const Image2d*>;
+
+	/**
+	 * \brief Dense id of the textures of the material for the sort key of the current frame, the same textures as the BatchKey
+	 */
+	uint32_t GetMaterialId(const MaterialDefault& material, bool bindless);
+
+	void DrawIndirect(const CommandBuffer &commandBuffer);
+
 	UniformHandle m_UniformScene;
+	DrawList m_DrawList;
+	std::map<MaterialTextures, uint32_t> m_MaterialIds;
+	ObjectBuffer m_ObjectBuffer;
+	std::map<const PipelineMaterial*, DescriptorHandle> m_DescriptorSets;
+
+	std::unique_ptr<GpuCulling> m_GpuCulling;
+	std::map<BatchKey, IndirectBatch> m_IndirectBatches;
 };
 }
 
@@ -28,6 +28,7 @@ SOFTWARE.
 #include <system/system.h>
 #include <graphics/buffers/uniform_handle.h>
 #include "descriptor_handle.h"
+#include <graphics/draw_list.h>
 
 namespace dm
 {
@@ -42,9 +43,10 @@ public:
 
 	void Draw(const CommandBuffer &commandBuffer) override;
 
-	void RegisterEntity(const Entity entity) override;
+	const DrawStats* GetDrawStats() const override { return &m_DrawList.GetStats(); }
 private:
 	UniformHandle m_UniformScene;
+	DrawList m_DrawList;
 };
 }
 
@@ -41,8 +41,6 @@ public:
 	void Update() override;
 
 	void Draw(const CommandBuffer &commandBuffer) override;
-
-	void RegisterEntity(const Entity entity) override;
 private:
 	UniformHandle m_UniformScene;
 };
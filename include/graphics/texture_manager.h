@@ -26,18 +26,34 @@ SOFTWARE.
 #define TEXTURE_MANAGER_H
 
 #include <graphics/image_2d.h>
+#include <graphics/command_buffer.h>
+#include <graphics/pipelines/pipeline.h>
+#include <limits>
 #include <map>
+#include <vector>
 
 namespace dm
 {
 class TextureManager
 {
 public:
+	/**
+	 * \brief Largest size of the texture table, clamped to the limits of the device. The descriptor set index of the table
+	 * in the pipelines sampling it is Shader::BINDLESS_SET
+	 */
+	static constexpr uint32_t MAX_TEXTURES = 4096;
+
+	/**
+	 * \brief Samplers left to the other sets of a stage by the per stage limits of the device
+	 */
+	static constexpr uint32_t RESERVED_SAMPLERS = 16;
+	static constexpr uint32_t NO_TEXTURE = std::numeric_limits<uint32_t>::max();
+
 	static TextureManager* Get();
 
-	TextureManager()
-	{
-	}
+	TextureManager();
+
+	~TextureManager();
 
 	std::shared_ptr<Image2d> GetTextureByName(const std::string& name)
 	{
@@ -48,17 +64,58 @@ public:
 			return it->second;
 		}
 
-		m_Textures.emplace(name, Image2d::Create(name));
-		auto it3 = m_Textures.find(name);
+		auto texture = Image2d::Create(name);
+		m_Textures.emplace(name, texture);
 
-		if (it3 != m_Textures.end())
+		if (IsBindless())
 		{
-			return it3->second;
+			GetTextureIndex(texture);
 		}
+
+		return texture;
 	}
+
+	/**
+	 * \brief The textures are sampled by index from one descriptor table when the device supports descriptor indexing
+	 */
+	bool IsBindless() const { return m_DescriptorSet != VK_NULL_HANDLE; }
+
+	/**
+	 * \brief Slot of the texture in the table, given the first time it is asked and kept while the manager lives.
+	 * Returns NO_TEXTURE for a null texture, when the table is full or without descriptor indexing
+	 */
+	uint32_t GetTextureIndex(const std::shared_ptr<Image2d>& texture);
+
+	const VkDescriptorSetLayout& GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+
+	/**
+	 * \brief Number of slots of the table, 0 without descriptor indexing
+	 */
+	uint32_t GetTableSize() const { return m_TableSize; }
+
+	/**
+	 * \brief Bind the table to the set BINDLESS_SET of the pipeline, the set stays bound across the binds of set 0
+	 */
+	void BindDescriptor(const CommandBuffer& commandBuffer, const Pipeline& pipeline) const;
 private:
+	void CreateDescriptorTable();
+
+	/**
+	 * \brief MAX_TEXTURES clamped to the update after bind limits of the device on sampled images and samplers
+	 */
+	static uint32_t GetDeviceTableSize();
+
 	std::map<std::string, std::shared_ptr<Image2d>> m_Textures;
+
+	std::vector<std::shared_ptr<Image2d>> m_Slots;
+	std::map<const Image2d*, uint32_t> m_TextureIndices;
+
+	uint32_t m_TableSize;
+
+	VkDescriptorSetLayout m_DescriptorSetLayout;
+	VkDescriptorPool m_DescriptorPool;
+	VkDescriptorSet m_DescriptorSet;
 };
 }
 
-#endif
\ No newline at end of file
+#endif TEXTURE_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,54 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef VISIBILITY_VIEW_H
+#define VISIBILITY_VIEW_H
+
+#include <glm/mat4x4.hpp>
+
+#include <entity/entity.h>
+#include <entity/entity_set.h>
+
+namespace dm
+{
+enum class ViewType : uint8_t
+{
+	CAMERA = 0,
+	DIRECTIONAL_LIGHT
+};
+
+/**
+ * \brief Point of view culled by FrustumCulling, a camera frustum or the orthographic box of a directional light.
+ * The entity is the camera or the light the view was built from
+ */
+struct VisibilityView
+{
+	ViewType type = ViewType::CAMERA;
+	Entity entity = INVALID_ENTITY;
+	glm::mat4x4 viewProjection{ 1.0f };
+	EntitySet visibleEntities;
+};
+}
+
+#endif VISIBILITY_VIEW_H
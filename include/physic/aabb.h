@@ -0,0 +1,72 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef AABB_H
+#define AABB_H
+
+#include <glm/vec3.hpp>
+#include <glm/common.hpp>
+
+namespace dm
+{
+/**
+ * \brief Axis aligned bounding box stored as its min and max corners
+ */
+struct Aabb
+{
+	glm::vec3 min = glm::vec3(0.0f);
+	glm::vec3 max = glm::vec3(0.0f);
+
+	static Aabb FromSphere(const glm::vec3& center, const float radius)
+	{
+		return Aabb{ center - glm::vec3(radius), center + glm::vec3(radius) };
+	}
+
+	static Aabb Union(const Aabb& a, const Aabb& b)
+	{
+		return Aabb{ glm::min(a.min, b.min), glm::max(a.max, b.max) };
+	}
+
+	glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+
+	glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+	/**
+	 * \brief Half of the surface area, used as insertion cost by the bounding volume hierarchy
+	 */
+	float GetHalfArea() const
+	{
+		const auto size = max - min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	bool Contains(const Aabb& other) const
+	{
+		return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+			max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+	}
+};
+}
+
+#endif AABB_H
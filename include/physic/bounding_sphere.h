@@ -26,14 +26,48 @@ SOFTWARE.
 #define BOUNDING_SPHERE_H
 
 #include <component/component.h>
+#include <physic/aabb.h>
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
 
 namespace dm
 {
 class Mesh;
 
+/**
+ * \brief Mesh space bounds of a drawable and their world space copies. The world bounds are cached by BoundingSphereManager::Update
+ * and only recomputed when the transform of the entity is updated
+ */
 struct BoundingSphere : public ComponentBase
 {
+	glm::vec3 center = glm::vec3(0.0f);
 	float radius = 1;
+	Aabb aabb = Aabb::FromSphere(glm::vec3(0.0f), 1.0f);
+
+	glm::vec3 worldCenter = glm::vec3(0.0f);
+	float worldRadius = 1;
+	Aabb worldAabb = Aabb::FromSphere(glm::vec3(0.0f), 1.0f);
+};
+
+/**
+ * \brief World space centers and radii of a set of spheres split per axis, consecutive spheres fill the lanes of a SIMD register
+ */
+struct BoundingSphereSoA
+{
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+
+	void Add(const glm::vec3& center, float sphereRadius);
+
+	void Reserve(size_t size);
+
+	void Clear();
+
+	size_t Size() const { return centerX.size(); }
 };
 
 class GizmoManager;
@@ -42,6 +76,21 @@ class BoundingSphereManager : public ComponentBaseManager<BoundingSphere>
 public:
 	static BoundingSphere GetBoundingSphere(Mesh& mesh);
 
+	/**
+	 * \brief Sphere in world space, the radius follows the largest scale axis of the world matrix
+	 */
+	static void GetWorldSphere(const glm::mat4x4& worldMatrix, const BoundingSphere& boundingSphere, glm::vec3& center, float& radius);
+
+	/**
+	 * \brief Box in world space enclosing the rotated mesh space box, each world extent sums the absolute projections of the local extents
+	 */
+	static Aabb GetWorldAabb(const glm::mat4x4& worldMatrix, const Aabb& aabb);
+
+	/**
+	 * \brief Recompute the cached world bounds of the component from the world matrix
+	 */
+	static void UpdateWorldBounds(const glm::mat4x4& worldMatrix, BoundingSphere& boundingSphere);
+
 	explicit BoundingSphereManager();
 	~BoundingSphereManager() override;
 
@@ -53,12 +102,20 @@ public:
 
 	void DestroyComponent(Entity entity) override;
 
+	void Clear() override;
+
 	void OnDrawInspector(Entity entity) override;
 
 	void DecodeComponent(json& componentJson, const Entity entity) override;
 
 	void EncodeComponent(json& componentJson, const Entity entity) override;
 private:
+	void UpdateEntityBounds(Entity entity);
+
+	/**
+	 * \brief Components added since the last Update, their world bounds are computed even if their transform didn't change
+	 */
+	std::vector<Entity> m_PendingEntities;
 };
 }
 
@@ -25,11 +25,24 @@ SOFTWARE.
 #ifndef FRUSTUM_CULLING_H
 #define FRUSTUM_CULLING_H
 #include "system.h"
+#include <graphics/frustum.h>
+#include <graphics/bounding_volume_hierarchy.h>
+#include <graphics/occlusion_buffer.h>
+#include <graphics/visibility_view.h>
 
 namespace dm
 {
 struct Camera;
 
+/**
+ * \brief Visibility service. Each frame it builds one view per camera (the culling camera first) and one for the shadow box
+ * of the directional light, then tests the bounding spheres of the drawable entities against all the views in a single
+ * traversal and publish a visible list per view in GraphicManager::GetViews. Drawables without bounding sphere are always visible.
+ * Bounded drawables live in a bounding volume hierarchy refitted from the transforms updated during the frame,
+ * the culling cost follows the visible set instead of the number of drawables.
+ * The view of the culling camera then goes through an occlusion stage, the drawables flagged as occluders are rasterized
+ * in a low resolution depth buffer on the CPU and the drawables hidden behind them are removed
+ */
 class FrustumCulling : public System
 {
 public:
@@ -37,7 +50,36 @@ public:
 
 	void Update() override;
 private:
-	Camera* m_CameraForCulling;
+	/**
+	 * \brief Fill the views of the frame, return false if no camera is flagged for culling
+	 */
+	bool BuildViews(std::vector<VisibilityView>& views) const;
+
+	/**
+	 * \brief Insert and remove the leaves of the drawables whose bounding sphere was attached or detached
+	 */
+	void SyncSpatialIndex();
+
+	void RefitSpatialIndex();
+
+	/**
+	 * \brief Remove from the candidates the entities whose bounding sphere is behind the occluders among them
+	 */
+	void CullOccluded(const glm::mat4x4& viewProjection, std::vector<Entity>& candidates);
+
+	BoundingVolumeHierarchy m_SpatialIndex;
+	std::vector<BoundingVolumeHierarchy::ProxyId> m_Proxies;
+
+	const EntitySet* m_BoundedEntities = nullptr;
+	EntitySet m_UnboundedEntities;
+	uint32_t m_RegisteredVersion = 0;
+	uint32_t m_BoundedVersion = 0;
+
+	const EntitySet* m_OccluderEntities = nullptr;
+	OcclusionBuffer m_OcclusionBuffer;
+
+	Frustum m_Frustums[BoundingVolumeHierarchy::MAX_QUERY_NMB];
+	std::vector<Entity> m_QueriedEntities[BoundingVolumeHierarchy::MAX_QUERY_NMB];
 };
 }
 
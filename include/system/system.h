@@ -26,6 +26,7 @@ SOFTWARE.
 #define SYSTEM_H
 #include <vector>
 #include <entity/entity.h>
+#include <entity/entity_set.h>
 #include <component/component_mask.h>
 
 namespace dm
@@ -44,16 +45,37 @@ public:
 
 	void Destroy();
 
-	virtual void RegisterEntity(const Entity entity);
+	ComponentMask GetSignature() const;
 
-	void UnRegisterEntity(const Entity entity);
+	/**
+	 * \brief Entities matching the signature, the set is shared with every system and renderer of the same signature
+	 */
+	const EntitySet& GetRegisteredEntities();
 
-	ComponentMask GetSignature() const;
+	/**
+	 * \brief Components read by the system, a system without declared access is considered as writing its whole signature
+	 */
+	ComponentMask GetReadAccess() const;
+
+	ComponentMask GetWriteAccess() const;
+
+	/**
+	 * \brief Two systems conflict when one of them writes a component the other one reads or writes
+	 */
+	bool ConflictsWith(const System& other) const;
 
 protected:
-	std::vector<Entity> m_RegisteredEntities;
+	void AddReadAccess(ComponentType componentType);
+
+	void AddWriteAccess(ComponentType componentType);
 
 	ComponentMask m_Signature;
+
+	ComponentMask m_ReadAccess;
+	ComponentMask m_WriteAccess;
+
+private:
+	const EntitySet* m_RegisteredEntities = nullptr;
 };
 }
 
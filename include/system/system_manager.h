@@ -27,10 +27,13 @@ SOFTWARE.
 #include <vector>
 #include <system/system.h>
 #include <memory>
+#include <atomic>
 
 namespace dm
 {
 class Engine;
+class JobSystem;
+class JobCounter;
 
 class SystemManager final : public Module
 {
@@ -48,12 +51,30 @@ public:
 
 	void Destroy();
 
-	void AddComponent(Entity entity, ComponentMask oldMask, ComponentMask newMask);
-
-	void DestroyComponent(Entity entity, ComponentMask oldMask, ComponentMask newMask);
+	/**
+	 * \brief Register a system updated after the existing ones, the systems it conflicts with keep the registration order
+	 */
+	template<typename T, typename... Args>
+	T* AddSystem(Args&&... args)
+	{
+		auto system = std::make_unique<T>(std::forward<Args>(args)...);
+		const auto created = system.get();
+		m_Systems.push_back(std::move(system));
+		return created;
+	}
 private:
+	/**
+	 * \brief Build the dependency graph of the frame, a system depends on every previous system it conflicts with
+	 */
+	void BuildDependencies();
+
+	void ScheduleSystem(size_t systemIndex, JobSystem& jobSystem, JobCounter& counter);
+
 	std::vector<std::unique_ptr<System>> m_Systems;
 
+	std::vector<std::vector<size_t>> m_Dependents;
+	std::vector<std::atomic<uint32_t>> m_RemainingDependencies;
+
 };
 }
 #endif SYSTEM_MANAGER_H
\ No newline at end of file
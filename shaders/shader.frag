@@ -1,17 +1,29 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
+#if BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
 
-layout(binding = 1) uniform UboObject
+struct ObjectData
 {
 	mat4 transform;
-
+	vec4 sphere;
 	vec4 baseDiffuse;
 	float metallic;
 	float roughness;
 	float ignoreFog;
 	float ignoreLighting;
-} object;
+	uint batch;
+	uint diffuseTexture;
+	uint materialTexture;
+	uint normalTexture;
+};
+
+layout(binding = 5) readonly buffer ObjectBuffer
+{
+	ObjectData objects[];
+} objectBuffer;
 
 #if DIFFUSE_MAPPING
 layout(binding = 2) uniform sampler2D samplerDiffuse;
@@ -22,10 +34,17 @@ layout(binding = 3) uniform sampler2D samplerMaterial;
 #if NORMAL_MAPPING
 layout(binding = 4) uniform sampler2D samplerNormal;
 #endif
+#if BINDLESS
+// Texture table of the TextureManager, the object holds the slots of its textures
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+const uint NO_TEXTURE = 0xFFFFFFFFu;
+#endif
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
+layout(location = 3) flat in uint inObjectIndex;
 
 layout(location = 0) out vec4 outPosition;
 layout(location = 1) out vec4 outDiffuse;
@@ -41,8 +60,27 @@ float linearDepth(float depth)
 	return (2.0f * NEAR_PLANE * FAR_PLANE) / (FAR_PLANE + NEAR_PLANE - z * (FAR_PLANE - NEAR_PLANE));	
 }
 
+#if NORMAL_MAPPING || BINDLESS
+vec3 perturbNormal(vec3 tangentNormal)
+{
+	vec3 q1 = dFdx(inPosition);
+	vec3 q2 = dFdy(inPosition);
+	vec2 st1 = dFdx(inUV);
+	vec2 st2 = dFdy(inUV);
+
+	vec3 N = normalize(inNormal);
+	vec3 T = normalize(q1 * st2.t - q2 * st1.t);
+	vec3 B = -normalize(cross(N, T));
+	mat3 TBN = mat3(T, B, N);
+
+	return TBN * tangentNormal;
+}
+#endif
+
 void main()
 {
+	ObjectData object = objectBuffer.objects[inObjectIndex];
+
 	vec4 diffuse = object.baseDiffuse;
 	vec3 normal = normalize(inNormal);
 	vec3 material = vec3(object.metallic, object.roughness, 0.0f);
@@ -50,10 +88,25 @@ void main()
 
 #if DIFFUSE_MAPPING
 	diffuse = texture(samplerDiffuse, inUV);
+#elif BINDLESS
+	if (object.diffuseTexture != NO_TEXTURE)
+	{
+		diffuse = texture(textures[nonuniformEXT(object.diffuseTexture)], inUV);
+	}
 #endif
 
+#if MATERIAL_MAPPING || BINDLESS
 #if MATERIAL_MAPPING
 	vec4 textureMaterial = texture(samplerMaterial, inUV);
+#else
+	// Without texture the material parameters are kept and the object is not glowing
+	vec4 textureMaterial = vec4(1.0f, 1.0f, 0.0f, 1.0f);
+
+	if (object.materialTexture != NO_TEXTURE)
+	{
+		textureMaterial = texture(textures[nonuniformEXT(object.materialTexture)], inUV);
+	}
+#endif
 	material.x *= textureMaterial.r;
 	material.y *= textureMaterial.g;
 
@@ -64,19 +117,12 @@ void main()
 #endif
 
 #if NORMAL_MAPPING
-	vec3 tangentNormal = texture(samplerNormal, inUV).rgb * 2.0f - 1.0f;
-	
-	vec3 q1 = dFdx(inPosition);
-	vec3 q2 = dFdy(inPosition);
-	vec2 st1 = dFdx(inUV);
-	vec2 st2 = dFdy(inUV);
-
-	vec3 N = normalize(inNormal);
-	vec3 T = normalize(q1 * st2.t - q2 * st1.t);
-	vec3 B = -normalize(cross(N, T));
-	mat3 TBN = mat3(T, B, N);
-
-	normal = TBN * tangentNormal;
+	normal = perturbNormal(texture(samplerNormal, inUV).rgb * 2.0f - 1.0f);
+#elif BINDLESS
+	if (object.normalTexture != NO_TEXTURE)
+	{
+		normal = perturbNormal(texture(textures[nonuniformEXT(object.normalTexture)], inUV).rgb * 2.0f - 1.0f);
+	}
 #endif
 
 	material.z = (1.0f / 3.0f) * (object.ignoreFog + (2.0f * min(object.ignoreLighting + glowing, 1.0f)));
@@ -9,15 +9,33 @@ layout(binding = 0) uniform UboScene
 	vec3 cameraPos;
 } scene;
 
-layout(binding = 1) uniform UboObject
+struct ObjectData
 {
 	mat4 transform;
+	vec4 sphere;
 	vec4 baseDiffuse;
 	float metallic;
 	float roughness;
 	float ignoreFog;
 	float ignoreLighting;
-} object;
+	uint batch;
+	uint diffuseTexture;
+	uint materialTexture;
+	uint normalTexture;
+};
+
+layout(binding = 5) readonly buffer ObjectBuffer
+{
+	ObjectData objects[];
+} objectBuffer;
+
+#if GPU_DRIVEN
+// Visible objects written by culling.comp, gl_InstanceIndex starts at the first instance of the batch
+layout(binding = 6) readonly buffer InstanceBuffer
+{
+	uint instances[];
+} instanceBuffer;
+#endif
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
@@ -26,6 +44,7 @@ layout(location = 2) in vec3 inNormal;
 layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec2 outUV;
 layout(location = 2) out vec3 outNormal;
+layout(location = 3) flat out uint outObjectIndex;
 
 out gl_PerVertex
 {
@@ -37,7 +56,16 @@ void main()
 	vec4 position = vec4(inPosition, 1.0f);
 	vec4 normal = vec4(inNormal, 0.0f);
 
-	vec4 worldPosition = object.transform * position;
+#if GPU_DRIVEN
+	uint objectIndex = instanceBuffer.instances[gl_InstanceIndex];
+#else
+	// Draws start at their first object with firstInstance
+	uint objectIndex = gl_InstanceIndex;
+#endif
+	mat4 transform = objectBuffer.objects[objectIndex].transform;
+	outObjectIndex = objectIndex;
+
+	vec4 worldPosition = transform * position;
 
 	gl_Position = scene.projection * scene.view * worldPosition;
 
@@ -45,7 +73,7 @@ void main()
 	outPosition = vec3(scene.view * worldPosition);
 	outUV = inUV;
 	// Normal in view space
-	mat3 normalMatrix = transpose(inverse(mat3(scene.view * object.transform)));
+	mat3 normalMatrix = transpose(inverse(mat3(scene.view * transform)));
 //	mat3 normalMatrix = transpose(inverse(mat3(object.transform)));
 	outNormal = normalMatrix * inNormal;
 }
@@ -2,14 +2,19 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
-layout(binding = 0) uniform UniformScene 
+// Per draw block read from the uniform ring at a dynamic offset
+layout(binding = 0) uniform UboObject
 {
 	mat4 mvp;
-} scene;
+} object;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec2 inNormal;
+#if INSTANCING
+// World matrix of the caster, object.mvp then only holds the light space matrix
+layout(location = 3) in mat4 inModel;
+#endif
 
 layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec2 outUV;
@@ -23,9 +28,15 @@ void main()
 {
 	vec4 position = vec4(inPosition, 1.0f);
 
-	gl_Position = scene.mvp * position;
+#if INSTANCING
+	mat4 mvp = object.mvp * inModel;
+#else
+	mat4 mvp = object.mvp;
+#endif
 
-	outPosition = vec3(scene.mvp * position);
+	gl_Position = mvp * position;
+
+	outPosition = vec3(mvp * position);
 
 	outUV = inUV;
 }
@@ -55,53 +55,37 @@ Camera* CameraManager::CreateComponent(const Entity entity)
 	c.up = glm::normalize(glm::cross(c.right, c.front));
 	//TODO mettre les valeurs depuis l'exterieur
 
-	m_Components[entity - 1] = c;
+	const auto camera = m_Components.Insert(entity, c);
+	RefreshMainCamera();
 
-	return &m_Components[entity - 1];
+	return camera;
 }
 
 Camera* CameraManager::AddComponent(const Entity entity, Camera& componentBase)
 {
-	m_Components[entity - 1] = componentBase;
+	const auto camera = m_Components.Insert(entity, componentBase);
+	RefreshMainCamera();
 
-	if(componentBase.isMain)
-	{
-		m_GraphicManager->SetMainCamera(&m_Components[entity - 1]);
-	}
-
-	return &m_Components[entity - 1];
+	return camera;
 }
 
-void CameraManager::DestroyComponent(Entity entity)
+void CameraManager::DestroyComponent(const Entity entity)
 {
+	m_Components.Remove(entity);
+	RefreshMainCamera();
 }
 
 void CameraManager::OnDrawInspector(const Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Camera");
-	//ImGui::Text("Position ( " + std::to_string(m_Components[entity - 1].position.x) + ", " + std::to_string(m_Components[entity - 1].position.y) + ", " + std::to_string(m_Components[entity - 1].position.z) + " )");
-
-	ImGui::InputFloat("Near", &m_Components[entity - 1].nearFrustum);
-	ImGui::InputFloat("Far", &m_Components[entity - 1].farFrustum);
-	ImGui::DragFloat3("pos", &m_Components[entity - 1].position[0]);
-	ImGui::Checkbox("isMain", &m_Components[entity - 1].isMain);
-	ImGui::Checkbox("isCulling", &m_Components[entity - 1].isCulling);
-}
-
-void CameraManager::OnEntityResize(const int newSize)
-{
-
-	m_Components.resize(newSize);
+	//ImGui::Text("Position ( " + std::to_string(m_Components.Get(entity)->position.x) + ", " + std::to_string(m_Components.Get(entity)->position.y) + ", " + std::to_string(m_Components.Get(entity)->position.z) + " )");
 
-	for (auto& component : m_Components)
-	{
-		if (component.isMain)
-		{
-			m_GraphicManager->SetMainCamera(&component);
-			return;
-		}
-	}
+	ImGui::InputFloat("Near", &m_Components.Get(entity)->nearFrustum);
+	ImGui::InputFloat("Far", &m_Components.Get(entity)->farFrustum);
+	ImGui::DragFloat3("pos", &m_Components.Get(entity)->position[0]);
+	ImGui::Checkbox("isMain", &m_Components.Get(entity)->isMain);
+	ImGui::Checkbox("isCulling", &m_Components.Get(entity)->isCulling);
 }
 
 void CameraManager::UpdateAspect(const float newAspect)
@@ -174,31 +158,40 @@ void CameraManager::DecodeComponent(json& componentJson, const Entity entity)
 	camera.viewMatrix = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
 	camera.projectionMatrix = glm::perspective(glm::radians(camera.fov), camera.aspect, camera.nearFrustum, camera.farFrustum);
 
-	m_Components[entity - 1] = camera;
-
-	if(camera.isMain)
-	{
-		m_GraphicManager->SetMainCamera(&camera);
-	}
+	m_Components.Insert(entity, camera);
+	RefreshMainCamera();
 }
 
 void CameraManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::CAMERA;
 
-	SetVector3ToJson(componentJson, "position", m_Components[entity - 1].position);
-	SetVector3ToJson(componentJson, "up", m_Components[entity - 1].up);
-	SetVector3ToJson(componentJson, "right", m_Components[entity - 1].right);
-	SetVector3ToJson(componentJson, "front", m_Components[entity - 1].front);
+	SetVector3ToJson(componentJson, "position", m_Components.Get(entity)->position);
+	SetVector3ToJson(componentJson, "up", m_Components.Get(entity)->up);
+	SetVector3ToJson(componentJson, "right", m_Components.Get(entity)->right);
+	SetVector3ToJson(componentJson, "front", m_Components.Get(entity)->front);
 
-	componentJson["aspect"] = m_Components[entity - 1].aspect;
-	componentJson["fov"] = m_Components[entity - 1].fov;
-	componentJson["near"] = m_Components[entity - 1].nearFrustum;
-	componentJson["far"] = m_Components[entity - 1].farFrustum;
-	componentJson["yaw"] = m_Components[entity - 1].yaw;
-	componentJson["pitch"] = m_Components[entity - 1].pitch;
+	componentJson["aspect"] = m_Components.Get(entity)->aspect;
+	componentJson["fov"] = m_Components.Get(entity)->fov;
+	componentJson["near"] = m_Components.Get(entity)->nearFrustum;
+	componentJson["far"] = m_Components.Get(entity)->farFrustum;
+	componentJson["yaw"] = m_Components.Get(entity)->yaw;
+	componentJson["pitch"] = m_Components.Get(entity)->pitch;
 
-	SetBoolToJson(componentJson, "isMain", m_Components[entity - 1].isMain);
-	SetBoolToJson(componentJson, "isCulling", m_Components[entity - 1].isCulling);
+	SetBoolToJson(componentJson, "isMain", m_Components.Get(entity)->isMain);
+	SetBoolToJson(componentJson, "isCulling", m_Components.Get(entity)->isCulling);
+}
+
+void CameraManager::RefreshMainCamera()
+{
+	//Cameras never move in their storage, the main camera only changes when a camera is added or removed
+	for (auto& component : m_Components)
+	{
+		if (component.isMain)
+		{
+			m_GraphicManager->SetMainCamera(&component);
+			return;
+		}
+	}
 }
 }
@@ -70,6 +70,8 @@ void ComponentManagerContainer::Init()
 
 void ComponentManagerContainer::Update()
 {
+	m_TransformManager->Update();
+	m_BoundingSphereManager->Update();
 }
 
 void ComponentManagerContainer::Clear()
@@ -378,22 +380,67 @@ void ComponentManagerContainer::DrawOnInspector(Entity entity) const
 	}
 }
 
-void ComponentManagerContainer::OnEntityResize(const int newSize) const
+void ComponentManagerContainer::ReserveComponents(const ComponentMask mask, const size_t count) const
 {
-	m_TransformManager->OnEntityResize(newSize);
-	m_CameraManager->OnEntityResize(newSize);
-	m_MaterialDefaultManager->OnEntityResize(newSize);
-	m_MeshManager->OnEntityResize(newSize);
-	m_BoundingSphereManager->OnEntityResize(newSize);
-	m_DrawableManager->OnEntityResize(newSize);
-	m_MaterialSkyboxManager->OnEntityResize(newSize);
-	m_MeshRendererManager->OnEntityResize(newSize);
-	m_PointLightManager->OnEntityResize(newSize);
-	m_DirectionalLightManager->OnEntityResize(newSize);
-	m_SpotLightManager->OnEntityResize(newSize);
-	m_ShadowRendererManager->OnEntityResize(newSize);
-	m_MaterialTerrainManager->OnEntityResize(newSize);
-	m_DebugInfoManager->OnEntityResize(newSize);
-	m_MaterialMetalRoughnessManager->OnEntityResize(newSize);
+	for (auto componentIndex = 1; componentIndex < static_cast<int>(ComponentType::LENGTH); componentIndex++)
+	{
+		ComponentMask componentMask;
+		componentMask.AddComponent(static_cast<ComponentType>(componentIndex));
+		if (!mask.Matches(componentMask))
+		{
+			continue;
+		}
+
+		switch (static_cast<ComponentType>(componentIndex))
+		{
+		case ComponentType::TRANSFORM:
+			m_TransformManager->ReserveComponents(count);
+			break;
+		case ComponentType::CAMERA:
+			m_CameraManager->ReserveComponents(count);
+			break;
+		case ComponentType::MATERIAL_DEFAULT:
+			m_MaterialDefaultManager->ReserveComponents(count);
+			break;
+		case ComponentType::MODEL:
+			m_MeshManager->ReserveComponents(count);
+			break;
+		case ComponentType::BOUNDING_SPHERE:
+			m_BoundingSphereManager->ReserveComponents(count);
+			break;
+		case ComponentType::DRAWABLE:
+			m_DrawableManager->ReserveComponents(count);
+			break;
+		case ComponentType::MATERIAL_SKYBOX:
+			m_MaterialSkyboxManager->ReserveComponents(count);
+			break;
+		case ComponentType::MESH_RENDERER:
+			m_MeshRendererManager->ReserveComponents(count);
+			break;
+		case ComponentType::POINT_LIGHT:
+			m_PointLightManager->ReserveComponents(count);
+			break;
+		case ComponentType::DIRECTIONAL_LIGHT:
+			m_DirectionalLightManager->ReserveComponents(count);
+			break;
+		case ComponentType::SPOT_LIGHT:
+			m_SpotLightManager->ReserveComponents(count);
+			break;
+		case ComponentType::SHADOW_RENDERER:
+			m_ShadowRendererManager->ReserveComponents(count);
+			break;
+		case ComponentType::MATERIAL_TERRAIN:
+			m_MaterialTerrainManager->ReserveComponents(count);
+			break;
+		case ComponentType::DEBUG_INFO:
+			m_DebugInfoManager->ReserveComponents(count);
+			break;
+		case ComponentType::MATERIAL_METAL_ROUGHNESS:
+			m_MaterialMetalRoughnessManager->ReserveComponents(count);
+			break;
+		default:
+			break;
+		}
+	}
 }
 }
@@ -23,22 +23,94 @@ SOFTWARE.
 */
 
 #include <component/component_mask.h>
+#include <engine/simd.h>
 
 namespace dm
 {
+namespace
+{
+const uint64_t ONE = 1;
+}
+
 void ComponentMask::AddComponent(ComponentType componentType)
 {
-	mask |= (1 << static_cast<int>(componentType));
+	const auto bit = static_cast<uint32_t>(componentType);
+	words[bit / 64] |= ONE << (bit % 64);
 }
 
 void ComponentMask::RemoveComponent(ComponentType componentType)
 {
-	mask &= ~(1 << static_cast<int>(componentType));
+	const auto bit = static_cast<uint32_t>(componentType);
+	words[bit / 64] &= ~(ONE << (bit % 64));
+}
+
+bool ComponentMask::HasComponent(const ComponentType componentType) const
+{
+	const auto bit = static_cast<uint32_t>(componentType);
+	return (words[bit / 64] & (ONE << (bit % 64))) != 0;
 }
 
 bool ComponentMask::Matches(const ComponentMask systemMask) const
 {
-	return ((mask & systemMask.mask) == systemMask.mask);
+#ifdef DM_SIMD_ENABLED
+	for (uint32_t i = 0; i < WORD_NMB; i += 2)
+	{
+		const auto mask = _mm_load_si128(reinterpret_cast<const __m128i*>(&words[i]));
+		const auto system = _mm_load_si128(reinterpret_cast<const __m128i*>(&systemMask.words[i]));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(mask, system), system)) != 0xFFFF)
+		{
+			return false;
+		}
+	}
+	return true;
+#else
+	for (uint32_t i = 0; i < WORD_NMB; i++)
+	{
+		if ((words[i] & systemMask.words[i]) != systemMask.words[i])
+		{
+			return false;
+		}
+	}
+	return true;
+#endif
+}
+
+bool ComponentMask::Intersects(const ComponentMask other) const
+{
+#ifdef DM_SIMD_ENABLED
+	const auto zero = _mm_setzero_si128();
+	for (uint32_t i = 0; i < WORD_NMB; i += 2)
+	{
+		const auto mask = _mm_load_si128(reinterpret_cast<const __m128i*>(&words[i]));
+		const auto otherMask = _mm_load_si128(reinterpret_cast<const __m128i*>(&other.words[i]));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(mask, otherMask), zero)) != 0xFFFF)
+		{
+			return true;
+		}
+	}
+	return false;
+#else
+	for (uint32_t i = 0; i < WORD_NMB; i++)
+	{
+		if ((words[i] & other.words[i]) != 0)
+		{
+			return true;
+		}
+	}
+	return false;
+#endif
+}
+
+bool ComponentMask::IsEmpty() const
+{
+	for (auto word : words)
+	{
+		if (word != 0)
+		{
+			return false;
+		}
+	}
+	return true;
 }
 
 bool ComponentMask::IsNewMatch(ComponentMask oldMask, const ComponentMask systemMask) const
@@ -50,4 +122,40 @@ bool ComponentMask::IsNoLongerMatch(ComponentMask oldMask, const ComponentMask s
 {
 	return oldMask.Matches(systemMask) && !Matches(systemMask);
 }
+
+ComponentMask& ComponentMask::operator|=(const ComponentMask& other)
+{
+	for (uint32_t i = 0; i < WORD_NMB; i++)
+	{
+		words[i] |= other.words[i];
+	}
+	return *this;
+}
+
+bool ComponentMask::operator==(const ComponentMask& other) const
+{
+	for (uint32_t i = 0; i < WORD_NMB; i++)
+	{
+		if (words[i] != other.words[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ComponentMask::operator!=(const ComponentMask& other) const
+{
+	return !(*this == other);
+}
+
+size_t ComponentMask::Hash() const
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (auto word : words)
+	{
+		hash = (hash ^ word) * 1099511628211ULL;
+	}
+	return static_cast<size_t>(hash);
+}
 }
@@ -35,21 +35,22 @@ DebugInfo* DebugInfoManager::CreateComponent(Entity entity)
 {
 	DebugInfo debugInfo;
 	debugInfo.name = "entity";
-	m_Components[entity - 1] = debugInfo;
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, debugInfo);
 }
 
-void DebugInfoManager::DestroyComponent(Entity entity) {}
+void DebugInfoManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
+}
 
 void DebugInfoManager::OnDrawInspector(Entity entity)
 {
 	ImGui::Separator();
-	//ImGui::InputText("Name ", *m_Components[entity - 1].name, 20);
+	//ImGui::InputText("Name ", *m_Components.Get(entity)->name, 20);
 	char str1[128];
-	strcpy(str1, m_Components[entity - 1].name.c_str());
+	strcpy(str1, m_Components.Get(entity)->name.c_str());
 	ImGui::InputTextWithHint("input text (w/ hint)", "enter text here", str1, IM_ARRAYSIZE(str1));
-	m_Components[entity - 1].name = str1;
+	m_Components.Get(entity)->name = str1;
 }
 
 void DebugInfoManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -61,13 +62,13 @@ void DebugInfoManager::DecodeComponent(json& componentJson, const Entity entity)
 		debugInfo.name = componentJson["name"].get<std::string>();
 	}
 
-	m_Components[entity - 1] = debugInfo;
+	m_Components.Insert(entity, debugInfo);
 }
 
 void DebugInfoManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::DEBUG_INFO;
 
-	componentJson["name"] = m_Components[entity - 1].name;
+	componentJson["name"] = m_Components.Get(entity)->name;
 }
 }
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <component/drawable.h>
 #include "imgui.h"
+#include <graphics/graphic_manager.h>
 
 namespace dm
 {
@@ -38,17 +39,19 @@ Drawable* DrawableManager::CreateComponent(const Entity entity)
 	Drawable d;
 	d.isDrawable = false;
 
-	m_Components[entity - 1] = d;
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, d);
 }
 
-void DrawableManager::DestroyComponent(Entity entity) {}
+void DrawableManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
+}
 void DrawableManager::OnDrawInspector(Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Drawable");
-	ImGui::Text("Is drawable : %d", m_Components[entity - 1].isDrawable);
+	ImGui::Text("Is visible : %d", GraphicManager::Get()->GetVisibleEntities().Contains(entity));
+	ImGui::Checkbox("isOccluder", &m_Components.Get(entity)->isOccluder);
 }
 
 void DrawableManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -60,13 +63,19 @@ void DrawableManager::DecodeComponent(json& componentJson, const Entity entity)
 		drawable.isDrawable = GetBoolFromJson(componentJson, "isDrawable");
 	}
 
-	m_Components[entity - 1] = drawable;
+	if(CheckJsonExists(componentJson, "isOccluder"))
+	{
+		drawable.isOccluder = GetBoolFromJson(componentJson, "isOccluder");
+	}
+
+	m_Components.Insert(entity, drawable);
 }
 
 void DrawableManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::DRAWABLE;
 
-	SetBoolToJson(componentJson, "isDrawable", m_Components[entity - 1].isDrawable);
+	SetBoolToJson(componentJson, "isDrawable", m_Components.Get(entity)->isDrawable);
+	SetBoolToJson(componentJson, "isOccluder", m_Components.Get(entity)->isOccluder);
 }
 }
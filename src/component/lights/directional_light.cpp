@@ -24,9 +24,70 @@ SOFTWARE.
 
 #include <component/lights/directional_light.h>
 #include "imgui_impl_vulkan.h"
+#include <component/camera.h>
+#include <glm/glm.hpp>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
 
 namespace dm
 {
+glm::mat4x4 DirectionalLightManager::ComputeLightSpaceMatrix(const Camera& camera, const glm::vec3& lightDirection)
+{
+	glm::vec3 frustumCorners[8] = {
+	glm::vec3(-1.0f,  1.0f, -1.0f),
+	glm::vec3(1.0f,  1.0f, -1.0f),
+	glm::vec3(1.0f, -1.0f, -1.0f),
+	glm::vec3(-1.0f, -1.0f, -1.0f),
+	glm::vec3(-1.0f,  1.0f,  1.0f),
+	glm::vec3(1.0f,  1.0f,  1.0f),
+	glm::vec3(1.0f, -1.0f,  1.0f),
+	glm::vec3(-1.0f, -1.0f,  1.0f),
+	};
+
+	// Project frustum corners into world space
+	glm::mat4 invCam = glm::inverse(camera.projectionMatrix * camera.viewMatrix);
+	for (uint32_t i = 0; i < 8; i++) {
+		glm::vec4 invCorner = invCam * glm::vec4(frustumCorners[i], 1.0f);
+		frustumCorners[i] = invCorner / invCorner.w;
+	}
+
+	for (uint32_t i = 0; i < 4; i++) {
+		glm::vec3 dist = frustumCorners[i + 4] - frustumCorners[i];
+		frustumCorners[i + 4] = frustumCorners[i] + (dist);
+		frustumCorners[i] = frustumCorners[i] + (dist);
+	}
+
+	// Get frustum center
+	glm::vec3 frustumCenter = glm::vec3(0.0f);
+	for (uint32_t i = 0; i < 8; i++) {
+		frustumCenter += frustumCorners[i];
+	}
+	frustumCenter /= 8.0f;
+
+	float radius = 0.0f;
+	for (uint32_t i = 0; i < 8; i++) {
+		float distance = glm::length(frustumCorners[i] - frustumCenter);
+		radius = glm::max(radius, distance);
+	}
+	radius = std::ceil(radius * 16.0f) / 16.0f;
+
+	glm::vec3 maxExtents = glm::vec3(radius);
+	glm::vec3 minExtents = -maxExtents;
+
+	glm::mat4 lightView;
+	if(lightDirection == camera.up)
+	{
+		lightView = glm::mat4(glm::vec4(1.0f), glm::vec4(0), glm::vec4(0), glm::vec4(0));
+	}else
+	{
+		lightView = glm::lookAt(glm::normalize(-lightDirection) * -minExtents.z, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+	}
+
+	glm::mat4 lightProjection = glm::ortho<float>(minExtents.x, maxExtents.x, minExtents.y, maxExtents.y, -(maxExtents.z - minExtents.z), maxExtents.z - minExtents.z);
+
+	return lightProjection * lightView;
+}
+
 void DirectionalLightManager::Init() {}
 
 void DirectionalLightManager::Update() {}
@@ -38,19 +99,21 @@ DirectionalLight* DirectionalLightManager::CreateComponent(Entity entity)
 	light.direction = glm::vec3(0, -1.0, 0);
 	light.intensity = 1;
 
-	m_Components[entity - 1] = light;
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, light);
 }
 
-void DirectionalLightManager::DestroyComponent(Entity entity) {}
+void DirectionalLightManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
+}
 
 void DirectionalLightManager::OnDrawInspector(Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Directional Light");
-	ImGui::ColorPicker4("lightColor", &m_Components[entity - 1].color[0]);
-	ImGui::DragFloat("intensity", &m_Components[entity - 1].intensity, 0.1f, 0, 100000);
-	ImGui::DragFloat3("direction", &m_Components[entity - 1].direction[0], 0.1f);
+	ImGui::ColorPicker4("lightColor", &m_Components.Get(entity)->color[0]);
+	ImGui::DragFloat("intensity", &m_Components.Get(entity)->intensity, 0.1f, 0, 100000);
+	ImGui::DragFloat3("direction", &m_Components.Get(entity)->direction[0], 0.1f);
 }
 
 void DirectionalLightManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -66,17 +129,17 @@ void DirectionalLightManager::DecodeComponent(json& componentJson, const Entity
 	if (CheckJsonExists(componentJson, "intensity"))
 		directionalLight.intensity = componentJson["intensity"];
 
-	m_Components[entity - 1] = directionalLight;
+	m_Components.Insert(entity, directionalLight);
 }
 
 void DirectionalLightManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::DIRECTIONAL_LIGHT;
 
-	SetVector3ToJson(componentJson, "direction", m_Components[entity - 1].direction);
+	SetVector3ToJson(componentJson, "direction", m_Components.Get(entity)->direction);
 
-	SetColorToJson(componentJson, "color", m_Components[entity - 1].color);
+	SetColorToJson(componentJson, "color", m_Components.Get(entity)->color);
 
-	componentJson["intensity"] = m_Components[entity - 1].intensity;
+	componentJson["intensity"] = m_Components.Get(entity)->intensity;
 }
 }
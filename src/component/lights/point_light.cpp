@@ -38,19 +38,21 @@ PointLight* PointLightManager::CreateComponent(Entity entity)
 	light.radius = 10;
 	light.intensity = 1;
 
-	m_Components[entity - 1] = light;
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, light);
 }
 
-void PointLightManager::DestroyComponent(Entity entity) {}
+void PointLightManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
+}
 
 void PointLightManager::OnDrawInspector(Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Point Light");
-	ImGui::ColorPicker4("lightColor", &m_Components[entity - 1].color[0]);
-	ImGui::DragFloat("radius", &m_Components[entity - 1].radius, 0.1f);
-	ImGui::DragFloat("intensity", &m_Components[entity - 1].intensity, 0.1f, 0, 100000);
+	ImGui::ColorPicker4("lightColor", &m_Components.Get(entity)->color[0]);
+	ImGui::DragFloat("radius", &m_Components.Get(entity)->radius, 0.1f);
+	ImGui::DragFloat("intensity", &m_Components.Get(entity)->intensity, 0.1f, 0, 100000);
 }
 
 void PointLightManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -66,17 +68,17 @@ void PointLightManager::DecodeComponent(json& componentJson, const Entity entity
 	if (CheckJsonExists(componentJson, "intensity"))
 		directionalLight.intensity = componentJson["intensity"];
 
-	m_Components[entity - 1] = directionalLight;
+	m_Components.Insert(entity, directionalLight);
 }
 
 void PointLightManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::POINT_LIGHT;
 
-	SetColorToJson(componentJson, "color", m_Components[entity - 1].color);
+	SetColorToJson(componentJson, "color", m_Components.Get(entity)->color);
 
-	componentJson["radius"] = m_Components[entity - 1].radius;
+	componentJson["radius"] = m_Components.Get(entity)->radius;
 
-	componentJson["intensity"] = m_Components[entity - 1].intensity;
+	componentJson["intensity"] = m_Components.Get(entity)->intensity;
 }
 }
@@ -37,19 +37,21 @@ SpotLight* SpotLightManager::CreateComponent(Entity entity)
 	light.angle = 30;
 	light.target = glm::vec3(0, -10, 0);
 
-	m_Components[entity - 1] = light;
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, light);
+}
+void SpotLightManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
 }
-void SpotLightManager::DestroyComponent(Entity entity) {}
 void SpotLightManager::OnDrawInspector(const Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Spot Light");
-	ImGui::ColorPicker4("lightColor", &m_Components[entity - 1].color[0]);
-	ImGui::DragFloat("intensity", &m_Components[entity - 1].intensity, 0.1f, 0, 100000);
-	ImGui::DragFloat3("target", &m_Components[entity - 1].target[0], 0.1f);
-	ImGui::DragFloat("angle", &m_Components[entity - 1].angle, 0.1f, 0, 360);
-	ImGui::DragFloat("range", &m_Components[entity - 1].range, 0.1f, 0, 360);
+	ImGui::ColorPicker4("lightColor", &m_Components.Get(entity)->color[0]);
+	ImGui::DragFloat("intensity", &m_Components.Get(entity)->intensity, 0.1f, 0, 100000);
+	ImGui::DragFloat3("target", &m_Components.Get(entity)->target[0], 0.1f);
+	ImGui::DragFloat("angle", &m_Components.Get(entity)->angle, 0.1f, 0, 360);
+	ImGui::DragFloat("range", &m_Components.Get(entity)->range, 0.1f, 0, 360);
 }
 
 void SpotLightManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -74,19 +76,19 @@ void SpotLightManager::DecodeComponent(json& componentJson, const Entity entity)
 	if (CheckJsonExists(componentJson, "intensity"))
 		directionalLight.intensity = componentJson["intensity"];
 
-	m_Components[entity - 1] = directionalLight;
+	m_Components.Insert(entity, directionalLight);
 }
 
 void SpotLightManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::SPOT_LIGHT;
 
-	SetVector3ToJson(componentJson, "target", m_Components[entity - 1].target);
+	SetVector3ToJson(componentJson, "target", m_Components.Get(entity)->target);
 
-	SetColorToJson(componentJson, "color", m_Components[entity - 1].color);
+	SetColorToJson(componentJson, "color", m_Components.Get(entity)->color);
 
-	componentJson["intensity"] = m_Components[entity - 1].intensity;
-	componentJson["angle"] = m_Components[entity - 1].angle;
-	componentJson["range"] = m_Components[entity - 1].range;
+	componentJson["intensity"] = m_Components.Get(entity)->intensity;
+	componentJson["angle"] = m_Components.Get(entity)->angle;
+	componentJson["range"] = m_Components.Get(entity)->range;
 }
 }
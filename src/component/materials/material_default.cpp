@@ -33,7 +33,7 @@ MaterialDefaultManager::MaterialDefaultManager() { }
 
 MaterialDefaultManager::~MaterialDefaultManager()
 {
-	m_Components.clear();
+	m_Components.Clear();
 }
 
 void MaterialDefaultManager::Init() {}
@@ -57,13 +57,13 @@ MaterialDefault* MaterialDefaultManager::CreateComponent(const Entity entity)
 			PipelineGraphics::Mode::MRT)
 	);
 
-	m_Components[entity - 1] = std::move(material);
-
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, std::move(material));
 }
 
-void MaterialDefaultManager::DestroyComponent(Entity entity) {}
+void MaterialDefaultManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
+}
 
 template<typename T>
 static std::string To(const T &val)
@@ -87,13 +87,17 @@ static std::string To(const T &val)
 	}
 }
 
-std::vector<Shader::Define> MaterialDefaultManager::GetDefines(const MaterialDefault& component)
+std::vector<Shader::Define> MaterialDefaultManager::GetDefines(const MaterialDefault& component, const bool gpuDriven)
 {
+	const auto bindless = TextureManager::Get()->IsBindless();
+
 	std::vector<Shader::Define> defines;
 	//TODO Changer pour mettre correctement les valeur poru les defines
-	defines.emplace_back("DIFFUSE_MAPPING", To<int32_t>(component.diffuseTexture != nullptr));
-	defines.emplace_back("MATERIAL_MAPPING", To<int32_t>(component.materialTexture != nullptr));
-	defines.emplace_back("NORMAL_MAPPING", To<int32_t>(component.normalTexture != nullptr));
+	defines.emplace_back("DIFFUSE_MAPPING", To<int32_t>(!bindless && component.diffuseTexture != nullptr));
+	defines.emplace_back("MATERIAL_MAPPING", To<int32_t>(!bindless && component.materialTexture != nullptr));
+	defines.emplace_back("NORMAL_MAPPING", To<int32_t>(!bindless && component.normalTexture != nullptr));
+	defines.emplace_back("BINDLESS", To<int32_t>(bindless));
+	defines.emplace_back("GPU_DRIVEN", To<int32_t>(gpuDriven));
 	return defines;
 }
 
@@ -104,28 +108,33 @@ void MaterialDefaultManager::PushDescriptor(MaterialDefault& material, Descripto
 	descriptorSet.Push("samplerNormal", material.normalTexture);
 }
 
-void MaterialDefaultManager::PushUniform(MaterialDefault& material, const glm::mat4x4 worldPos, UniformHandle& uniformObject)
+ObjectData MaterialDefaultManager::GetObjectData(const MaterialDefault& material, const glm::mat4x4& worldMatrix)
 {
-	uniformObject.Push("transform", worldPos);
-	uniformObject.Push("baseDiffuse", material.color * 255);
-	uniformObject.Push("metallic", static_cast<float>(material.metallic));
-	uniformObject.Push("roughness", static_cast<float>(material.roughness));
-	uniformObject.Push("ignoreFog", material.ignoreFog);
-	uniformObject.Push("ignoreLighting", material.ignoreLighting);
+	ObjectData object;
+	object.transform = worldMatrix;
+	object.baseDiffuse = glm::vec4(material.color.r * 255, material.color.g * 255, material.color.b * 255, material.color.a);
+	object.metallic = material.metallic;
+	object.roughness = material.roughness;
+	object.ignoreFog = material.ignoreFog;
+	object.ignoreLighting = material.ignoreLighting;
+	object.diffuseTexture = TextureManager::Get()->GetTextureIndex(material.diffuseTexture);
+	object.materialTexture = TextureManager::Get()->GetTextureIndex(material.materialTexture);
+	object.normalTexture = TextureManager::Get()->GetTextureIndex(material.normalTexture);
+	return object;
 }
 
 MaterialDefault& MaterialDefaultManager::Get(const Entity entity)
 {
-	return m_Components[entity - 1];
+	return *m_Components.Get(entity);
 }
 
 void MaterialDefaultManager::OnDrawInspector(const Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Default Material");
-	ImGui::ColorPicker4("diffuseColor", &m_Components[entity - 1].color[0]);
-	ImGui::DragFloat("Roughness", &m_Components[entity - 1].roughness, 0.01f, 0.0f, 1.0f);
-	ImGui::DragFloat("Metallic", &m_Components[entity - 1].metallic, 0.01f, 0.0f, 1.0f);
+	ImGui::ColorPicker4("diffuseColor", &m_Components.Get(entity)->color[0]);
+	ImGui::DragFloat("Roughness", &m_Components.Get(entity)->roughness, 0.01f, 0.0f, 1.0f);
+	ImGui::DragFloat("Metallic", &m_Components.Get(entity)->metallic, 0.01f, 0.0f, 1.0f);
 
 	static bool showCode = true;
 	if (showCode) {
@@ -143,7 +152,7 @@ void MaterialDefaultManager::OnDrawInspector(const Entity entity)
 
 	if(showCode)
 	{
-		ImGui::Text(m_Components[entity - 1].pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());
+		ImGui::Text(m_Components.Get(entity)->pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());
 	}
 }
 
@@ -156,8 +165,7 @@ MaterialDefault* MaterialDefaultManager::AddComponent(const Entity entity, Mater
 			MaterialDefaultManager::GetDefines(component),
 			PipelineGraphics::Mode::MRT)
 	);
-	m_Components[entity - 1] = component;
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, component);
 }
 
 void MaterialDefaultManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -200,30 +208,30 @@ void MaterialDefaultManager::DecodeComponent(json& componentJson, const Entity e
 			PipelineGraphics::Mode::MRT)
 	);
 
-	m_Components[entity - 1] = std::move(material);
+	m_Components.Insert(entity, std::move(material));
 }
 
 void MaterialDefaultManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::MATERIAL_DEFAULT;
 
-	SetColorToJson(componentJson, "color", m_Components[entity - 1].color);
+	SetColorToJson(componentJson, "color", m_Components.Get(entity)->color);
 
-	componentJson["metallic"] = m_Components[entity - 1].metallic;
+	componentJson["metallic"] = m_Components.Get(entity)->metallic;
 
-	componentJson["roughness"] = m_Components[entity - 1].roughness;
+	componentJson["roughness"] = m_Components.Get(entity)->roughness;
 
-	SetBoolToJson(componentJson, "castShadow", m_Components[entity - 1].castsShadows);
-	SetBoolToJson(componentJson, "ignoreLighting", m_Components[entity - 1].ignoreLighting);
-	SetBoolToJson(componentJson, "ignoreFog", m_Components[entity - 1].ignoreFog);
+	SetBoolToJson(componentJson, "castShadow", m_Components.Get(entity)->castsShadows);
+	SetBoolToJson(componentJson, "ignoreLighting", m_Components.Get(entity)->ignoreLighting);
+	SetBoolToJson(componentJson, "ignoreFog", m_Components.Get(entity)->ignoreFog);
 
-	if(m_Components[entity - 1].diffuseTexture != nullptr)
-	componentJson["texture"] = m_Components[entity - 1].diffuseTexture.get()->GetFilename();
+	if(m_Components.Get(entity)->diffuseTexture != nullptr)
+	componentJson["texture"] = m_Components.Get(entity)->diffuseTexture.get()->GetFilename();
 
-	if (m_Components[entity - 1].normalTexture != nullptr)
-	componentJson["normal"] = m_Components[entity - 1].normalTexture.get()->GetFilename();
+	if (m_Components.Get(entity)->normalTexture != nullptr)
+	componentJson["normal"] = m_Components.Get(entity)->normalTexture.get()->GetFilename();
 
-	if (m_Components[entity - 1].materialTexture != nullptr)
-	componentJson["material"] = m_Components[entity - 1].materialTexture.get()->GetFilename();
+	if (m_Components.Get(entity)->materialTexture != nullptr)
+	componentJson["material"] = m_Components.Get(entity)->materialTexture.get()->GetFilename();
 }
 }
@@ -33,7 +33,7 @@ namespace dm
 
 	MaterialMetalRoughnessManager::~MaterialMetalRoughnessManager()
 	{
-		m_Components.clear();
+		m_Components.Clear();
 	}
 
 	void MaterialMetalRoughnessManager::Init() {}
@@ -57,13 +57,13 @@ namespace dm
 				PipelineGraphics::Mode::MRT)
 		);
 
-		m_Components[entity - 1] = std::move(material);
-
-
-		return &m_Components[entity - 1];
+		return m_Components.Insert(entity, std::move(material));
 	}
 
-	void MaterialMetalRoughnessManager::DestroyComponent(Entity entity) {}
+	void MaterialMetalRoughnessManager::DestroyComponent(const Entity entity)
+	{
+		m_Components.Remove(entity);
+	}
 
 	template<typename T>
 	static std::string To(const T &val)
@@ -117,16 +117,16 @@ namespace dm
 
 	MaterialMetalRoughness& MaterialMetalRoughnessManager::Get(const Entity entity)
 	{
-		return m_Components[entity - 1];
+		return *m_Components.Get(entity);
 	}
 
 	void MaterialMetalRoughnessManager::OnDrawInspector(const Entity entity)
 	{
 		ImGui::Separator();
 		ImGui::TextWrapped("Material metal roughness");
-		ImGui::ColorPicker4("diffuseColor", &m_Components[entity - 1].color[0]);
-		ImGui::DragFloat("Roughness", &m_Components[entity - 1].roughness, 0.01f, 0.0f, 1.0f);
-		ImGui::DragFloat("Metallic", &m_Components[entity - 1].metallic, 0.01f, 0.0f, 1.0f);
+		ImGui::ColorPicker4("diffuseColor", &m_Components.Get(entity)->color[0]);
+		ImGui::DragFloat("Roughness", &m_Components.Get(entity)->roughness, 0.01f, 0.0f, 1.0f);
+		ImGui::DragFloat("Metallic", &m_Components.Get(entity)->metallic, 0.01f, 0.0f, 1.0f);
 
 		static bool showCode = true;
 		if (showCode) {
@@ -145,7 +145,7 @@ namespace dm
 
 		if (showCode)
 		{
-			ImGui::Text(m_Components[entity - 1].pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());
+			ImGui::Text(m_Components.Get(entity)->pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());
 		}
 	}
 
@@ -158,8 +158,7 @@ namespace dm
 				MaterialMetalRoughnessManager::GetDefines(component),
 				PipelineGraphics::Mode::MRT)
 		);
-		m_Components[entity - 1] = component;
-		return &m_Components[entity - 1];
+		return m_Components.Insert(entity, component);
 	}
 
 	void MaterialMetalRoughnessManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -205,33 +204,33 @@ namespace dm
 				PipelineGraphics::Mode::MRT)
 		);
 
-		m_Components[entity - 1] = std::move(material);
+		m_Components.Insert(entity, std::move(material));
 	}
 
 	void MaterialMetalRoughnessManager::EncodeComponent(json& componentJson, const Entity entity)
 	{
 		componentJson["type"] = ComponentType::MATERIAL_DEFAULT;
 
-		SetColorToJson(componentJson, "color", m_Components[entity - 1].color);
+		SetColorToJson(componentJson, "color", m_Components.Get(entity)->color);
 
-		componentJson["metallic"] = m_Components[entity - 1].metallic;
+		componentJson["metallic"] = m_Components.Get(entity)->metallic;
 
-		componentJson["roughness"] = m_Components[entity - 1].roughness;
+		componentJson["roughness"] = m_Components.Get(entity)->roughness;
 
-		SetBoolToJson(componentJson, "castShadow", m_Components[entity - 1].castsShadows);
-		SetBoolToJson(componentJson, "ignoreLighting", m_Components[entity - 1].ignoreLighting);
-		SetBoolToJson(componentJson, "ignoreFog", m_Components[entity - 1].ignoreFog);
+		SetBoolToJson(componentJson, "castShadow", m_Components.Get(entity)->castsShadows);
+		SetBoolToJson(componentJson, "ignoreLighting", m_Components.Get(entity)->ignoreLighting);
+		SetBoolToJson(componentJson, "ignoreFog", m_Components.Get(entity)->ignoreFog);
 
-		if (m_Components[entity - 1].diffuseTexture != nullptr)
-			componentJson["texture"] = m_Components[entity - 1].diffuseTexture.get()->GetFilename();
+		if (m_Components.Get(entity)->diffuseTexture != nullptr)
+			componentJson["texture"] = m_Components.Get(entity)->diffuseTexture.get()->GetFilename();
 
-		if (m_Components[entity - 1].normalTexture != nullptr)
-			componentJson["normal"] = m_Components[entity - 1].normalTexture.get()->GetFilename();
+		if (m_Components.Get(entity)->normalTexture != nullptr)
+			componentJson["normal"] = m_Components.Get(entity)->normalTexture.get()->GetFilename();
 
-		if (m_Components[entity - 1].metalTexture != nullptr)
-			componentJson["metal"] = m_Components[entity - 1].metalTexture.get()->GetFilename();
+		if (m_Components.Get(entity)->metalTexture != nullptr)
+			componentJson["metal"] = m_Components.Get(entity)->metalTexture.get()->GetFilename();
 
-		if (m_Components[entity - 1].roughnessTexture != nullptr)
-			componentJson["roughness"] = m_Components[entity - 1].roughnessTexture.get()->GetFilename();
+		if (m_Components.Get(entity)->roughnessTexture != nullptr)
+			componentJson["roughness"] = m_Components.Get(entity)->roughnessTexture.get()->GetFilename();
 	}
 }
@@ -51,9 +51,7 @@ MaterialSkybox* MaterialSkyboxManager::AddComponent(const Entity entity, Materia
 			VK_CULL_MODE_FRONT_BIT)
 	);
 
-	m_Components[entity - 1] = component;
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, component);
 } 
 
 MaterialSkybox* MaterialSkyboxManager::CreateComponent(const Entity entity)
@@ -79,21 +77,20 @@ MaterialSkybox* MaterialSkyboxManager::CreateComponent(const Entity entity)
 			VK_CULL_MODE_FRONT_BIT)
 	);
 
-	m_Components[entity - 1] = std::move(material);
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, std::move(material));
 }
 
-void MaterialSkyboxManager::DestroyComponent(Entity entity)
+void MaterialSkyboxManager::DestroyComponent(const Entity entity)
 {
+	m_Components.Remove(entity);
 }
 
 void MaterialSkyboxManager::OnDrawInspector(Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Skybox Material");
-	//ImGui::ColorPicker4("diffuseColor", &m_Components[entity - 1].color[0]);
-	/*ImGui::Text(m_Components[entity - 1].pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());*/
+	//ImGui::ColorPicker4("diffuseColor", &m_Components.Get(entity)->color[0]);
+	/*ImGui::Text(m_Components.Get(entity)->pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());*/
 }
 
 void MaterialSkyboxManager::PushDescriptor(MaterialSkybox& material, DescriptorHandle &descriptorSet)
@@ -142,21 +139,21 @@ void MaterialSkyboxManager::DecodeComponent(json& componentJson, const Entity en
 			VK_CULL_MODE_FRONT_BIT)
 	);
 
-	m_Components[entity - 1] = std::move(material);
+	m_Components.Insert(entity, std::move(material));
 }
 
 void MaterialSkyboxManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::MATERIAL_SKYBOX;
 
-	SetColorToJson(componentJson, "color", m_Components[entity - 1].color);
-	SetColorToJson(componentJson, "fogColor", m_Components[entity - 1].fogColor);
+	SetColorToJson(componentJson, "color", m_Components.Get(entity)->color);
+	SetColorToJson(componentJson, "fogColor", m_Components.Get(entity)->fogColor);
 
-	componentJson["blend"] = m_Components[entity - 1].blend;
+	componentJson["blend"] = m_Components.Get(entity)->blend;
 
-	SetVector2ToJson(componentJson, "fogLimit", m_Components[entity - 1].fogLimit);
+	SetVector2ToJson(componentJson, "fogLimit", m_Components.Get(entity)->fogLimit);
 
-	componentJson["image"] = m_Components[entity - 1].image.get()->GetFilename();
-	componentJson["extension"] = m_Components[entity - 1].image.get()->GetFileSuffix();
+	componentJson["image"] = m_Components.Get(entity)->image.get()->GetFilename();
+	componentJson["extension"] = m_Components.Get(entity)->image.get()->GetFileSuffix();
 }
 }
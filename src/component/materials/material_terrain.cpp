@@ -43,8 +43,7 @@ MaterialTerrain* MaterialTerrainManager::AddComponent(const Entity entity, Mater
 			PipelineGraphics::Mode::MRT)
 	);
 
-	m_Components[entity - 1] = std::move(component);
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, std::move(component));
 }
 MaterialTerrain* MaterialTerrainManager::CreateComponent(const Entity entity)
 {
@@ -59,13 +58,13 @@ MaterialTerrain* MaterialTerrainManager::CreateComponent(const Entity entity)
 			PipelineGraphics::Mode::MRT)
 	);
 
-	m_Components[entity - 1] = std::move(material);
-
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, std::move(material));
 }
 
-void MaterialTerrainManager::DestroyComponent(Entity entity) {}
+void MaterialTerrainManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
+}
 
 void MaterialTerrainManager::OnDrawInspector(Entity entity)
 {
@@ -89,7 +88,7 @@ void MaterialTerrainManager::OnDrawInspector(Entity entity)
 
 	if (showCode)
 	{
-		ImGui::Text(m_Components[entity - 1].pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());
+		ImGui::Text(m_Components.Get(entity)->pipelineMaterial->GetPipeline()->GetShader()->ToString().c_str());
 	}
 }
 void MaterialTerrainManager::PushDescriptor(MaterialTerrain& material, DescriptorHandle& descriptorSet)
@@ -98,46 +97,6 @@ void MaterialTerrainManager::PushDescriptor(MaterialTerrain& material, Descripto
 	descriptorSet.Push("samplerHeight", material.noiseMap);
 }
 
-void ComputeFrustumPlanes(glm::mat4 &viewMatrix, glm::mat4 &projMatrix, std::vector<glm::vec4>& planes)
-{
-	glm::mat4 matrix = projMatrix * viewMatrix;
-	planes[0].x = matrix[0].w + matrix[0].x;
-	planes[0].y = matrix[1].w + matrix[1].x;
-	planes[0].z = matrix[2].w + matrix[2].x;
-	planes[0].w = matrix[3].w + matrix[3].x;
-
-	planes[1].x = matrix[0].w - matrix[0].x;
-	planes[1].y = matrix[1].w - matrix[1].x;
-	planes[1].z = matrix[2].w - matrix[2].x;
-	planes[1].w = matrix[3].w - matrix[3].x;
-
-	planes[2].x = matrix[0].w - matrix[0].y;
-	planes[2].y = matrix[1].w - matrix[1].y;
-	planes[2].z = matrix[2].w - matrix[2].y;
-	planes[2].w = matrix[3].w - matrix[3].y;
-
-	planes[3].x = matrix[0].w + matrix[0].y;
-	planes[3].y = matrix[1].w + matrix[1].y;
-	planes[3].z = matrix[2].w + matrix[2].y;
-	planes[3].w = matrix[3].w + matrix[3].y;
-
-	planes[4].x = matrix[0].w + matrix[0].z;
-	planes[4].y = matrix[1].w + matrix[1].z;
-	planes[4].z = matrix[2].w + matrix[2].z;
-	planes[4].w = matrix[3].w + matrix[3].z;
-
-	planes[5].x = matrix[0].w - matrix[0].z;
-	planes[5].y = matrix[1].w - matrix[1].z;
-	planes[5].z = matrix[2].w - matrix[2].z;
-	planes[5].w = matrix[3].w - matrix[3].z;
-
-	for (auto i = 0; i < planes.size(); i++)
-	{
-		float length = sqrtf(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
-		planes[i] /= length;
-	}
-}
-
 void MaterialTerrainManager::PushUniform(MaterialTerrain& material, const glm::mat4x4 worldPos,
 	UniformHandle& uniformObject)
 {
@@ -160,7 +119,7 @@ void MaterialTerrainManager::DecodeComponent(json& componentJson, const Entity e
 			PipelineGraphics::Mode::MRT)
 	);
 
-	m_Components[entity - 1] = std::move(material);
+	m_Components.Insert(entity, std::move(material));
 }
 void MaterialTerrainManager::EncodeComponent(json& componentJson, const Entity entity) {}
 }
@@ -37,12 +37,12 @@ void MeshRendererManager::Update()
 MeshRenderer* MeshRendererManager::CreateComponent(const Entity entity)
 {
 	MeshRenderer meshRenderer;
-	m_Components[entity - 1] = std::move(meshRenderer);
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, std::move(meshRenderer));
 }
 
-void MeshRendererManager::DestroyComponent(Entity entity)
+void MeshRendererManager::DestroyComponent(const Entity entity)
 {
+	m_Components.Remove(entity);
 }
 
 void MeshRendererManager::OnDrawInspector(Entity entity)
@@ -59,15 +59,15 @@ void MeshRendererManager::DecodeComponent(json& componentJson, const Entity enti
 	if (CheckJsonExists(componentJson, "castShadow"))
 		meshRenderer.castsShadows = GetBoolFromJson(componentJson, "castShadow");
 
-	m_Components[entity - 1] = std::move(meshRenderer);
+	m_Components.Insert(entity, std::move(meshRenderer));
 }
 
 void MeshRendererManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::MESH_RENDERER;
 
-	componentJson["materialType"] = static_cast<MeshRenderer::MaterialType>(m_Components[entity - 1].materialType);
+	componentJson["materialType"] = static_cast<MeshRenderer::MaterialType>(m_Components.Get(entity)->materialType);
 
-	SetBoolToJson(componentJson, "castShadow", m_Components[entity - 1].castsShadows);
+	SetBoolToJson(componentJson, "castShadow", m_Components.Get(entity)->castsShadows);
 }
 }
@@ -32,7 +32,7 @@ ModelComponentManager::ModelComponentManager() { }
 
 ModelComponentManager::~ModelComponentManager()
 {
-	m_Components.clear();
+	m_Components.Clear();
 }
 
 void ModelComponentManager::Init() {}
@@ -46,11 +46,12 @@ Model* ModelComponentManager::CreateComponent(const Entity entity)
 
 	mesh.model = nullptr;
 
-	m_Components[entity - 1] = mesh;
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, mesh);
+}
+void ModelComponentManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
 }
-void ModelComponentManager::DestroyComponent(Entity entity) {}
 void ModelComponentManager::OnDrawInspector(Entity entity) {}
 
 void ModelComponentManager::DecodeComponent(json& componentJson, const Entity entity)
@@ -65,13 +66,13 @@ void ModelComponentManager::DecodeComponent(json& componentJson, const Entity en
 		mesh.model = nullptr;
 	}
 
-	m_Components[entity - 1] = mesh;
+	m_Components.Insert(entity, mesh);
 }
 
 void ModelComponentManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::MODEL;
 
-	componentJson["modelName"] = Engine::Get()->GetModelManager()->GetModelName(m_Components[entity - 1].model);
+	componentJson["modelName"] = Engine::Get()->GetModelManager()->GetModelName(m_Components.Get(entity)->model);
 }
 }
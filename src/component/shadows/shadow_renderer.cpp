@@ -37,12 +37,12 @@ void ShadowRendererManager::Update()
 ShadowRenderer* ShadowRendererManager::CreateComponent(const Entity entity)
 {
 	ShadowRenderer shadowRenderer;
-	m_Components[entity - 1] = std::move(shadowRenderer);
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, std::move(shadowRenderer));
 }
 
-void ShadowRendererManager::DestroyComponent(Entity entity)
+void ShadowRendererManager::DestroyComponent(const Entity entity)
 {
+	m_Components.Remove(entity);
 }
 
 void ShadowRendererManager::OnDrawInspector(Entity entity)
@@ -52,7 +52,7 @@ void ShadowRendererManager::OnDrawInspector(Entity entity)
 void ShadowRendererManager::DecodeComponent(json& componentJson, const Entity entity)
 {
 	ShadowRenderer shadowRenderer;
-	m_Components[entity - 1] = std::move(shadowRenderer);
+	m_Components.Insert(entity, std::move(shadowRenderer));
 }
 
 void ShadowRendererManager::EncodeComponent(json& componentJson, const Entity entity)
@@ -28,18 +28,294 @@ SOFTWARE.
 #include <graphics/graphic_manager.h>
 #include <glm/ext/matrix_transform.hpp>
 #include "engine/engine.h"
+#include <engine/simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 namespace dm
 {
+namespace
+{
+/**
+ * \brief World matrix T * Rx * Ry * Rz * S of the index-th transform, same composition as ComputeWorldMatrix written out per element
+ */
+void ComputeWorldMatrixScalar(const TransformSoA& transforms, const size_t index, glm::mat4x4& worldMatrix)
+{
+	const auto sinX = std::sin(transforms.rotationX[index]);
+	const auto cosX = std::cos(transforms.rotationX[index]);
+	const auto sinY = std::sin(transforms.rotationY[index]);
+	const auto cosY = std::cos(transforms.rotationY[index]);
+	const auto sinZ = std::sin(transforms.rotationZ[index]);
+	const auto cosZ = std::cos(transforms.rotationZ[index]);
+
+	const auto scaleX = transforms.scaleX[index];
+	const auto scaleY = transforms.scaleY[index];
+	const auto scaleZ = transforms.scaleZ[index];
+
+	worldMatrix[0] = glm::vec4(cosY * cosZ, sinX * sinY * cosZ + cosX * sinZ, sinX * sinZ - cosX * sinY * cosZ, 0.0f) * scaleX;
+	worldMatrix[1] = glm::vec4(-cosY * sinZ, cosX * cosZ - sinX * sinY * sinZ, cosX * sinY * sinZ + sinX * cosZ, 0.0f) * scaleY;
+	worldMatrix[2] = glm::vec4(sinY, -sinX * cosY, cosX * cosY, 0.0f) * scaleZ;
+	worldMatrix[3] = glm::vec4(transforms.positionX[index], transforms.positionY[index], transforms.positionZ[index], 1.0f);
+}
+
+#ifdef DM_SIMD_ENABLED
+/**
+ * \brief Compute the world matrices of Simd::WIDTH transforms at a time, return the number of transforms handled
+ */
+template<typename Simd>
+size_t ComputeWorldMatricesSimd(const TransformSoA& transforms, glm::mat4x4* const* worldMatrices)
+{
+	using Float = typename Simd::Float;
+
+	const auto batchedCount = transforms.Size() / Simd::WIDTH * Simd::WIDTH;
+	const auto zero = Simd::Set(0.0f);
+	const auto one = Simd::Set(1.0f);
+
+	for (size_t i = 0; i < batchedCount; i += Simd::WIDTH)
+	{
+		Float sinX, cosX, sinY, cosY, sinZ, cosZ;
+		SinCos<Simd>(Simd::Load(&transforms.rotationX[i]), sinX, cosX);
+		SinCos<Simd>(Simd::Load(&transforms.rotationY[i]), sinY, cosY);
+		SinCos<Simd>(Simd::Load(&transforms.rotationZ[i]), sinZ, cosZ);
+
+		const auto scaleX = Simd::Load(&transforms.scaleX[i]);
+		const auto scaleY = Simd::Load(&transforms.scaleY[i]);
+		const auto scaleZ = Simd::Load(&transforms.scaleZ[i]);
+
+		const auto sinXSinY = Simd::Mul(sinX, sinY);
+		const auto cosXSinY = Simd::Mul(cosX, sinY);
+
+		float* columns[Simd::WIDTH];
+		for (uint32_t lane = 0; lane < Simd::WIDTH; lane++)
+		{
+			columns[lane] = &(*worldMatrices[i + lane])[0][0];
+		}
+
+		Simd::StoreTransposed(
+			Simd::Mul(Simd::Mul(cosY, cosZ), scaleX),
+			Simd::Mul(Simd::Add(Simd::Mul(sinXSinY, cosZ), Simd::Mul(cosX, sinZ)), scaleX),
+			Simd::Mul(Simd::Sub(Simd::Mul(sinX, sinZ), Simd::Mul(cosXSinY, cosZ)), scaleX),
+			zero,
+			columns);
+
+		for (auto& column : columns) { column += 4; }
+		Simd::StoreTransposed(
+			Simd::Mul(Simd::Sub(zero, Simd::Mul(cosY, sinZ)), scaleY),
+			Simd::Mul(Simd::Sub(Simd::Mul(cosX, cosZ), Simd::Mul(sinXSinY, sinZ)), scaleY),
+			Simd::Mul(Simd::Add(Simd::Mul(cosXSinY, sinZ), Simd::Mul(sinX, cosZ)), scaleY),
+			zero,
+			columns);
+
+		for (auto& column : columns) { column += 4; }
+		Simd::StoreTransposed(
+			Simd::Mul(sinY, scaleZ),
+			Simd::Mul(Simd::Sub(zero, Simd::Mul(sinX, cosY)), scaleZ),
+			Simd::Mul(Simd::Mul(cosX, cosY), scaleZ),
+			zero,
+			columns);
+
+		for (auto& column : columns) { column += 4; }
+		Simd::StoreTransposed(
+			Simd::Load(&transforms.positionX[i]),
+			Simd::Load(&transforms.positionY[i]),
+			Simd::Load(&transforms.positionZ[i]),
+			one,
+			columns);
+	}
+
+	return batchedCount;
+}
+#endif
+}
+
+void TransformSoA::Add(const Transform& transform)
+{
+	positionX.push_back(transform.position.x);
+	positionY.push_back(transform.position.y);
+	positionZ.push_back(transform.position.z);
+	rotationX.push_back(transform.rotation.x);
+	rotationY.push_back(transform.rotation.y);
+	rotationZ.push_back(transform.rotation.z);
+	scaleX.push_back(transform.scale.x);
+	scaleY.push_back(transform.scale.y);
+	scaleZ.push_back(transform.scale.z);
+}
+
+void TransformSoA::Reserve(const size_t size)
+{
+	for (auto array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &scaleX, &scaleY, &scaleZ })
+	{
+		array->reserve(size);
+	}
+}
+
+void TransformSoA::Clear()
+{
+	for (auto array : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &scaleX, &scaleY, &scaleZ })
+	{
+		array->clear();
+	}
+}
 
 TransformManager::TransformManager()
 {
-	
+	m_Components.Reserve(INIT_ENTITY_NMB);
 }
 
 void TransformManager::Init() {}
 
-void TransformManager::Update() {}
+void TransformManager::Update()
+{
+	//Only the transforms written since the last frame are recomputed, static geometry keeps its cached matrix
+	m_DirtyTransforms.Clear();
+	m_DirtyWorldMatrices.clear();
+	m_UpdatedTransforms.clear();
+	m_UpdatedEntities.clear();
+
+	for (auto it = m_Components.begin(); it != m_Components.end(); ++it)
+	{
+		if (it->dirty)
+		{
+			m_DirtyTransforms.Add(*it);
+			m_DirtyWorldMatrices.push_back(&it->worldMatrix);
+			m_UpdatedTransforms.push_back(&*it);
+			m_UpdatedEntities.push_back(it.GetEntity());
+		}
+	}
+
+	ComputeWorldMatrices(m_DirtyTransforms, m_DirtyWorldMatrices.data());
+
+	UpdateHierarchy();
+
+	for (auto transform : m_UpdatedTransforms)
+	{
+		transform->dirty = false;
+	}
+}
+
+void TransformManager::UpdateHierarchy()
+{
+	if (!m_IsHierarchySorted)
+	{
+		SortHierarchy();
+	}
+
+	//Dirty children hold their local matrix at this point, clean children are only recomputed under a parent that moved
+	for (const auto& node : m_Hierarchy)
+	{
+		const auto& parentWorldMatrix = node.parentTransform->worldMatrix;
+
+		if (node.transform->dirty)
+		{
+			node.transform->worldMatrix = parentWorldMatrix * node.transform->worldMatrix;
+		}
+		else if (node.parentTransform->dirty)
+		{
+			node.transform->worldMatrix = parentWorldMatrix * ComputeWorldMatrix(*node.transform);
+			node.transform->dirty = true;
+			m_UpdatedTransforms.push_back(node.transform);
+			m_UpdatedEntities.push_back(node.entity);
+		}
+	}
+}
+
+void TransformManager::SortHierarchy()
+{
+	for (auto& node : m_Hierarchy)
+	{
+		node.depth = 0;
+		for (auto ancestor = GetParent(node.parent); ancestor != INVALID_ENTITY; ancestor = GetParent(ancestor))
+		{
+			node.depth++;
+		}
+	}
+
+	std::stable_sort(m_Hierarchy.begin(), m_Hierarchy.end(), [](const HierarchyNode& a, const HierarchyNode& b)
+	{
+		return a.depth < b.depth;
+	});
+
+	for (uint32_t i = 0; i < m_Hierarchy.size(); i++)
+	{
+		m_HierarchyIndices[GetEntityIndex(m_Hierarchy[i].entity)] = i;
+	}
+
+	m_IsHierarchySorted = true;
+}
+
+void TransformManager::SetParent(const Entity child, const Entity parent)
+{
+	const auto childTransform = m_Components.Get(child);
+	if (childTransform == nullptr)
+	{
+		throw std::runtime_error("Impossible to set the parent of an entity without transform");
+	}
+
+	RemoveHierarchyNode(child);
+	childTransform->dirty = true;
+
+	if (parent == INVALID_ENTITY)
+	{
+		return;
+	}
+
+	const auto parentTransform = m_Components.Get(parent);
+	if (parentTransform == nullptr)
+	{
+		throw std::runtime_error("Impossible to attach an entity to a parent without transform");
+	}
+
+	for (auto ancestor = parent; ancestor != INVALID_ENTITY; ancestor = GetParent(ancestor))
+	{
+		if (ancestor == child)
+		{
+			throw std::runtime_error("Impossible to attach an entity to one of its children");
+		}
+	}
+
+	const auto childIndex = GetEntityIndex(child);
+	if (childIndex >= m_HierarchyIndices.size())
+	{
+		m_HierarchyIndices.resize(childIndex + 1, INVALID_NODE);
+	}
+
+	m_HierarchyIndices[childIndex] = static_cast<uint32_t>(m_Hierarchy.size());
+	m_Hierarchy.push_back(HierarchyNode{ child, parent, 0, childTransform, parentTransform });
+	m_IsHierarchySorted = false;
+}
+
+Entity TransformManager::GetParent(const Entity child) const
+{
+	const auto childIndex = GetEntityIndex(child);
+	if (childIndex >= m_HierarchyIndices.size() || m_HierarchyIndices[childIndex] == INVALID_NODE)
+	{
+		return INVALID_ENTITY;
+	}
+
+	return m_Hierarchy[m_HierarchyIndices[childIndex]].parent;
+}
+
+void TransformManager::RemoveHierarchyNode(const Entity entity)
+{
+	const auto entityIndex = GetEntityIndex(entity);
+	if (entityIndex >= m_HierarchyIndices.size() || m_HierarchyIndices[entityIndex] == INVALID_NODE)
+	{
+		return;
+	}
+
+	const auto nodeIndex = m_HierarchyIndices[entityIndex];
+	if (nodeIndex != m_Hierarchy.size() - 1)
+	{
+		m_Hierarchy[nodeIndex] = m_Hierarchy.back();
+		m_HierarchyIndices[GetEntityIndex(m_Hierarchy[nodeIndex].entity)] = nodeIndex;
+	}
+
+	m_Hierarchy.pop_back();
+	m_HierarchyIndices[entityIndex] = INVALID_NODE;
+	m_IsHierarchySorted = false;
+}
 
 Transform* TransformManager::CreateComponent(const Entity entity)
 {
@@ -58,50 +334,91 @@ Transform* TransformManager::CreateComponent(const Entity entity)
 	t.scale.y = 1;
 	t.scale.z = 1;
 
-	m_Components[entity - 1] = t;
-
-	return &m_Components[entity - 1];
+	return m_Components.Insert(entity, t);
 }
 
 Transform* TransformManager::AddComponent(const Entity entity, Transform& component)
 {
-	m_Components[entity - 1] = component;
+	return m_Components.Insert(entity, component);
+}
+
+void TransformManager::DestroyComponent(const Entity entity)
+{
+	//Children of the removed transform become roots, their local transform is now their world transform
+	for (size_t i = 0; i < m_Hierarchy.size();)
+	{
+		if (m_Hierarchy[i].parent == entity)
+		{
+			m_Hierarchy[i].transform->dirty = true;
+			RemoveHierarchyNode(m_Hierarchy[i].entity);
+		}
+		else
+		{
+			i++;
+		}
+	}
 
-	return &m_Components[entity - 1];
+	RemoveHierarchyNode(entity);
+	m_Components.Remove(entity);
 }
 
-void TransformManager::DestroyComponent(Entity entity) { }
+void TransformManager::Clear()
+{
+	m_Hierarchy.clear();
+	m_HierarchyIndices.clear();
+	m_IsHierarchySorted = true;
+	m_UpdatedTransforms.clear();
+	m_UpdatedEntities.clear();
+	m_Components.Clear();
+}
 
-glm::mat4x4 TransformManager::GetWorldMatrix(Transform& component) 
+glm::mat4x4 TransformManager::ComputeWorldMatrix(const Transform& component)
 {
-	component.worldMatrix = glm::mat4x4(1.0f);
-	component.worldMatrix = glm::translate(component.worldMatrix, component.position);
-	component.worldMatrix = glm::rotate(component.worldMatrix, component.rotation.x, glm::vec3(1, 0, 0));
-	component.worldMatrix = glm::rotate(component.worldMatrix, component.rotation.y, glm::vec3(0, 1, 0));
-	component.worldMatrix = glm::rotate(component.worldMatrix, component.rotation.z, glm::vec3(0, 0, 1));
-	component.worldMatrix = glm::scale(component.worldMatrix, component.scale);
-	return component.worldMatrix;
+	auto worldMatrix = glm::mat4x4(1.0f);
+	worldMatrix = glm::translate(worldMatrix, component.position);
+	worldMatrix = glm::rotate(worldMatrix, component.rotation.x, glm::vec3(1, 0, 0));
+	worldMatrix = glm::rotate(worldMatrix, component.rotation.y, glm::vec3(0, 1, 0));
+	worldMatrix = glm::rotate(worldMatrix, component.rotation.z, glm::vec3(0, 0, 1));
+	worldMatrix = glm::scale(worldMatrix, component.scale);
+	return worldMatrix;
+}
+
+void TransformManager::ComputeWorldMatrices(const TransformSoA& transforms, glm::mat4x4* const* worldMatrices)
+{
+	size_t computedCount = 0;
+
+#ifdef DM_SIMD_ENABLED
+	computedCount = ComputeWorldMatricesSimd<SimdNative>(transforms, worldMatrices);
+#endif
+
+	for (auto i = computedCount; i < transforms.Size(); i++)
+	{
+		ComputeWorldMatrixScalar(transforms, i, *worldMatrices[i]);
+	}
 }
 
 void TransformManager::OnDrawInspector(Entity entity)
 {
 	ImGui::Separator();
 	ImGui::TextWrapped("Transform");
-	ImGui::DragFloat3("Position", &m_Components[entity - 1].position[0], 0.1f);
-	ImGui::DragFloat3("Rotation", &m_Components[entity - 1].rotation[0], 0.1f);
-	ImGui::DragFloat3("Scale", &m_Components[entity - 1].scale[0], 0.1f);
+	auto changed = ImGui::DragFloat3("Position", &m_Components.Get(entity)->position[0], 0.1f);
+	changed |= ImGui::DragFloat3("Rotation", &m_Components.Get(entity)->rotation[0], 0.1f);
+	changed |= ImGui::DragFloat3("Scale", &m_Components.Get(entity)->scale[0], 0.1f);
 
-	m_Components[entity - 1].worldMatrix = GetWorldMatrix(m_Components[entity - 1]);
+	if (changed)
+	{
+		m_Components.Get(entity)->dirty = true;
+	}
 
 	auto camera = Engine::Get()->GetGraphicManager()->GetCamera();
-	glm::mat4x4 model = m_Components[entity - 1].worldMatrix;
+	glm::mat4x4 model = m_Components.Get(entity)->worldMatrix;
 
 	ImGuizmo::BeginFrame();
 	ImGuiIO& io = ImGui::GetIO();
 	ImGuizmo::SetRect(0, 0, io.DisplaySize.x, io.DisplaySize.y);
-	//ImGuizmo::Manipulate(&camera->viewMatrix[0][0], &camera->projectionMatrix[0][0], ImGuizmo::TRANSLATE, ImGuizmo::LOCAL, &m_Components[entity - 1].worldMatrix[0][0], NULL, NULL);
+	//ImGuizmo::Manipulate(&camera->viewMatrix[0][0], &camera->projectionMatrix[0][0], ImGuizmo::TRANSLATE, ImGuizmo::LOCAL, &m_Components.Get(entity)->worldMatrix[0][0], NULL, NULL);
 
-	//ImGuizmo::DecomposeMatrixToComponents(&m_Components[entity - 1].worldMatrix[0][0], &m_Components[entity - 1].position[0], &m_Components[entity - 1].rotation[0], &m_Components[entity - 1].scale[0]);
+	//ImGuizmo::DecomposeMatrixToComponents(&m_Components.Get(entity)->worldMatrix[0][0], &m_Components.Get(entity)->position[0], &m_Components.Get(entity)->rotation[0], &m_Components.Get(entity)->scale[0]);
 }
 
 void TransformManager::DecodeComponent(json& componentJson, Entity entity)
@@ -117,15 +434,15 @@ void TransformManager::DecodeComponent(json& componentJson, Entity entity)
 	if (CheckJsonExists(componentJson, "rotation"))
 		transform.rotation = GetVector3FromJson(componentJson, "rotation");
 
-	m_Components[entity - 1] = transform;
+	m_Components.Insert(entity, transform);
 }
 
 void TransformManager::EncodeComponent(json& componentJson, const Entity entity)
 {
 	componentJson["type"] = ComponentType::TRANSFORM;
 
-	SetVector3ToJson(componentJson, "position", m_Components[entity - 1].position);
-	SetVector3ToJson(componentJson, "scale", m_Components[entity - 1].scale);
-	SetVector3ToJson(componentJson, "rotation", m_Components[entity - 1].rotation);
+	SetVector3ToJson(componentJson, "position", m_Components.Get(entity)->position);
+	SetVector3ToJson(componentJson, "scale", m_Components.Get(entity)->scale);
+	SetVector3ToJson(componentJson, "rotation", m_Components.Get(entity)->rotation);
 }
 }
@@ -226,6 +226,22 @@ void Editor::DrawStats()
 		std::string fps = "FPS : ";
 		fps += std::to_string(1 / lastDeltaTime);
 		ImGui::Text(fps.c_str());
+
+		dm::DrawStats drawStats;
+		for (const auto& [stage, renderers] : GraphicManager::Get()->GetRendererContainer()->GetStages())
+		{
+			for (const auto& renderer : renderers)
+			{
+				if (renderer->IsEnabled() && renderer->GetDrawStats() != nullptr)
+				{
+					drawStats += *renderer->GetDrawStats();
+				}
+			}
+		}
+
+		ImGui::Text("Draws / instances : %u / %u", drawStats.drawCount, drawStats.instanceCount);
+		ImGui::Text("Binds (pipeline / descriptor / mesh) : %u / %u / %u", drawStats.pipelineBinds, drawStats.descriptorBinds, drawStats.meshBinds);
+		ImGui::Text("Saved state changes : %u", drawStats.savedStateChanges);
 		ImGui::EndMenu();
 	}
 }
@@ -86,10 +86,13 @@ void EditorRenderManager::Start()
 	auto &rendererContainer = GetRendererContainer();
 	rendererContainer.Clear();
 
-	rendererContainer.Add<RendererDirectionalShadow>(Pipeline::Stage(0, 0));
+	const auto& settings = Engine::Get()->GetSettings();
+
+	rendererContainer.Add<RendererDirectionalShadow>(Pipeline::Stage(0, 0))->SetInstanced(settings.instancedMeshes);
 
 	rendererContainer.Add<RendererTerrain>(Pipeline::Stage(1, 0));
-	rendererContainer.Add<RendererMeshes>(Pipeline::Stage(1, 0));
+	auto rendererMeshes = rendererContainer.Add<RendererMeshes>(Pipeline::Stage(1, 0));
+	rendererMeshes->SetGpuDriven(settings.gpuDrivenMeshes);
 	rendererContainer.Add<RendererMeshesPBR>(Pipeline::Stage(1, 0));
 
 	rendererContainer.Add<FilterSsao>(Pipeline::Stage(1, 1));
@@ -115,6 +115,11 @@ PipelineMaterialManager* Engine::GetPipelineMaterialManager() const
 	return m_ModuleContainer.GetPipelineMaterialManager();
 }
 
+JobSystem* Engine::GetJobSystem() const
+{
+	return m_ModuleContainer.GetJobSystem();
+}
+
 void Engine::SetApplication(EngineApplication* app)
 {
 	m_App.reset(app);
@@ -0,0 +1,381 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <engine/job_system.h>
+
+namespace dm
+{
+namespace
+{
+thread_local JobSystem* s_CurrentJobSystem = nullptr;
+thread_local size_t s_DequeIndex = 0;
+}
+
+JobDeque::JobDeque() :
+	m_Top(0),
+	m_Bottom(0)
+{
+	for (auto& job : m_Buffer)
+	{
+		job.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+bool JobDeque::Push(Job* job)
+{
+	const auto bottom = m_Bottom.load(std::memory_order_relaxed);
+	const auto top = m_Top.load(std::memory_order_acquire);
+
+	if (bottom - top >= CAPACITY)
+	{
+		return false;
+	}
+
+	m_Buffer[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+	m_Bottom.store(bottom + 1, std::memory_order_release);
+
+	return true;
+}
+
+Job* JobDeque::Pop()
+{
+	const auto bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto top = m_Top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		//Empty
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto job = m_Buffer[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+	if (top == bottom)
+	{
+		//Last job, race against the thieves
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+Job* JobDeque::Steal()
+{
+	auto top = m_Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const auto bottom = m_Bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+
+	const auto job = m_Buffer[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return job;
+}
+
+JobSystem::JobSystem(const size_t workerNmb) :
+	m_WorkerNmb(workerNmb),
+	m_Running(false),
+	m_PendingJobs(0),
+	m_QueuedJobs(0)
+{
+	if (m_WorkerNmb == 0)
+	{
+		const auto hardwareThreads = std::thread::hardware_concurrency();
+		m_WorkerNmb = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	Clear();
+
+	m_Running = false;
+	m_SleepCondition.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+
+	if (s_CurrentJobSystem == this)
+	{
+		s_CurrentJobSystem = nullptr;
+	}
+}
+
+void JobSystem::Init()
+{
+	if (m_Running)
+	{
+		return;
+	}
+
+	m_Running = true;
+
+	m_Deques.reserve(m_WorkerNmb + 1);
+	for (size_t i = 0; i < m_WorkerNmb + 1; i++)
+	{
+		m_Deques.push_back(std::make_unique<JobDeque>());
+	}
+
+	s_CurrentJobSystem = this;
+	s_DequeIndex = 0;
+
+	m_Workers.reserve(m_WorkerNmb);
+	for (size_t i = 0; i < m_WorkerNmb; i++)
+	{
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+	}
+}
+
+void JobSystem::Update()
+{
+}
+
+void JobSystem::Clear()
+{
+	//Finish every job in flight, nothing may still reference the cleared modules
+	while (m_PendingJobs.load(std::memory_order_acquire) > 0)
+	{
+		const auto job = FindJob();
+		if (job != nullptr)
+		{
+			Execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::Draw()
+{
+}
+
+void JobSystem::Schedule(std::function<void()> function, JobCounter* counter)
+{
+	if (counter != nullptr)
+	{
+		counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Enqueue(new Job{ std::move(function), counter });
+}
+
+void JobSystem::ScheduleAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter)
+{
+	//Counted now so waiting on the counter also waits for the continuation
+	if (counter != nullptr)
+	{
+		counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+		if (dependency.m_Value.load(std::memory_order_relaxed) != 0)
+		{
+			dependency.m_Continuations.emplace_back(std::move(function), counter);
+			return;
+		}
+	}
+
+	Enqueue(new Job{ std::move(function), counter });
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		const auto job = FindJob();
+		if (job != nullptr)
+		{
+			Execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::WorkerLoop(const size_t workerIndex)
+{
+	s_CurrentJobSystem = this;
+	s_DequeIndex = workerIndex;
+
+	while (m_Running)
+	{
+		const auto job = FindJob();
+		if (job != nullptr)
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_SleepCondition.wait_for(lock, std::chrono::milliseconds(1), [this]()
+		{
+			return m_QueuedJobs.load(std::memory_order_relaxed) > 0 || !m_Running;
+		});
+	}
+}
+
+Job* JobSystem::FindJob()
+{
+	if (m_QueuedJobs.load(std::memory_order_relaxed) <= 0)
+	{
+		return nullptr;
+	}
+
+	const auto job = TakeJob();
+	if (job != nullptr)
+	{
+		m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+Job* JobSystem::TakeJob()
+{
+	const auto ownIndex = s_CurrentJobSystem == this ? s_DequeIndex : 0;
+
+	if (s_CurrentJobSystem == this)
+	{
+		const auto job = m_Deques[ownIndex]->Pop();
+		if (job != nullptr)
+		{
+			return job;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_GlobalMutex);
+		if (!m_GlobalQueue.empty())
+		{
+			const auto job = m_GlobalQueue.front();
+			m_GlobalQueue.pop_front();
+			return job;
+		}
+	}
+
+	//Steal starting from the next deque so the thieves don't all hit the same victim
+	for (size_t i = 1; i < m_Deques.size() + 1; i++)
+	{
+		const auto victim = (ownIndex + i) % m_Deques.size();
+		const auto job = m_Deques[victim]->Steal();
+		if (job != nullptr)
+		{
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void JobSystem::Enqueue(Job* job)
+{
+	if (!m_Running)
+	{
+		//Job system not initialized, run inline
+		m_PendingJobs.fetch_add(1, std::memory_order_relaxed);
+		Execute(job);
+		return;
+	}
+
+	m_PendingJobs.fetch_add(1, std::memory_order_relaxed);
+
+	//Counted before the push, a thief taking the job right away must not bring the count below zero
+	m_QueuedJobs.fetch_add(1, std::memory_order_relaxed);
+
+	if (s_CurrentJobSystem == this)
+	{
+		if (!m_Deques[s_DequeIndex]->Push(job))
+		{
+			//Deque full, run it now instead of growing
+			m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			Execute(job);
+			return;
+		}
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(m_GlobalMutex);
+		m_GlobalQueue.push_back(job);
+	}
+
+	m_SleepCondition.notify_one();
+}
+
+void JobSystem::Execute(Job* job)
+{
+	job->function();
+
+	const auto counter = job->counter;
+	delete job;
+
+	Finish(counter);
+
+	m_PendingJobs.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::Finish(JobCounter* counter)
+{
+	if (counter == nullptr)
+	{
+		return;
+	}
+
+	std::vector<std::pair<std::function<void()>, JobCounter*>> continuations;
+	{
+		std::lock_guard<std::mutex> lock(counter->m_Mutex);
+		if (counter->m_Value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		continuations.swap(counter->m_Continuations);
+	}
+
+	for (auto& continuation : continuations)
+	{
+		Enqueue(new Job{ std::move(continuation.first), continuation.second });
+	}
+}
+}
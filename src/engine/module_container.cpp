@@ -31,6 +31,7 @@ SOFTWARE.
 #include <graphics/mesh_manager.h>
 #include <physic/physic_manager.h>
 #include <graphics/pipeline_material_manager.h>
+#include <engine/job_system.h>
 
 namespace dm
 {
@@ -40,6 +41,8 @@ ModuleContainer::ModuleContainer()
 
 ModuleContainer::~ModuleContainer()
 {
+	//Workers are joined first, no job may run while the other modules are destroyed
+	delete(m_JobSystem);
 	delete(m_GraphicManager);
 	delete(m_InputManager);
 	delete(m_EntityManager);
@@ -52,6 +55,7 @@ ModuleContainer::~ModuleContainer()
 
 void ModuleContainer::Init()
 {
+	m_JobSystem = new JobSystem();
 	m_GraphicManager = new GraphicManager();
 	m_InputManager = new InputManager();
 	m_EntityManager = new EntityManager();
@@ -61,6 +65,7 @@ void ModuleContainer::Init()
 	m_PhysicManager = new PhysicManager();
 	m_PipelineMaterialManager = new PipelineMaterialManager();
 
+	m_JobSystem->Init();
 	m_GraphicManager->Init();
 	m_InputManager->Init();
 	m_EntityManager->Init();
@@ -72,9 +77,12 @@ void ModuleContainer::Init()
 
 void ModuleContainer::Update() 
 {
+	//World matrices written during the last frame are refreshed before the renderers read them
+	m_ComponentManager->Update();
 	m_GraphicManager->Update();
 	m_InputManager->Update();
 	m_SystemManager->Update();
+	m_EntityManager->PlaybackCommandBuffers();
 	m_PhysicManager->Update();
 }
 
@@ -85,6 +93,7 @@ void ModuleContainer::Draw()
 
 void ModuleContainer::Clear()
 {
+	m_JobSystem->Clear();
 	m_GraphicManager->Clear();
 	m_InputManager->Clear();
 	m_EntityManager->Clear();
@@ -129,4 +138,9 @@ PipelineMaterialManager* ModuleContainer::GetPipelineMaterialManager() const
 {
 	return m_PipelineMaterialManager;
 }
+
+JobSystem* ModuleContainer::GetJobSystem() const
+{
+	return m_JobSystem;
+}
 }
@@ -547,8 +547,9 @@ void PrefabFactor::CreateTerrainPrefab(glm::vec3 pos)
 	//Bounding sphere
 	rock1.AddComponent<BoundingSphere>(BoundingSphereManager::GetBoundingSphere(*mesh.model));
 
-	//Drawable
-	rock1.CreateComponent<Drawable>(ComponentType::DRAWABLE);
+	//Drawable, the mountain hides most of the valley behind it
+	auto drawable = rock1.CreateComponent<Drawable>(ComponentType::DRAWABLE);
+	drawable->isOccluder = true;
 
 	//MeshRenderer
 	rock1.CreateComponent<MeshRenderer>(ComponentType::MESH_RENDERER);
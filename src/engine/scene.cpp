@@ -27,6 +27,8 @@ SOFTWARE.
 #include "editor/log.h"
 #include "entity/entity_handle.h"
 
+#include <unordered_map>
+
 namespace dm
 {
 SceneManager::SceneManager()
@@ -98,17 +100,19 @@ void SceneManager::LoadSceneFromJson(json& sceneJson)
 	if (CheckJsonParameter(sceneJson, "entities", json::value_t::array))
 	{
 		const auto entityNmb = sceneJson["entities"].size();
-		if (entityNmb > INIT_ENTITY_NMB)
-		{
-			Debug::Log("Resize entity to => " + entityNmb);
-			m_EntityManager->ResizeEntity(entityNmb);
-		}
 
-		for (auto& entityJson : sceneJson["entities"])
+		//Entities are allocated in one batch
+		const auto loadedEntities = m_EntityManager->CreateEntities(entityNmb);
+
+		//The components are decoded first, entities sharing a mask are then attached with a single AddComponents
+		std::vector<ComponentMask> masks;
+		std::vector<std::vector<Entity>> maskEntities;
+		std::unordered_map<ComponentMask, size_t, ComponentMaskHash> maskIndices;
+
+		for (size_t entityIndex = 0; entityIndex < entityNmb; entityIndex++)
 		{
-			Entity entity = INVALID_ENTITY;
-			entity = m_EntityManager->CreateEntity();
-			EntityHandle handle = EntityHandle(entity);
+			auto& entityJson = sceneJson["entities"][entityIndex];
+			const auto entity = loadedEntities[entityIndex];
 
 			//Entity infos
 			//TODO ajouter un component de debug si l'engine est en mode editor
@@ -126,6 +130,8 @@ void SceneManager::LoadSceneFromJson(json& sceneJson)
 
 			if (entity != INVALID_ENTITY && CheckJsonExists(entityJson, "components"))
 			{
+				ComponentMask mask;
+
 				for (auto& componentJson : entityJson["components"])
 				{
 					if (CheckJsonExists(componentJson, "type"))
@@ -133,8 +139,7 @@ void SceneManager::LoadSceneFromJson(json& sceneJson)
 						const ComponentType componentType = componentJson["type"];
 						
 						m_ComponentManager->DecodeComponent(componentJson, entity, componentType);
-						handle.AddComponentType(componentType);
-						
+						mask.AddComponent(componentType);
 					}
 					else
 					{
@@ -143,6 +148,14 @@ void SceneManager::LoadSceneFromJson(json& sceneJson)
 						Debug::Log(oss.str());
 					}
 				}
+
+				const auto [it, inserted] = maskIndices.emplace(mask, masks.size());
+				if (inserted)
+				{
+					masks.push_back(mask);
+					maskEntities.emplace_back();
+				}
+				maskEntities[it->second].push_back(entity);
 			}
 			else
 			{
@@ -151,8 +164,12 @@ void SceneManager::LoadSceneFromJson(json& sceneJson)
 				Debug::Log(oss.str());
 			}
 		}
-	}
 
+		for (size_t i = 0; i < masks.size(); i++)
+		{
+			m_EntityManager->AddComponents(maskEntities[i], masks[i]);
+		}
+	}
 }
 
 void SceneManager::SaveScene()
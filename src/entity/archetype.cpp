@@ -0,0 +1,353 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <entity/archetype.h>
+#include <stdexcept>
+#include <algorithm>
+
+namespace dm
+{
+namespace
+{
+size_t AlignOffset(const size_t offset, const size_t alignment)
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+}
+
+Archetype::Archetype(
+	const ComponentMask mask,
+	const std::vector<ComponentType>& componentTypes,
+	const std::array<ArchetypeComponentInfo, static_cast<int>(ComponentType::LENGTH)>& infos) :
+	m_Mask(mask),
+	m_ComponentTypes(componentTypes),
+	m_EntitiesOffset(0),
+	m_ChunkCapacity(0),
+	m_EntityCount(0)
+{
+	m_ColumnIndex.fill(-1);
+
+	size_t rowSize = sizeof(Entity);
+	for (size_t i = 0; i < m_ComponentTypes.size(); i++)
+	{
+		const auto& info = infos[static_cast<int>(m_ComponentTypes[i])];
+		if (info.size == 0)
+		{
+			throw std::runtime_error("Component type not registered in the archetype storage");
+		}
+
+		m_ColumnIndex[static_cast<int>(m_ComponentTypes[i])] = static_cast<int>(i);
+		m_Infos.push_back(info);
+		rowSize += info.size;
+	}
+
+	//Columns are aligned on cache lines, the capacity is reduced until the padding fits in the chunk
+	m_ColumnOffsets.resize(m_Infos.size());
+	m_ChunkCapacity = static_cast<uint32_t>(ARCHETYPE_CHUNK_SIZE / rowSize);
+	while (m_ChunkCapacity > 0)
+	{
+		size_t offset = m_ChunkCapacity * sizeof(Entity);
+		for (size_t i = 0; i < m_Infos.size(); i++)
+		{
+			offset = AlignOffset(offset, std::max<size_t>(m_Infos[i].alignment, 64));
+			m_ColumnOffsets[i] = offset;
+			offset += m_ChunkCapacity * m_Infos[i].size;
+		}
+
+		if (offset <= ARCHETYPE_CHUNK_SIZE)
+		{
+			break;
+		}
+
+		m_ChunkCapacity--;
+	}
+
+	if (m_ChunkCapacity == 0)
+	{
+		throw std::runtime_error("Archetype row does not fit in a chunk");
+	}
+}
+
+Archetype::~Archetype()
+{
+	for (uint32_t row = 0; row < m_EntityCount; row++)
+	{
+		for (size_t column = 0; column < m_Infos.size(); column++)
+		{
+			m_Infos[column].destruct(GetElement(row, column));
+		}
+	}
+}
+
+uint32_t Archetype::Add(const Entity entity)
+{
+	if (m_EntityCount == m_Chunks.size() * m_ChunkCapacity)
+	{
+		m_Chunks.push_back(std::make_unique<ArchetypeChunk>());
+	}
+
+	const auto row = m_EntityCount;
+	m_EntityCount++;
+
+	GetEntities(row / m_ChunkCapacity)[row % m_ChunkCapacity] = entity;
+	for (size_t column = 0; column < m_Infos.size(); column++)
+	{
+		m_Infos[column].construct(GetElement(row, column));
+	}
+
+	return row;
+}
+
+Entity Archetype::Remove(const uint32_t row)
+{
+	const auto lastRow = m_EntityCount - 1;
+	auto movedEntity = INVALID_ENTITY;
+
+	if (row != lastRow)
+	{
+		movedEntity = GetEntities(lastRow / m_ChunkCapacity)[lastRow % m_ChunkCapacity];
+		GetEntities(row / m_ChunkCapacity)[row % m_ChunkCapacity] = movedEntity;
+
+		for (size_t column = 0; column < m_Infos.size(); column++)
+		{
+			m_Infos[column].move(GetElement(row, column), GetElement(lastRow, column));
+		}
+	}
+
+	for (size_t column = 0; column < m_Infos.size(); column++)
+	{
+		m_Infos[column].destruct(GetElement(lastRow, column));
+	}
+
+	m_EntityCount--;
+
+	//Keep one empty chunk to avoid allocating again when an entity oscillates at the chunk border
+	if (m_Chunks.size() > 1 && m_EntityCount <= (m_Chunks.size() - 2) * m_ChunkCapacity)
+	{
+		m_Chunks.pop_back();
+	}
+
+	return movedEntity;
+}
+
+void* Archetype::GetComponent(const uint32_t row, const ComponentType componentType) const
+{
+	const auto column = m_ColumnIndex[static_cast<int>(componentType)];
+	if (column < 0)
+	{
+		return nullptr;
+	}
+
+	return GetElement(row, column);
+}
+
+void* Archetype::GetColumn(const size_t chunkIndex, const ComponentType componentType) const
+{
+	const auto column = m_ColumnIndex[static_cast<int>(componentType)];
+	if (column < 0)
+	{
+		return nullptr;
+	}
+
+	return m_Chunks[chunkIndex]->data + m_ColumnOffsets[column];
+}
+
+Entity* Archetype::GetEntities(const size_t chunkIndex) const
+{
+	return reinterpret_cast<Entity*>(m_Chunks[chunkIndex]->data + m_EntitiesOffset);
+}
+
+uint32_t Archetype::GetChunkEntityCount(const size_t chunkIndex) const
+{
+	const auto first = static_cast<uint32_t>(chunkIndex) * m_ChunkCapacity;
+	if (m_EntityCount <= first)
+	{
+		return 0;
+	}
+
+	return std::min(m_EntityCount - first, m_ChunkCapacity);
+}
+
+void* Archetype::GetElement(const uint32_t row, const size_t column) const
+{
+	return m_Chunks[row / m_ChunkCapacity]->data + m_ColumnOffsets[column] + (row % m_ChunkCapacity) * m_Infos[column].size;
+}
+
+ArchetypeStorage::ArchetypeStorage() = default;
+
+ArchetypeStorage::~ArchetypeStorage() = default;
+
+void* ArchetypeStorage::AddComponent(const Entity entity, const ComponentType componentType)
+{
+	const auto index = GetEntityIndex(entity);
+	if (index >= m_EntityLocations.size())
+	{
+		m_EntityLocations.resize(index + 1);
+	}
+
+	auto mask = ComponentMask();
+	if (m_EntityLocations[index].archetype != nullptr)
+	{
+		if (m_EntityLocations[index].archetype->HasComponent(componentType))
+		{
+			const auto& location = m_EntityLocations[index];
+			return location.archetype->GetComponent(location.row, componentType);
+		}
+
+		mask = m_EntityLocations[index].archetype->GetMask();
+	}
+	mask.AddComponent(componentType);
+
+	MoveEntity(entity, mask);
+
+	const auto& location = m_EntityLocations[index];
+	return location.archetype->GetComponent(location.row, componentType);
+}
+
+void ArchetypeStorage::RemoveComponent(const Entity entity, const ComponentType componentType)
+{
+	if (!HasComponent(entity, componentType))
+	{
+		return;
+	}
+
+	auto mask = m_EntityLocations[GetEntityIndex(entity)].archetype->GetMask();
+	mask.RemoveComponent(componentType);
+
+	MoveEntity(entity, mask);
+}
+
+void ArchetypeStorage::RemoveEntity(const Entity entity)
+{
+	const auto index = GetEntityIndex(entity);
+	if (index >= m_EntityLocations.size() || m_EntityLocations[index].archetype == nullptr)
+	{
+		return;
+	}
+
+	MoveEntity(entity, ComponentMask());
+}
+
+bool ArchetypeStorage::HasComponent(const Entity entity, const ComponentType componentType) const
+{
+	const auto index = GetEntityIndex(entity);
+	if (index >= m_EntityLocations.size() || m_EntityLocations[index].archetype == nullptr)
+	{
+		return false;
+	}
+
+	return m_EntityLocations[index].archetype->HasComponent(componentType);
+}
+
+void* ArchetypeStorage::GetComponent(const Entity entity, const ComponentType componentType) const
+{
+	const auto index = GetEntityIndex(entity);
+	if (index >= m_EntityLocations.size() || m_EntityLocations[index].archetype == nullptr)
+	{
+		return nullptr;
+	}
+
+	const auto& location = m_EntityLocations[index];
+	return location.archetype->GetComponent(location.row, componentType);
+}
+
+void ArchetypeStorage::Clear()
+{
+	m_ArchetypeMap.clear();
+	m_Archetypes.clear();
+	m_EntityLocations.clear();
+}
+
+Archetype* ArchetypeStorage::GetOrCreateArchetype(const ComponentMask mask)
+{
+	const auto it = m_ArchetypeMap.find(mask);
+	if (it != m_ArchetypeMap.end())
+	{
+		return it->second;
+	}
+
+	std::vector<ComponentType> componentTypes;
+	for (int i = 1; i < static_cast<int>(ComponentType::LENGTH); i++)
+	{
+		if (mask.HasComponent(static_cast<ComponentType>(i)))
+		{
+			componentTypes.push_back(static_cast<ComponentType>(i));
+		}
+	}
+
+	m_Archetypes.push_back(std::make_unique<Archetype>(mask, componentTypes, m_ComponentInfos));
+	m_ArchetypeMap[mask] = m_Archetypes.back().get();
+
+	return m_Archetypes.back().get();
+}
+
+void ArchetypeStorage::MoveEntity(const Entity entity, const ComponentMask newMask)
+{
+	auto& location = m_EntityLocations[GetEntityIndex(entity)];
+	const auto oldArchetype = location.archetype;
+	const auto oldRow = location.row;
+
+	//Same archetype, the row would be removed under the entity
+	if (oldArchetype != nullptr && oldArchetype->GetMask() == newMask)
+	{
+		return;
+	}
+
+	Archetype* newArchetype = nullptr;
+	uint32_t newRow = 0;
+
+	if (!newMask.IsEmpty())
+	{
+		newArchetype = GetOrCreateArchetype(newMask);
+		newRow = newArchetype->Add(entity);
+
+		if (oldArchetype != nullptr)
+		{
+			for (const auto componentType : oldArchetype->GetComponentTypes())
+			{
+				if (!newArchetype->HasComponent(componentType))
+				{
+					continue;
+				}
+
+				m_ComponentInfos[static_cast<int>(componentType)].move(
+					newArchetype->GetComponent(newRow, componentType),
+					oldArchetype->GetComponent(oldRow, componentType));
+			}
+		}
+	}
+
+	if (oldArchetype != nullptr)
+	{
+		const auto movedEntity = oldArchetype->Remove(oldRow);
+		if (movedEntity != INVALID_ENTITY)
+		{
+			m_EntityLocations[GetEntityIndex(movedEntity)].row = oldRow;
+		}
+	}
+
+	location.archetype = newArchetype;
+	location.row = newRow;
+}
+}
@@ -24,24 +24,25 @@ SOFTWARE.
 
 #include <entity/entity.h>
 #include <string>
+#include <algorithm>
+#include <unordered_map>
 #include <component/component_manager.h>
 #include <system/system_manager.h>
 #include "engine/engine.h"
-#include <editor/editor.h>
+#include <entity/entity_command_buffer.h>
+#include <entity/entity_query.h>
 
 namespace dm
 {
-class Editor;
-
-EntityManager::EntityManager()
+EntityManager::EntityManager() :
+	m_QueryCache(std::make_unique<EntityQueryCache>())
 {
-	ComponentMask emptyMask;
-	emptyMask.mask = static_cast<int>(ComponentType::NONE);
-
-	m_EntityInfos.resize(INIT_ENTITY_NMB, INVALID_ENTITY);
-	m_EntityMask.resize(INIT_ENTITY_NMB, emptyMask);
+	m_EntityInfos.reserve(INIT_ENTITY_NMB);
+	m_EntityMask.resize(INIT_ENTITY_NMB);
 }
 
+EntityManager::~EntityManager() = default;
+
 void EntityManager::Init()
 {
 }
@@ -52,8 +53,18 @@ void EntityManager::Update()
 
 void EntityManager::Clear()
 {
-	m_EntityInfos.resize(INIT_ENTITY_NMB);
-	m_EntityMask.resize(INIT_ENTITY_NMB);
+	m_EntityInfos.clear();
+	m_EntityMask.assign(INIT_ENTITY_NMB, ComponentMask());
+	m_QueryCache->Clear();
+
+	m_FreeEntityIndex = INVALID_ENTITY_INDEX;
+	m_EntityCount = 0;
+
+	std::lock_guard<std::mutex> lock(m_CommandBufferMutex);
+	for (auto& commandBuffer : m_CommandBuffers)
+	{
+		commandBuffer->Clear();
+	}
 }
 
 void EntityManager::Draw()
@@ -62,99 +73,275 @@ void EntityManager::Draw()
 
 Entity EntityManager::CreateEntity()
 {
-	auto newEntity = INVALID_ENTITY;
+	Entity newEntity;
 
-	//Add a new entity if vector not full
-	if(m_LastEntity < m_EntityInfos.size())
+	if(m_FreeEntityIndex != INVALID_ENTITY_INDEX) //Recycle the first free slot
 	{
-		m_EntityInfos[m_LastEntity] = m_LastEntity + 1;
-		newEntity = m_EntityInfos[m_LastEntity];
+		const auto index = m_FreeEntityIndex;
+		const auto freeSlot = m_EntityInfos[index];
+
+		m_FreeEntityIndex = GetEntityIndex(freeSlot);
+
+		newEntity = MakeEntity(index, GetEntityGeneration(freeSlot));
+		m_EntityInfos[index] = newEntity;
+	}
+	else //Add a new slot at the end
+	{
+		const auto index = static_cast<EntityIndex>(m_EntityInfos.size());
+
+		if(index >= INVALID_ENTITY_INDEX)
+		{
+			throw std::runtime_error("Maximum number of entities reached: " + std::to_string(index));
+		}
 
-		m_LastEntity++;
-		if (m_LastEntity == m_EntityInfos.size()) //Resize vector if it's full
+		if (index >= m_EntityMask.size()) //Resize masks and components if they are full
 		{
 			ResizeEntity();
 		}
-		else if (m_EntityInfos[m_LastEntity] != INVALID_ENTITY) //Find next free index
+
+		newEntity = MakeEntity(index, 0);
+		m_EntityInfos.push_back(newEntity);
+	}
+
+	m_EntityCount++;
+
+	return newEntity;
+}
+
+std::vector<Entity> EntityManager::CreateEntities(const size_t count)
+{
+	std::vector<Entity> entities;
+	entities.reserve(count);
+
+	//Free slots are recycled first, only the remaining entities need new slots
+	const auto freeSlotNmb = m_EntityInfos.size() - m_EntityCount;
+	if (count > freeSlotNmb)
+	{
+		const auto requiredSize = m_EntityInfos.size() + count - freeSlotNmb;
+		if (requiredSize > m_EntityMask.size())
 		{
-			for(int i = m_LastEntity; i < m_EntityInfos.size(); i++)
+			ResizeEntity(std::max(requiredSize, m_EntityMask.size() * 2));
+		}
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		entities.push_back(CreateEntity());
+	}
+
+	return entities;
+}
+
+void EntityManager::AddComponents(const std::vector<Entity>& entities, const ComponentMask mask)
+{
+	auto componentManager = Engine::Get()->GetComponentManager();
+	componentManager->ReserveComponents(mask, entities.size());
+
+	for (auto componentIndex = 1; componentIndex < static_cast<int>(ComponentType::LENGTH); componentIndex++)
+	{
+		const auto componentType = static_cast<ComponentType>(componentIndex);
+
+		ComponentMask componentMask;
+		componentMask.AddComponent(componentType);
+		if (!mask.Matches(componentMask))
+		{
+			continue;
+		}
+
+		//Components already decoded in their manager, e.g. by the scene loader, are kept
+		for (auto entity : entities)
+		{
+			if (componentManager->GetComponent(entity, componentType) == nullptr)
 			{
-				if(m_EntityInfos[i] == INVALID_ENTITY)
-				{
-					m_LastEntity = i;
-					break;
-				}
+				componentManager->CreateComponent(entity, componentType);
 			}
 		}
 	}
-	else //Resize the vector
+
+	//Entities sharing their old mask share their new signature, the query caches are updated once per group
+	std::unordered_map<ComponentMask, std::vector<Entity>, ComponentMaskHash> groups;
+	for (auto entity : entities)
 	{
-		ResizeEntity();
+		groups[m_EntityMask[GetEntityIndex(entity)]].push_back(entity);
+	}
 
-		m_EntityInfos[m_LastEntity] = m_LastEntity + 1;
-		newEntity = m_EntityInfos[m_LastEntity];
+	for (const auto& [oldMask, group] : groups)
+	{
+		auto newMask = oldMask;
+		newMask |= mask;
+		if (newMask == oldMask)
+		{
+			continue;
+		}
 
-		m_LastEntity++;
+		for (auto entity : group)
+		{
+			m_EntityMask[GetEntityIndex(entity)] = newMask;
+		}
+		m_QueryCache->OnMasksChanged(group, oldMask, newMask);
 	}
-
-	return newEntity;
 }
 
 void EntityManager::DestroyEntity(const Entity entity)
 {
-	if(entity <= 0 || entity >= m_EntityMask.size())
+	if(!IsAlive(entity))
 	{
 		throw std::runtime_error("Try to remove non existing entity: " + std::to_string(entity));
 	}
 
+	const auto index = GetEntityIndex(entity);
+
+	//Release the components, the storages are keyed on the index and would hand them to the entity recycling the slot
+	const auto componentManager = Engine::Get()->GetComponentManager();
+	for (auto componentIndex = 1; componentIndex < static_cast<int>(ComponentType::LENGTH); componentIndex++)
+	{
+		const auto componentType = static_cast<ComponentType>(componentIndex);
+
+		if (HasComponent(entity, componentType))
+		{
+			componentManager->DestroyComponent(entity, componentType);
+		}
+	}
+
 	//Remove entity
-	m_EntityMask[entity - 1].mask = static_cast<int>(ComponentType::NONE);
-	m_EntityInfos[entity - 1] = INVALID_ENTITY;
-	m_LastEntity = entity - 1;
+	SetEntityMask(index, ComponentMask());
+
+	//Push the slot on the free list with the next generation
+	m_EntityInfos[index] = MakeEntity(m_FreeEntityIndex, GetEntityGeneration(entity) + 1);
+	m_FreeEntityIndex = index;
+
+	m_EntityCount--;
+}
+
+bool EntityManager::IsAlive(const Entity entity) const
+{
+	if(entity == INVALID_ENTITY)
+	{
+		return false;
+	}
+
+	const auto index = GetEntityIndex(entity);
+	return index < m_EntityInfos.size() && m_EntityInfos[index] == entity;
+}
+
+std::vector<Entity> EntityManager::GetEntities() const
+{
+	std::vector<Entity> entities;
+	entities.reserve(m_EntityCount);
+
+	for(EntityIndex index = 0; index < m_EntityInfos.size(); index++)
+	{
+		if(GetEntityIndex(m_EntityInfos[index]) == index)
+		{
+			entities.push_back(m_EntityInfos[index]);
+		}
+	}
+
+	return entities;
 }
 
 void EntityManager::AddComponent(const Entity entity, const ComponentType componentType)
 {
-	m_EntityMask[entity - 1].AddComponent(componentType);
+	const auto index = GetEntityIndex(entity);
+
+	auto newMask = m_EntityMask[index];
+	newMask.AddComponent(componentType);
+	SetEntityMask(index, newMask);
 }
 
 void EntityManager::DestroyComponent(const Entity entity, const ComponentType componentType)
 {
-	m_EntityMask[entity - 1].RemoveComponent(componentType);
+	const auto index = GetEntityIndex(entity);
+
+	auto newMask = m_EntityMask[index];
+	newMask.RemoveComponent(componentType);
+	SetEntityMask(index, newMask);
+}
+
+void EntityManager::SetEntityMask(const EntityIndex index, const ComponentMask newMask)
+{
+	const auto oldMask = m_EntityMask[index];
+	if (oldMask == newMask)
+	{
+		return;
+	}
+
+	m_EntityMask[index] = newMask;
+	m_QueryCache->OnMaskChanged(m_EntityInfos[index], oldMask, newMask);
+}
+
+const EntitySet& EntityManager::GetQuery(const ComponentMask signature)
+{
+	std::lock_guard<std::mutex> lock(m_QueryMutex);
+
+	const auto query = m_QueryCache->FindQuery(signature);
+	if (query != nullptr)
+	{
+		return *query;
+	}
+
+	//First request for this signature, the set is filled once then maintained by SetEntityMask
+	auto& entities = m_QueryCache->AddQuery(signature);
+	for (EntityIndex index = 0; index < m_EntityInfos.size(); index++)
+	{
+		if (GetEntityIndex(m_EntityInfos[index]) == index && m_EntityMask[index].Matches(signature))
+		{
+			entities.Insert(m_EntityInfos[index]);
+		}
+	}
+
+	return entities;
 }
 
 bool EntityManager::HasComponent(const Entity entity, const ComponentType componentType)
 {
 	ComponentMask tmpComponentMask;
 	tmpComponentMask.AddComponent(componentType);
-	return m_EntityMask[entity - 1].Matches(tmpComponentMask);
+	return m_EntityMask[GetEntityIndex(entity)].Matches(tmpComponentMask);
 }
 
 void EntityManager::ResizeEntity(const size_t newSize)
 {
+	//Components live in paged storages that never move, only the entity arrays are resized
 	m_EntityMask.resize(newSize);
-	m_EntityInfos.resize(newSize, static_cast<int>(ComponentType::NONE));
-
-	Engine::Get()->GetComponentManager()->OnEntityResize(newSize);
-	const auto editor = reinterpret_cast<Editor*>(Engine::Get()->GetApplication());
-	editor->GetGizmoManager()->OnEntityResize();
+	m_EntityInfos.reserve(newSize);
 }
 
 ComponentMask EntityManager::GetEntityMask(const Entity entity)
 {
-	return m_EntityMask[entity - 1];
+	return m_EntityMask[GetEntityIndex(entity)];
 }
 
 void EntityManager::ResizeEntity()
 {
-	ComponentMask emptyMask;
-	emptyMask.mask = static_cast<int>(ComponentType::NONE);
+	//Capacity doubles so that creating n entities only resizes O(log n) times
+	ResizeEntity(std::max<size_t>(INIT_ENTITY_NMB, m_EntityMask.size() * 2));
+}
+
+EntityCommandBuffer& EntityManager::GetCommandBuffer()
+{
+	const auto threadId = std::this_thread::get_id();
+
+	std::lock_guard<std::mutex> lock(m_CommandBufferMutex);
 
-	m_EntityMask.resize(m_EntityMask.size() + INIT_ENTITY_NMB, emptyMask);
-	m_EntityInfos.resize(m_EntityInfos.size() + INIT_ENTITY_NMB, static_cast<int>(ComponentType::NONE));
+	for (size_t i = 0; i < m_CommandBufferThreads.size(); i++)
+	{
+		if (m_CommandBufferThreads[i] == threadId)
+		{
+			return *m_CommandBuffers[i];
+		}
+	}
+
+	m_CommandBufferThreads.push_back(threadId);
+	m_CommandBuffers.push_back(std::make_unique<EntityCommandBuffer>());
+
+	return *m_CommandBuffers.back();
+}
+
+void EntityManager::PlaybackCommandBuffers()
+{
+	std::lock_guard<std::mutex> lock(m_CommandBufferMutex);
 
-	Engine::Get()->GetComponentManager()->OnEntityResize(INIT_ENTITY_NMB + m_EntityMask.size());
-	const auto editor = reinterpret_cast<Editor*>(Engine::Get()->GetApplication());
-	editor->GetGizmoManager()->OnEntityResize();
+	EntityCommandBuffer::Playback(m_CommandBuffers);
 }
 }
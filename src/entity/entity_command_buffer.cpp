@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <entity/entity_command_buffer.h>
+#include <algorithm>
+
+#include <engine/engine.h>
+#include <component/component_manager.h>
+
+namespace dm
+{
+DeferredEntity EntityCommandBuffer::CreateEntity()
+{
+	DeferredEntity entity;
+	entity.index = m_DeferredEntityNmb;
+	m_DeferredEntityNmb++;
+
+	return entity;
+}
+
+void EntityCommandBuffer::DestroyEntity(const Entity entity)
+{
+	Record(entity, INVALID_DEFERRED, CommandType::DESTROY_ENTITY, ComponentType::NONE);
+}
+
+void EntityCommandBuffer::CreateComponent(const Entity entity, const ComponentType componentType)
+{
+	Record(entity, INVALID_DEFERRED, CommandType::CREATE_COMPONENT, componentType);
+}
+
+void EntityCommandBuffer::CreateComponent(const DeferredEntity entity, const ComponentType componentType)
+{
+	Record(INVALID_ENTITY, entity.index, CommandType::CREATE_COMPONENT, componentType);
+}
+
+void EntityCommandBuffer::DestroyComponent(const Entity entity, const ComponentType componentType)
+{
+	Record(entity, INVALID_DEFERRED, CommandType::DESTROY_COMPONENT, componentType);
+}
+
+void EntityCommandBuffer::Clear()
+{
+	m_Commands.clear();
+	m_DeferredEntityNmb = 0;
+}
+
+void EntityCommandBuffer::Playback(const std::vector<std::unique_ptr<EntityCommandBuffer>>& commandBuffers)
+{
+	struct PendingCommand
+	{
+		Entity entity;
+		uint32_t bufferIndex;
+		const Command* command;
+	};
+
+	auto entityManager = Engine::Get()->GetEntityManager();
+	auto componentManager = Engine::Get()->GetComponentManager();
+
+	std::vector<PendingCommand> commands;
+	std::vector<Entity> createdEntities;
+
+	for (uint32_t bufferIndex = 0; bufferIndex < commandBuffers.size(); bufferIndex++)
+	{
+		const auto& commandBuffer = *commandBuffers[bufferIndex];
+
+		//Deferred entities get their real id in creation order
+		createdEntities.clear();
+		for (uint32_t i = 0; i < commandBuffer.m_DeferredEntityNmb; i++)
+		{
+			createdEntities.push_back(entityManager->CreateEntity());
+		}
+
+		for (const auto& command : commandBuffer.m_Commands)
+		{
+			const auto entity = command.deferredIndex == INVALID_DEFERRED ? command.entity : createdEntities[command.deferredIndex];
+			commands.push_back({ entity, bufferIndex, &command });
+		}
+	}
+
+	//Group the commands per entity, keeping the recording order inside a buffer
+	std::sort(commands.begin(), commands.end(), [](const PendingCommand& a, const PendingCommand& b)
+	{
+		if (a.entity != b.entity)
+		{
+			return a.entity < b.entity;
+		}
+
+		if (a.bufferIndex != b.bufferIndex)
+		{
+			return a.bufferIndex < b.bufferIndex;
+		}
+
+		return a.command->sequence < b.command->sequence;
+	});
+
+	size_t begin = 0;
+	while (begin < commands.size())
+	{
+		const auto entity = commands[begin].entity;
+
+		auto end = begin;
+		while (end < commands.size() && commands[end].entity == entity)
+		{
+			end++;
+		}
+
+		if (!entityManager->IsAlive(entity))
+		{
+			begin = end;
+			continue;
+		}
+
+		auto destroyed = false;
+
+		for (auto i = begin; i < end && !destroyed; i++)
+		{
+			const auto& command = *commands[i].command;
+
+			switch (command.type)
+			{
+			case CommandType::CREATE_COMPONENT:
+				componentManager->CreateComponent(entity, command.componentType);
+				entityManager->AddComponent(entity, command.componentType);
+				break;
+			case CommandType::ADD_COMPONENT:
+				command.addFunction(*componentManager, entity);
+				entityManager->AddComponent(entity, command.componentType);
+				break;
+			case CommandType::DESTROY_COMPONENT:
+				if (entityManager->HasComponent(entity, command.componentType))
+				{
+					componentManager->DestroyComponent(entity, command.componentType);
+					entityManager->DestroyComponent(entity, command.componentType);
+				}
+				break;
+			case CommandType::DESTROY_ENTITY:
+				destroyed = true;
+				break;
+			}
+		}
+
+		if (destroyed)
+		{
+			entityManager->DestroyEntity(entity);
+		}
+
+		begin = end;
+	}
+
+	for (const auto& commandBuffer : commandBuffers)
+	{
+		commandBuffer->Clear();
+	}
+}
+
+void EntityCommandBuffer::AddComponentToManager(ComponentManagerContainer& componentManager, const Entity entity, ComponentBase& component)
+{
+	componentManager.AddComponent(entity, component);
+}
+
+void EntityCommandBuffer::Record(const Entity entity, const uint32_t deferredIndex, const CommandType type, const ComponentType componentType, AddFunction addFunction)
+{
+	Command command;
+	command.entity = entity;
+	command.deferredIndex = deferredIndex;
+	command.sequence = static_cast<uint32_t>(m_Commands.size());
+	command.type = type;
+	command.componentType = componentType;
+	command.addFunction = std::move(addFunction);
+
+	m_Commands.push_back(std::move(command));
+}
+}
@@ -23,7 +23,6 @@ SOFTWARE.
 */
 
 #include <entity/entity_handle.h>
-#include <graphics/graphic_manager.h>
 #include <engine/engine.h>
 
 namespace dm
@@ -34,8 +33,6 @@ EntityHandle::EntityHandle(const Entity entity)
 
 	m_ComponentManager = Engine::Get()->GetComponentManager();
 	m_EntityManager = Engine::Get()->GetEntityManager();
-	m_SystemManager = Engine::Get()->GetSystemManager();
-	m_RendererContainer = GraphicManager::Get()->GetRendererContainer();
 }
 
 bool EntityHandle::HasComponent(const ComponentType componentType) const
@@ -45,22 +42,12 @@ bool EntityHandle::HasComponent(const ComponentType componentType) const
 
 void EntityHandle::DestroyComponent(const ComponentType componentType) const
 {
-	const auto oldMask = m_EntityManager->GetEntityMask(m_Entity);
-
 	m_EntityManager->DestroyComponent(m_Entity, componentType);
-	m_SystemManager->DestroyComponent(m_Entity, oldMask, m_EntityManager->GetEntityMask(m_Entity));
-	if (m_RendererContainer != nullptr)
-		m_RendererContainer->DestroyComponent(m_Entity, oldMask, m_EntityManager->GetEntityMask(m_Entity));
-
 	m_ComponentManager->DestroyComponent(m_Entity, componentType);
 }
 
 void EntityHandle::Destroy()
 {
-	const auto oldMask = m_EntityManager->GetEntityMask(m_Entity);
-
 	m_EntityManager->DestroyEntity(m_Entity);
-	m_SystemManager->DestroyComponent(m_Entity, oldMask, m_EntityManager->GetEntityMask(m_Entity));
-	m_RendererContainer->DestroyComponent(m_Entity, oldMask, m_EntityManager->GetEntityMask(m_Entity));
 }
 }
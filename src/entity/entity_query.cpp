@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <entity/entity_query.h>
+
+namespace dm
+{
+EntitySet* EntityQueryCache::FindQuery(const ComponentMask signature)
+{
+	const auto it = m_QueryIndices.find(signature);
+	if (it == m_QueryIndices.end())
+	{
+		return nullptr;
+	}
+
+	return m_Queries[it->second].entities.get();
+}
+
+EntitySet& EntityQueryCache::AddQuery(const ComponentMask signature)
+{
+	const auto query = FindQuery(signature);
+	if (query != nullptr)
+	{
+		return *query;
+	}
+
+	m_QueryIndices[signature] = m_Queries.size();
+	m_Queries.push_back(Query{ signature, std::make_unique<EntitySet>() });
+
+	return *m_Queries.back().entities;
+}
+
+void EntityQueryCache::OnMaskChanged(const Entity entity, const ComponentMask oldMask, const ComponentMask newMask)
+{
+	//There are only a few distinct signatures, a linear pass is cheaper than any index
+	for (auto& query : m_Queries)
+	{
+		if (newMask.IsNewMatch(oldMask, query.signature))
+		{
+			query.entities->Insert(entity);
+		}
+		else if (newMask.IsNoLongerMatch(oldMask, query.signature))
+		{
+			query.entities->Remove(entity);
+		}
+	}
+}
+
+void EntityQueryCache::OnMasksChanged(const std::vector<Entity>& entities, const ComponentMask oldMask, const ComponentMask newMask)
+{
+	for (auto& query : m_Queries)
+	{
+		if (newMask.IsNewMatch(oldMask, query.signature))
+		{
+			query.entities->Insert(entities);
+		}
+		else if (newMask.IsNoLongerMatch(oldMask, query.signature))
+		{
+			for (const auto entity : entities)
+			{
+				query.entities->Remove(entity);
+			}
+		}
+	}
+}
+
+void EntityQueryCache::Clear()
+{
+	for (auto& query : m_Queries)
+	{
+		query.entities->Clear();
+	}
+}
+}
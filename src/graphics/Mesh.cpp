@@ -30,34 +30,74 @@ Mesh::Mesh() :
 	m_VertexBuffer(nullptr),
 	m_IndexBuffer(nullptr),
 	m_VertexCount(0),
-	m_IndexCount(0)
+	m_IndexCount(0),
+	m_Radius(0)
 {}
 
 void Mesh::Load() {}
 
+const Mesh::OccluderGeometry& Mesh::GetOccluderGeometry()
+{
+	//Several views may rasterize the same occluder in parallel
+	std::lock_guard<std::mutex> lock(m_OccluderMutex);
+
+	if (m_OccluderGeometry == nullptr)
+	{
+		m_OccluderGeometry = std::make_unique<OccluderGeometry>();
+
+		m_LoadingOccluder = true;
+		Load();
+		m_LoadingOccluder = false;
+	}
+
+	return *m_OccluderGeometry;
+}
+
 bool Mesh::CmdRender(const CommandBuffer& commandBuffer, const uint32_t& instance) const
+{
+	if (!CmdBind(commandBuffer))
+	{
+		//throw std::runtime_error("Model with no buffers cannot be rendered");
+		return false;
+	}
+
+	return CmdDraw(commandBuffer, instance);
+}
+
+bool Mesh::CmdDraw(const CommandBuffer& commandBuffer, const uint32_t& instance, const uint32_t& firstInstance) const
 {
 	if (m_VertexBuffer != nullptr && m_IndexBuffer != nullptr)
 	{
-		VkBuffer vertexBuffers[] = { m_VertexBuffer->GetBuffer() };
-		VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-		vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->GetBuffer(), 0, GetIndexType());
-		vkCmdDrawIndexed(commandBuffer, m_IndexCount, instance, 0, 0, 0);
+		vkCmdDrawIndexed(commandBuffer, m_IndexCount, instance, 0, 0, firstInstance);
 	}
 	else if (m_VertexBuffer != nullptr && m_IndexBuffer == nullptr)
 	{
-		VkBuffer vertexBuffers[] = { m_VertexBuffer->GetBuffer() };
-		VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-		vkCmdDraw(commandBuffer, m_VertexCount, instance, 0, 0);
+		vkCmdDraw(commandBuffer, m_VertexCount, instance, 0, firstInstance);
 	}
 	else
 	{
-		//throw std::runtime_error("Model with no buffers cannot be rendered");
 		return false;
 	}
 
 	return true;
 }
+
+bool Mesh::CmdBind(const CommandBuffer& commandBuffer) const
+{
+	if (m_VertexBuffer == nullptr)
+	{
+		return false;
+	}
+
+	VkBuffer vertexBuffers[] = { m_VertexBuffer->GetBuffer() };
+	VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+	if (m_IndexBuffer != nullptr)
+	{
+		vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->GetBuffer(), 0, GetIndexType());
+	}
+
+	return true;
+}
 }
@@ -0,0 +1,458 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <graphics/bounding_volume_hierarchy.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace dm
+{
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::Insert(const Entity entity, const glm::vec3& center, const float radius)
+{
+	const auto leaf = AllocateNode();
+
+	auto& node = m_Nodes[leaf];
+	node.entity = entity;
+	node.center = center;
+	node.radius = radius;
+	node.box = Aabb::FromSphere(center, radius + FAT_MARGIN);
+	node.height = 0;
+
+	InsertLeaf(leaf);
+	m_LeafCount++;
+
+	return leaf;
+}
+
+void BoundingVolumeHierarchy::Remove(const ProxyId proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	m_LeafCount--;
+}
+
+bool BoundingVolumeHierarchy::Move(const ProxyId proxy, const glm::vec3& center, const float radius)
+{
+	auto& node = m_Nodes[proxy];
+	node.center = center;
+	node.radius = radius;
+
+	//Inside the enlarged box the tree is still valid, only the exact sphere changes
+	if (node.box.Contains(Aabb::FromSphere(center, radius)))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+	m_Nodes[proxy].box = Aabb::FromSphere(center, radius + FAT_MARGIN);
+	InsertLeaf(proxy);
+
+	return true;
+}
+
+void BoundingVolumeHierarchy::Query(const Frustum& frustum, std::vector<Entity>& visibleEntities) const
+{
+	const FrustumQuery query{ &frustum, Frustum::ALL_PLANES, &visibleEntities };
+	Query(&query, 1);
+}
+
+void BoundingVolumeHierarchy::Query(const FrustumQuery* queries, const size_t queryNmb) const
+{
+	if (m_Root == INVALID_PROXY || queryNmb == 0)
+	{
+		return;
+	}
+
+	if (queryNmb > MAX_QUERY_NMB)
+	{
+		throw std::runtime_error("Too many frustum queries in one traversal: " + std::to_string(queryNmb));
+	}
+
+	//Each query keeps the mask of the planes still crossed in 8 bits, once empty the whole subtree is accepted for it
+	struct StackEntry
+	{
+		ProxyId node;
+		uint32_t activeQueries;
+		uint64_t planeMasks;
+	};
+
+	StackEntry root{ m_Root, (1u << queryNmb) - 1, 0 };
+	for (size_t query = 0; query < queryNmb; query++)
+	{
+		root.planeMasks |= static_cast<uint64_t>(queries[query].planeMask & Frustum::ALL_PLANES) << (query * 8);
+	}
+
+	//Leaves still crossing a plane of a query are tested together once the traversal is done
+	struct LeafBatch
+	{
+		BoundingSphereSoA spheres;
+		std::vector<Entity> entities;
+		std::vector<uint32_t> visibleIndices;
+	};
+	LeafBatch batches[MAX_QUERY_NMB];
+
+	std::vector<StackEntry> stack;
+	stack.push_back(root);
+
+	while (!stack.empty())
+	{
+		const auto entry = stack.back();
+		stack.pop_back();
+
+		const auto& node = m_Nodes[entry.node];
+
+		if (node.IsLeaf())
+		{
+			for (size_t query = 0; query < queryNmb; query++)
+			{
+				if ((entry.activeQueries & (1u << query)) == 0)
+				{
+					continue;
+				}
+
+				if (((entry.planeMasks >> (query * 8)) & 0xFF) == 0)
+				{
+					queries[query].visibleEntities->push_back(node.entity);
+					continue;
+				}
+
+				batches[query].spheres.Add(node.center, node.radius);
+				batches[query].entities.push_back(node.entity);
+			}
+			continue;
+		}
+
+		//Inner nodes are tested with their box projected on each plane normal
+		const auto center = node.box.GetCenter();
+		const auto extents = node.box.GetExtents();
+
+		auto activeQueries = entry.activeQueries;
+		auto planeMasks = entry.planeMasks;
+
+		for (size_t query = 0; query < queryNmb; query++)
+		{
+			const auto shift = query * 8;
+			auto planeMask = static_cast<uint32_t>(planeMasks >> shift) & 0xFF;
+
+			if ((activeQueries & (1u << query)) == 0 || planeMask == 0)
+			{
+				continue;
+			}
+
+			const auto& frustum = *queries[query].frustum;
+
+			for (size_t i = 0; i < Frustum::PLANE_NMB; i++)
+			{
+				if ((planeMask & (1u << i)) == 0)
+				{
+					continue;
+				}
+
+				const auto& plane = frustum.planes[i];
+				const auto distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+				const auto radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+
+				if (distance < -radius)
+				{
+					activeQueries &= ~(1u << query);
+					break;
+				}
+
+				if (distance >= radius)
+				{
+					//Every child is on the inner side of this plane, the children skip it
+					planeMask &= ~(1u << i);
+				}
+			}
+
+			planeMasks = (planeMasks & ~(0xFFull << shift)) | (static_cast<uint64_t>(planeMask) << shift);
+		}
+
+		if (activeQueries == 0)
+		{
+			continue;
+		}
+
+		stack.push_back({ node.child1, activeQueries, planeMasks });
+		stack.push_back({ node.child2, activeQueries, planeMasks });
+	}
+
+	//The planes skipped by a leaf contain its whole subtree, testing all the planes of the query gives the same result
+	for (size_t query = 0; query < queryNmb; query++)
+	{
+		auto& batch = batches[query];
+		if (batch.entities.empty())
+		{
+			continue;
+		}
+
+		queries[query].frustum->CullSpheres(batch.spheres, batch.visibleIndices, queries[query].planeMask);
+
+		for (const auto index : batch.visibleIndices)
+		{
+			queries[query].visibleEntities->push_back(batch.entities[index]);
+		}
+	}
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+	m_Nodes.clear();
+	m_Root = INVALID_PROXY;
+	m_FreeNode = INVALID_PROXY;
+	m_LeafCount = 0;
+}
+
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::AllocateNode()
+{
+	if (m_FreeNode == INVALID_PROXY)
+	{
+		m_Nodes.emplace_back();
+		return static_cast<ProxyId>(m_Nodes.size() - 1);
+	}
+
+	//Free nodes are chained through their parent index
+	const auto node = m_FreeNode;
+	m_FreeNode = m_Nodes[node].parent;
+	m_Nodes[node] = Node();
+
+	return node;
+}
+
+void BoundingVolumeHierarchy::FreeNode(const ProxyId node)
+{
+	m_Nodes[node] = Node();
+	m_Nodes[node].parent = m_FreeNode;
+	m_FreeNode = node;
+}
+
+void BoundingVolumeHierarchy::InsertLeaf(const ProxyId leaf)
+{
+	if (m_Root == INVALID_PROXY)
+	{
+		m_Root = leaf;
+		m_Nodes[leaf].parent = INVALID_PROXY;
+		return;
+	}
+
+	//Descend toward the cheapest sibling, the cost of a subtree is the area added to it by the new leaf
+	const auto leafBox = m_Nodes[leaf].box;
+	auto index = m_Root;
+
+	while (!m_Nodes[index].IsLeaf())
+	{
+		const auto& node = m_Nodes[index];
+
+		const auto area = node.box.GetHalfArea();
+		const auto combinedArea = Aabb::Union(node.box, leafBox).GetHalfArea();
+
+		//Cost of making a new parent for this node and the leaf, and the cost pushed down to the children
+		const auto cost = 2.0f * combinedArea;
+		const auto inheritanceCost = 2.0f * (combinedArea - area);
+
+		const auto childCost = [&](const ProxyId child)
+		{
+			const auto& childNode = m_Nodes[child];
+			const auto unionArea = Aabb::Union(leafBox, childNode.box).GetHalfArea();
+			return (childNode.IsLeaf() ? unionArea : unionArea - childNode.box.GetHalfArea()) + inheritanceCost;
+		};
+
+		const auto cost1 = childCost(node.child1);
+		const auto cost2 = childCost(node.child2);
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	const auto sibling = index;
+	const auto oldParent = m_Nodes[sibling].parent;
+	const auto newParent = AllocateNode();
+
+	auto& parentNode = m_Nodes[newParent];
+	parentNode.parent = oldParent;
+	parentNode.box = Aabb::Union(leafBox, m_Nodes[sibling].box);
+	parentNode.height = m_Nodes[sibling].height + 1;
+	parentNode.child1 = sibling;
+	parentNode.child2 = leaf;
+
+	if (oldParent != INVALID_PROXY)
+	{
+		ReplaceChild(oldParent, sibling, newParent);
+	}
+	else
+	{
+		m_Root = newParent;
+	}
+
+	m_Nodes[sibling].parent = newParent;
+	m_Nodes[leaf].parent = newParent;
+
+	Refit(m_Nodes[leaf].parent);
+}
+
+void BoundingVolumeHierarchy::RemoveLeaf(const ProxyId leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = INVALID_PROXY;
+		return;
+	}
+
+	const auto parent = m_Nodes[leaf].parent;
+	const auto grandParent = m_Nodes[parent].parent;
+	const auto sibling = m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+	m_Nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == INVALID_PROXY)
+	{
+		m_Root = sibling;
+		return;
+	}
+
+	ReplaceChild(grandParent, parent, sibling);
+	Refit(grandParent);
+}
+
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::Balance(const ProxyId a)
+{
+	if (m_Nodes[a].IsLeaf() || m_Nodes[a].height < 2)
+	{
+		return a;
+	}
+
+	const auto b = m_Nodes[a].child1;
+	const auto c = m_Nodes[a].child2;
+	const auto balance = m_Nodes[c].height - m_Nodes[b].height;
+
+	if (balance > 1)
+	{
+		//Rotate c up, a takes the lower child of c
+		const auto f = m_Nodes[c].child1;
+		const auto g = m_Nodes[c].child2;
+
+		m_Nodes[c].child1 = a;
+		m_Nodes[c].parent = m_Nodes[a].parent;
+		m_Nodes[a].parent = c;
+
+		if (m_Nodes[c].parent != INVALID_PROXY)
+		{
+			ReplaceChild(m_Nodes[c].parent, a, c);
+		}
+		else
+		{
+			m_Root = c;
+		}
+
+		const auto high = m_Nodes[f].height > m_Nodes[g].height ? f : g;
+		const auto low = high == f ? g : f;
+
+		m_Nodes[c].child2 = high;
+		m_Nodes[a].child2 = low;
+		m_Nodes[low].parent = a;
+
+		m_Nodes[a].box = Aabb::Union(m_Nodes[b].box, m_Nodes[low].box);
+		m_Nodes[c].box = Aabb::Union(m_Nodes[a].box, m_Nodes[high].box);
+		m_Nodes[a].height = 1 + std::max(m_Nodes[b].height, m_Nodes[low].height);
+		m_Nodes[c].height = 1 + std::max(m_Nodes[a].height, m_Nodes[high].height);
+
+		return c;
+	}
+
+	if (balance < -1)
+	{
+		//Rotate b up, a takes the lower child of b
+		const auto d = m_Nodes[b].child1;
+		const auto e = m_Nodes[b].child2;
+
+		m_Nodes[b].child1 = a;
+		m_Nodes[b].parent = m_Nodes[a].parent;
+		m_Nodes[a].parent = b;
+
+		if (m_Nodes[b].parent != INVALID_PROXY)
+		{
+			ReplaceChild(m_Nodes[b].parent, a, b);
+		}
+		else
+		{
+			m_Root = b;
+		}
+
+		const auto high = m_Nodes[d].height > m_Nodes[e].height ? d : e;
+		const auto low = high == d ? e : d;
+
+		m_Nodes[b].child2 = high;
+		m_Nodes[a].child1 = low;
+		m_Nodes[low].parent = a;
+
+		m_Nodes[a].box = Aabb::Union(m_Nodes[c].box, m_Nodes[low].box);
+		m_Nodes[b].box = Aabb::Union(m_Nodes[a].box, m_Nodes[high].box);
+		m_Nodes[a].height = 1 + std::max(m_Nodes[c].height, m_Nodes[low].height);
+		m_Nodes[b].height = 1 + std::max(m_Nodes[a].height, m_Nodes[high].height);
+
+		return b;
+	}
+
+	return a;
+}
+
+void BoundingVolumeHierarchy::Refit(ProxyId node)
+{
+	while (node != INVALID_PROXY)
+	{
+		node = Balance(node);
+
+		auto& current = m_Nodes[node];
+		const auto& child1 = m_Nodes[current.child1];
+		const auto& child2 = m_Nodes[current.child2];
+
+		current.height = 1 + std::max(child1.height, child2.height);
+		current.box = Aabb::Union(child1.box, child2.box);
+
+		node = current.parent;
+	}
+}
+
+void BoundingVolumeHierarchy::ReplaceChild(const ProxyId parent, const ProxyId oldChild, const ProxyId newChild)
+{
+	auto& parentNode = m_Nodes[parent];
+
+	if (parentNode.child1 == oldChild)
+	{
+		parentNode.child1 = newChild;
+	}
+	else
+	{
+		parentNode.child2 = newChild;
+	}
+}
+}
@@ -23,12 +23,16 @@ SOFTWARE.
 */
 
 #include <graphics/buffers/instance_buffer.h>
+#include <graphics/graphic_manager.h>
 #include <iostream>
+#include <cstring>
 
 namespace dm
 {
-InstanceBuffer::InstanceBuffer(const VkDeviceSize& size) :
-	Buffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+InstanceBuffer::InstanceBuffer(const VkDeviceSize& frameSize, const uint32_t& frameCount) :
+	Buffer(frameSize * frameCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+	m_FrameSize(frameSize),
+	m_FrameCount(frameCount)
 {}
 
 void InstanceBuffer::Update(const CommandBuffer& commandBuffer, const void* newData)
@@ -38,4 +42,29 @@ void InstanceBuffer::Update(const CommandBuffer& commandBuffer, const void* newD
 	memcpy(data, newData, static_cast<size_t>(m_Size));
 	Buffer::UnmapMemory();
 }
+
+VkDeviceSize InstanceBuffer::Upload(std::unique_ptr<InstanceBuffer>& buffer, const void* data, const VkDeviceSize& size)
+{
+	const auto graphicManager = GraphicManager::Get();
+	const auto frameCount = graphicManager->GetFrameCount();
+
+	if (buffer == nullptr || buffer->GetFrameSize() < size || buffer->GetFrameCount() != frameCount)
+	{
+		//The previous frames may still read the old buffer
+		graphicManager->WaitFramesInFlight();
+
+		//Grow by half to avoid a new allocation each time an instance is added
+		buffer = std::make_unique<InstanceBuffer>(size + size / 2, frameCount);
+	}
+
+	//The fence of the current frame is signaled, the GPU is done with its region
+	const auto offset = buffer->GetFrameSize() * graphicManager->GetCurrentFrame();
+
+	void* mapped;
+	buffer->MapMemory(&mapped);
+	std::memcpy(static_cast<char*>(mapped) + offset, data, static_cast<std::size_t>(size));
+	buffer->UnmapMemory();
+
+	return offset;
+}
 }
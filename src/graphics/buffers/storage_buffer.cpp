@@ -26,8 +26,8 @@ SOFTWARE.
 
 namespace dm
 {
-StorageBuffer::StorageBuffer(const VkDeviceSize& size, const void* data) :
-	Buffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, data)
+StorageBuffer::StorageBuffer(const VkDeviceSize& size, const void* data, const VkBufferUsageFlags& usage) :
+	Buffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, data)
 {
 	
 }
@@ -46,7 +46,10 @@ void StorageHandle::Push(void* data, const std::size_t& size)
 {
 	if (size != m_Size)
 	{
+		//The data is kept to fill the buffer recreated by the next Update
 		m_Size = static_cast<uint32_t>(size);
+		m_Data = std::make_unique<char[]>(m_Size);
+		std::memcpy(m_Data.get(), data, size);
 		m_HandleStatus = Buffer::Status::RESET;
 		return;
 	}
@@ -67,13 +70,19 @@ bool StorageHandle::Update(const std::optional<Shader::UniformBlock>& uniformBlo
 {
 	if (m_HandleStatus == Buffer::Status::RESET || (m_MultiPipeline && !m_UniformBlock) || (!m_MultiPipeline && m_UniformBlock != uniformBlock))
 	{
+		const auto pushedSize = m_Size;
+
 		if ((m_Size == 0 && !m_UniformBlock) || (m_UniformBlock && m_UniformBlock != uniformBlock && static_cast<uint32_t>(m_UniformBlock->GetSize()) == m_Size)) {
 			m_Size = static_cast<uint32_t>(uniformBlock->GetSize());
 		}
 
+		if (m_HandleStatus != Buffer::Status::RESET || m_Data == nullptr || m_Size != pushedSize)
+		{
+			m_Data = std::make_unique<char[]>(m_Size);
+		}
+
 		m_UniformBlock = uniformBlock;
-		m_Data = std::make_unique<char[]>(m_Size);
-		m_StorageBuffer = std::make_unique<StorageBuffer>(static_cast<VkDeviceSize>(m_Size));
+		m_StorageBuffer = std::make_unique<StorageBuffer>(static_cast<VkDeviceSize>(m_Size), m_Data.get());
 		m_HandleStatus = Buffer::Status::CHANGED;
 		return false;
 	}
@@ -59,6 +59,31 @@ bool UniformHandle::Update(const std::optional<Shader::UniformBlock>& uniformBlo
 	return true;
 }
 
+bool UniformHandle::UpdateLayout(const std::optional<Shader::UniformBlock>& uniformBlock)
+{
+	if (!uniformBlock)
+	{
+		return false;
+	}
+
+	if (m_UniformBlock == uniformBlock)
+	{
+		return true;
+	}
+
+	m_UniformBlock = uniformBlock;
+	m_Size = static_cast<uint32_t>(uniformBlock->GetSize());
+	m_Data = std::make_unique<char[]>(m_Size);
+	m_UniformBuffer = nullptr;
+	m_HandleStatus = Buffer::Status::NORMAL;
+	return false;
+}
+
+uint32_t UniformHandle::Allocate(UniformRingBuffer& uniformRing) const
+{
+	return uniformRing.Allocate(m_Data.get(), static_cast<VkDeviceSize>(m_Size));
+}
+
 UniformHandle::UniformHandle(const Shader::UniformBlock& uniformBlock, const bool& multiPipeline) :
 	m_MultiPipeline(multiPipeline),
 	m_UniformBlock(uniformBlock),
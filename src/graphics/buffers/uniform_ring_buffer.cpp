@@ -0,0 +1,115 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <graphics/buffers/uniform_ring_buffer.h>
+#include <graphics/graphic_manager.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace dm
+{
+static VkDeviceSize GetMinUniformAlignment()
+{
+	return GraphicManager::Get()->GetPhysicalDevice()->GetProperties().limits.minUniformBufferOffsetAlignment;
+}
+
+UniformRingBuffer::UniformRingBuffer(const VkDeviceSize& frameSize, const uint32_t& frameCount) :
+	Buffer(AlignUp(frameSize, GetMinUniformAlignment()) * frameCount, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+	m_Alignment(GetMinUniformAlignment()),
+	m_FrameSize(AlignUp(frameSize, m_Alignment)),
+	m_FrameOffset(0),
+	m_Cursor(0),
+	m_Mapped(nullptr)
+{
+	//Coherent memory stays mapped for the lifetime of the buffer
+	void* mapped;
+	Buffer::MapMemory(&mapped);
+	m_Mapped = static_cast<char*>(mapped);
+}
+
+UniformRingBuffer::~UniformRingBuffer()
+{
+	Buffer::UnmapMemory();
+}
+
+void UniformRingBuffer::BeginFrame(const uint32_t& frame)
+{
+	m_FrameOffset = m_FrameSize * frame;
+
+	if (m_FrameOffset >= m_Size)
+	{
+		throw std::runtime_error("Uniform ring buffer has no region for this frame");
+	}
+
+	m_Cursor = m_FrameOffset;
+}
+
+uint32_t UniformRingBuffer::Allocate(const void* data, const VkDeviceSize& size)
+{
+	if (m_Cursor + size > m_FrameOffset + m_FrameSize)
+	{
+		throw std::runtime_error("Uniform ring buffer is full, increase its frame size");
+	}
+
+	const auto offset = m_Cursor;
+	std::memcpy(m_Mapped + offset, data, static_cast<std::size_t>(size));
+	m_Cursor = AlignUp(offset + size, m_Alignment);
+
+	return static_cast<uint32_t>(offset);
+}
+
+VkDeviceSize UniformRingBuffer::AlignUp(const VkDeviceSize& size, const VkDeviceSize& alignment)
+{
+	if (alignment == 0)
+	{
+		return size;
+	}
+
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+WriteDescriptorSet UniformRingBuffer::GetWriteDescriptor(const uint32_t& binding, const VkDescriptorType& descriptorType,
+	const std::optional<OffsetSize>& offsetSize) const
+{
+	VkDescriptorBufferInfo bufferInfo = {};
+	bufferInfo.buffer = m_Buffer;
+	bufferInfo.offset = 0;
+	bufferInfo.range = m_FrameSize;
+
+	if (offsetSize)
+	{
+		bufferInfo.range = offsetSize->GetSize();
+	}
+
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = VK_NULL_HANDLE;
+	descriptorWrite.dstBinding = binding;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.descriptorType = descriptorType;
+	return WriteDescriptorSet(descriptorWrite, bufferInfo);
+}
+}
@@ -55,6 +55,23 @@ void DescriptorHandle::Push(const std::string& descriptorName, UniformHandle& un
 	Push(descriptorName, uniformHandle.GetUniformBuffer(), offsetSize);
 }
 
+void DescriptorHandle::Push(const std::string& descriptorName, UniformRingBuffer& uniformRing)
+{
+	if (m_Shader == nullptr)
+	{
+		return;
+	}
+
+	const auto uniformBlock = m_Shader->GetUniformBlock(descriptorName);
+
+	if (!uniformBlock)
+	{
+		return;
+	}
+
+	Push(descriptorName, &uniformRing, OffsetSize(0, static_cast<uint32_t>(uniformBlock->GetSize())));
+}
+
 void DescriptorHandle::Push(const std::string& descriptorName, StorageHandle& storageHandle,
 	const std::optional<OffsetSize>& offsetSize)
 {
@@ -139,4 +156,16 @@ void DescriptorHandle::BindDescriptor(const CommandBuffer& commandBuffer, const
 		m_DescriptorSet->BindDescriptor(commandBuffer);
 	}
 }
+
+void DescriptorHandle::BindDescriptor(const CommandBuffer& commandBuffer, const Pipeline& pipeline, const uint32_t& dynamicOffset)
+{
+	//Push descriptor layouts can't hold dynamic descriptors
+	if (m_PushDescriptor)
+	{
+		BindDescriptor(commandBuffer, pipeline);
+		return;
+	}
+
+	m_DescriptorSet->BindDescriptor(commandBuffer, dynamicOffset);
+}
 }
@@ -64,4 +64,9 @@ void DescriptorSet::BindDescriptor(const CommandBuffer& commandBuffer)
 {
 	vkCmdBindDescriptorSets(commandBuffer, m_PipelineBindPoint, m_PipelineLayout, 0, 1, &m_DescriptorSet, 0, nullptr);
 }
+
+void DescriptorSet::BindDescriptor(const CommandBuffer& commandBuffer, const uint32_t& dynamicOffset)
+{
+	vkCmdBindDescriptorSets(commandBuffer, m_PipelineBindPoint, m_PipelineLayout, 0, 1, &m_DescriptorSet, 1, &dynamicOffset);
+}
 }
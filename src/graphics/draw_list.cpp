@@ -0,0 +1,201 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <graphics/draw_list.h>
+#include <graphics/Mesh.h>
+#include <graphics/pipeline_material.h>
+#include <graphics/descriptor_handle.h>
+
+#include <algorithm>
+
+namespace dm
+{
+DrawStats& DrawStats::operator+=(const DrawStats& other)
+{
+	drawCount += other.drawCount;
+	instanceCount += other.instanceCount;
+	pipelineBinds += other.pipelineBinds;
+	descriptorBinds += other.descriptorBinds;
+	meshBinds += other.meshBinds;
+	savedStateChanges += other.savedStateChanges;
+	return *this;
+}
+
+uint64_t DrawList::MakeKey(const uint32_t subpass, const uint32_t pipeline, const uint32_t material, const uint32_t mesh, const float depth)
+{
+	const auto maxDepth = static_cast<float>((1u << DEPTH_BITS) - 1);
+	const auto quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * maxDepth);
+
+	auto key = static_cast<uint64_t>(subpass & ((1u << SUBPASS_BITS) - 1));
+	key = key << PIPELINE_BITS | (pipeline & ((1u << PIPELINE_BITS) - 1));
+	key = key << MATERIAL_BITS | (material & ((1u << MATERIAL_BITS) - 1));
+	key = key << MESH_BITS | (mesh & ((1u << MESH_BITS) - 1));
+	key = key << DEPTH_BITS | quantizedDepth;
+	return key;
+}
+
+uint32_t DrawList::GetStateId(const State state, const void* object)
+{
+	auto& ids = m_StateIds[static_cast<size_t>(state)];
+	return ids.emplace(object, static_cast<uint32_t>(ids.size())).first->second;
+}
+
+void DrawList::Clear()
+{
+	m_Draws.clear();
+
+	for (auto& ids : m_StateIds)
+	{
+		ids.clear();
+	}
+}
+
+void DrawList::Add(const uint64_t key, const uint32_t index)
+{
+	m_Draws.push_back({ key, index });
+}
+
+void DrawList::Sort()
+{
+	constexpr uint32_t DIGIT_BITS = 8;
+	constexpr uint32_t BUCKET_NMB = 1u << DIGIT_BITS;
+
+	if (m_Draws.size() < 2)
+	{
+		return;
+	}
+
+	m_SortBuffer.resize(m_Draws.size());
+
+	for (uint32_t shift = 0; shift < 64; shift += DIGIT_BITS)
+	{
+		std::array<uint32_t, BUCKET_NMB> offsets{};
+		for (const auto& draw : m_Draws)
+		{
+			offsets[(draw.key >> shift) & (BUCKET_NMB - 1)]++;
+		}
+
+		//Every key has the same digit, the pass wouldn't move anything
+		if (offsets[(m_Draws.front().key >> shift) & (BUCKET_NMB - 1)] == m_Draws.size())
+		{
+			continue;
+		}
+
+		uint32_t total = 0;
+		for (auto& offset : offsets)
+		{
+			const auto count = offset;
+			offset = total;
+			total += count;
+		}
+
+		for (const auto& draw : m_Draws)
+		{
+			m_SortBuffer[offsets[(draw.key >> shift) & (BUCKET_NMB - 1)]++] = draw;
+		}
+
+		m_Draws.swap(m_SortBuffer);
+	}
+}
+
+void DrawList::BeginReplay()
+{
+	m_BoundPipeline = nullptr;
+	m_BoundDescriptor = nullptr;
+	m_BoundMesh = nullptr;
+	m_Stats = DrawStats();
+}
+
+bool DrawList::BindPipeline(const CommandBuffer& commandBuffer, PipelineMaterial& pipelineMaterial)
+{
+	if (m_BoundPipeline == &pipelineMaterial)
+	{
+		m_Stats.savedStateChanges++;
+		return true;
+	}
+
+	if (!pipelineMaterial.BindPipeline(commandBuffer))
+	{
+		m_BoundPipeline = nullptr;
+		return false;
+	}
+
+	//Descriptor sets are rebound with the new pipeline layout, vertex buffers stay bound
+	m_BoundPipeline = &pipelineMaterial;
+	m_BoundDescriptor = nullptr;
+	m_Stats.pipelineBinds++;
+	return true;
+}
+
+void DrawList::BindDescriptor(const CommandBuffer& commandBuffer, DescriptorHandle& descriptorSet, const Pipeline& pipeline)
+{
+	if (m_BoundDescriptor == &descriptorSet)
+	{
+		m_Stats.savedStateChanges++;
+		return;
+	}
+
+	descriptorSet.BindDescriptor(commandBuffer, pipeline);
+	m_BoundDescriptor = &descriptorSet;
+	m_BoundDynamicOffset.reset();
+	m_Stats.descriptorBinds++;
+}
+
+void DrawList::BindDescriptor(const CommandBuffer& commandBuffer, DescriptorHandle& descriptorSet, const Pipeline& pipeline, const uint32_t dynamicOffset)
+{
+	if (m_BoundDescriptor == &descriptorSet && m_BoundDynamicOffset == dynamicOffset)
+	{
+		m_Stats.savedStateChanges++;
+		return;
+	}
+
+	descriptorSet.BindDescriptor(commandBuffer, pipeline, dynamicOffset);
+	m_BoundDescriptor = &descriptorSet;
+	m_BoundDynamicOffset = dynamicOffset;
+	m_Stats.descriptorBinds++;
+}
+
+bool DrawList::DrawMesh(const CommandBuffer& commandBuffer, const Mesh& mesh, const uint32_t instanceCount, const uint32_t firstInstance)
+{
+	if (m_BoundMesh == &mesh)
+	{
+		m_Stats.savedStateChanges++;
+	}
+	else
+	{
+		if (!mesh.CmdBind(commandBuffer))
+		{
+			m_BoundMesh = nullptr;
+			return false;
+		}
+
+		m_BoundMesh = &mesh;
+		m_Stats.meshBinds++;
+	}
+
+	m_Stats.drawCount++;
+	m_Stats.instanceCount += instanceCount;
+	return mesh.CmdDraw(commandBuffer, instanceCount, firstInstance);
+}
+}
@@ -0,0 +1,163 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <graphics/frustum.h>
+#include <engine/simd.h>
+
+#include <cmath>
+
+namespace dm
+{
+namespace
+{
+#ifdef DM_SIMD_ENABLED
+/**
+ * \brief Cull Simd::WIDTH spheres at a time against at least one plane, return the number of spheres handled
+ */
+template<typename Simd>
+size_t CullSpheresSimd(const Frustum& frustum, const uint32_t planeMask, const BoundingSphereSoA& spheres, uint32_t* visibleIndices, size_t& visibleCount)
+{
+	using Float = typename Simd::Float;
+
+	const auto batchedCount = spheres.Size() / Simd::WIDTH * Simd::WIDTH;
+	const auto zero = Simd::Set(0.0f);
+
+	Float planeX[Frustum::PLANE_NMB];
+	Float planeY[Frustum::PLANE_NMB];
+	Float planeZ[Frustum::PLANE_NMB];
+	Float planeW[Frustum::PLANE_NMB];
+	size_t planeNmb = 0;
+	for (size_t plane = 0; plane < Frustum::PLANE_NMB; plane++)
+	{
+		if ((planeMask & (1u << plane)) == 0)
+		{
+			continue;
+		}
+
+		planeX[planeNmb] = Simd::Set(frustum.planes[plane].x);
+		planeY[planeNmb] = Simd::Set(frustum.planes[plane].y);
+		planeZ[planeNmb] = Simd::Set(frustum.planes[plane].z);
+		planeW[planeNmb] = Simd::Set(frustum.planes[plane].w);
+		planeNmb++;
+	}
+
+	for (size_t i = 0; i < batchedCount; i += Simd::WIDTH)
+	{
+		const auto x = Simd::Load(&spheres.centerX[i]);
+		const auto y = Simd::Load(&spheres.centerY[i]);
+		const auto z = Simd::Load(&spheres.centerZ[i]);
+		const auto negativeRadius = Simd::Sub(zero, Simd::Load(&spheres.radius[i]));
+
+		const auto isInside = [&](const size_t plane)
+		{
+			const auto distance = Simd::Add(
+				Simd::Add(Simd::Mul(planeX[plane], x), Simd::Mul(planeY[plane], y)),
+				Simd::Add(Simd::Mul(planeZ[plane], z), planeW[plane]));
+			return Simd::GreaterEqual(distance, negativeRadius);
+		};
+
+		auto inside = isInside(0);
+		for (size_t plane = 1; plane < planeNmb; plane++)
+		{
+			inside = Simd::And(inside, isInside(plane));
+		}
+
+		//Branchless compaction, every lane is written and only the visible ones advance the count
+		const auto mask = Simd::MoveMask(inside);
+		for (uint32_t lane = 0; lane < Simd::WIDTH; lane++)
+		{
+			visibleIndices[visibleCount] = static_cast<uint32_t>(i + lane);
+			visibleCount += (mask >> lane) & 1;
+		}
+	}
+
+	return batchedCount;
+}
+#endif
+}
+
+Frustum Frustum::FromMatrix(const glm::mat4x4& viewProjection)
+{
+	Frustum frustum;
+
+	//Gribb-Hartmann, each plane is the fourth row of the matrix plus or minus one of the three others
+	for (auto axis = 0; axis < 3; axis++)
+	{
+		for (auto side = 0; side < 2; side++)
+		{
+			const auto sign = side == 0 ? 1.0f : -1.0f;
+			auto& plane = frustum.planes[axis * 2 + side];
+
+			plane.x = viewProjection[0][3] + sign * viewProjection[0][axis];
+			plane.y = viewProjection[1][3] + sign * viewProjection[1][axis];
+			plane.z = viewProjection[2][3] + sign * viewProjection[2][axis];
+			plane.w = viewProjection[3][3] + sign * viewProjection[3][axis];
+
+			const auto length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+			plane /= length;
+		}
+	}
+
+	return frustum;
+}
+
+bool Frustum::IsVisible(const glm::vec3& center, const float radius, const uint32_t planeMask) const
+{
+	for (size_t i = 0; i < PLANE_NMB; i++)
+	{
+		const auto& plane = planes[i];
+		if ((planeMask & (1u << i)) != 0 && plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Frustum::CullSpheres(const BoundingSphereSoA& spheres, std::vector<uint32_t>& visibleIndices, const uint32_t planeMask) const
+{
+	visibleIndices.resize(spheres.Size());
+
+	size_t visibleCount = 0;
+	size_t culledCount = 0;
+
+#ifdef DM_SIMD_ENABLED
+	if ((planeMask & ALL_PLANES) != 0)
+	{
+		culledCount = CullSpheresSimd<SimdNative>(*this, planeMask, spheres, visibleIndices.data(), visibleCount);
+	}
+#endif
+
+	for (auto i = culledCount; i < spheres.Size(); i++)
+	{
+		if (IsVisible(glm::vec3(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]), spheres.radius[i], planeMask))
+		{
+			visibleIndices[visibleCount++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	visibleIndices.resize(visibleCount);
+}
+}
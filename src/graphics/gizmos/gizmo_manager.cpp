@@ -77,16 +77,4 @@ void GizmoManager::Clear()
 {
 	m_Gizmos.clear();
 }
-
-void GizmoManager::OnEntityResize()
-{
-	auto transformManager = Engine::Get()->GetComponentManager()->GetTransformManager();
-	for (auto& gizmo : m_Gizmos)
-	{
-		for (auto& gizmo1 : gizmo.second)
-		{
-			gizmo1.transform = transformManager->GetComponent(gizmo1.entity);
-		}
-	}
-}
 }
@@ -24,7 +24,9 @@ SOFTWARE.
 
 #include <graphics/gizmos/gizmo_type.h>
 #include <graphics/gizmos/gizmo.h>
-#include "entity/entity_handle.h"
+#include <component/component_manager.h>
+#include <engine/engine.h>
+#include <graphics/graphic_manager.h>
 
 namespace dm
 {
@@ -58,6 +60,8 @@ void GizmoType::Update(std::vector<Gizmo>& gizmos)
 	Instance *instances;
 	m_InstanceBuffer.MapMemory(reinterpret_cast<void**>(&instances));
 
+	const auto& visibleEntities = GraphicManager::Get()->GetVisibleEntities();
+
 	for(const auto &gizmo : gizmos)
 	{
 		if(m_Instances >= m_MaxInstances)
@@ -65,7 +69,7 @@ void GizmoType::Update(std::vector<Gizmo>& gizmos)
 			break;
 		}
 
-		if(!EntityHandle(gizmo.entity).GetComponent<Drawable>(ComponentType::DRAWABLE)->isDrawable)
+		if(!visibleEntities.Contains(gizmo.entity))
 		{
 			continue;
 		}
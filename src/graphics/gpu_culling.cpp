@@ -0,0 +1,197 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <graphics/gpu_culling.h>
+#include <graphics/graphic_manager.h>
+#include <graphics/Mesh.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace dm
+{
+GpuCulling::GpuCulling() :
+	m_Pipeline("Shaders/culling.comp"),
+	m_Frame(0)
+{
+}
+
+bool GpuCulling::IsSupported()
+{
+	return GraphicManager::Get()->GetLogicalDevice()->GetEnabledFeatures().drawIndirectFirstInstance == VK_TRUE;
+}
+
+void GpuCulling::Clear()
+{
+	m_Objects.clear();
+	m_Commands.clear();
+}
+
+uint32_t GpuCulling::AddBatch(const Mesh& mesh, const std::vector<ObjectData>& objects)
+{
+	if (mesh.GetIndexBuffer() == nullptr)
+	{
+		return INVALID_BATCH;
+	}
+
+	const auto batch = static_cast<uint32_t>(m_Commands.size());
+
+	//Every object of the batch may be visible, its instance range is as large as the batch
+	VkDrawIndexedIndirectCommand command = {};
+	command.indexCount = mesh.GetIndexCount();
+	command.instanceCount = 0;
+	command.firstIndex = 0;
+	command.vertexOffset = 0;
+	command.firstInstance = static_cast<uint32_t>(m_Objects.size());
+	m_Commands.push_back(command);
+
+	for (const auto& object : objects)
+	{
+		m_Objects.push_back(object);
+		m_Objects.back().batch = batch;
+	}
+
+	return batch;
+}
+
+void GpuCulling::Dispatch(const CommandBuffer& commandBuffer, const Frustum& frustum)
+{
+	if (m_Objects.empty())
+	{
+		return;
+	}
+
+	const auto graphicManager = GraphicManager::Get();
+	while (m_Frames.size() < graphicManager->GetFrameCount())
+	{
+		m_Frames.push_back(Frame{ DescriptorHandle(m_Pipeline), UniformHandle(false) });
+	}
+
+	//The fence of the current frame is signaled, the previous dispatches and draws reading its buffers are done
+	m_Frame = graphicManager->GetCurrentFrame();
+	auto& frame = m_Frames[m_Frame];
+
+	const auto objectNmb = static_cast<uint32_t>(m_Objects.size());
+	const VkDeviceSize commandSize = sizeof(VkDrawIndexedIndirectCommand) * m_Commands.size();
+
+	Reserve(frame.objectBuffer, sizeof(ObjectData) * objectNmb, 0);
+	Reserve(frame.commandBuffer, commandSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+	Reserve(frame.instanceBuffer, sizeof(uint32_t) * objectNmb, 0);
+
+	void* mapped;
+	frame.objectBuffer->MapMemory(&mapped);
+	std::memcpy(mapped, m_Objects.data(), sizeof(ObjectData) * objectNmb);
+	frame.objectBuffer->UnmapMemory();
+
+	//The commands are written by the GPU so their instance counts are reset in order with the culling appending to them.
+	//If the dispatch is skipped the batches are drawn without instances
+	for (VkDeviceSize offset = 0; offset < commandSize; offset += MAX_UPDATE_SIZE)
+	{
+		vkCmdUpdateBuffer(commandBuffer, frame.commandBuffer->GetBuffer(), offset, std::min(MAX_UPDATE_SIZE, commandSize - offset),
+			reinterpret_cast<const char*>(m_Commands.data()) + offset);
+	}
+
+	VkMemoryBarrier resetBarrier = {};
+	resetBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	resetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	resetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+		0, 1, &resetBarrier, 0, nullptr, 0, nullptr);
+
+	for (size_t i = 0; i < Frustum::PLANE_NMB; i++)
+	{
+		frame.uniformCulling.Push("plane" + std::to_string(i), frustum.planes[i]);
+	}
+	frame.uniformCulling.Push("objectCount", objectNmb);
+
+	m_Pipeline.BindPipeline(commandBuffer);
+
+	frame.descriptorSet.Push("UboCulling", frame.uniformCulling);
+	frame.descriptorSet.Push("ObjectBuffer", frame.objectBuffer);
+	frame.descriptorSet.Push("DrawCommandBuffer", frame.commandBuffer);
+	frame.descriptorSet.Push("InstanceBuffer", frame.instanceBuffer);
+
+	if (!frame.descriptorSet.Update(m_Pipeline))
+	{
+		return;
+	}
+
+	frame.descriptorSet.BindDescriptor(commandBuffer, m_Pipeline);
+
+	const auto groupSize = m_Pipeline.GetShader()->GetLocalSizes()[0].value_or(1);
+	vkCmdDispatch(commandBuffer, (objectNmb + groupSize - 1) / groupSize, 1, 1);
+
+	//The instance counts and the instances are read by the indirect draws and the vertex shaders, the counts by ReadVisibleCount
+	VkMemoryBarrier memoryBarrier = {};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT, 
+		0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void GpuCulling::DrawBatch(const CommandBuffer& commandBuffer, const uint32_t batch) const
+{
+	if (batch >= m_Commands.size() || m_Frames.empty() || m_Frames[m_Frame].commandBuffer == nullptr)
+	{
+		return;
+	}
+
+	vkCmdDrawIndexedIndirect(commandBuffer, m_Frames[m_Frame].commandBuffer->GetBuffer(), sizeof(VkDrawIndexedIndirectCommand) * batch, 1, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+uint32_t GpuCulling::ReadVisibleCount() const
+{
+	if (m_Frames.empty() || m_Frames[m_Frame].commandBuffer == nullptr)
+	{
+		return 0;
+	}
+
+	GraphicManager::Get()->WaitFramesInFlight();
+
+	void* mapped;
+	m_Frames[m_Frame].commandBuffer->MapMemory(&mapped);
+	const auto commands = static_cast<const VkDrawIndexedIndirectCommand*>(mapped);
+
+	uint32_t visibleCount = 0;
+	for (size_t i = 0; i < m_Commands.size(); i++)
+	{
+		visibleCount += commands[i].instanceCount;
+	}
+	m_Frames[m_Frame].commandBuffer->UnmapMemory();
+
+	return visibleCount;
+}
+
+void GpuCulling::Reserve(std::unique_ptr<StorageBuffer>& buffer, const VkDeviceSize size, const VkBufferUsageFlags usage)
+{
+	if (buffer == nullptr || buffer->GetSize() < size)
+	{
+		//Grow by half to avoid a new allocation each time an object is added
+		buffer = std::make_unique<StorageBuffer>(size + size / 2, nullptr, usage);
+	}
+}
+}
@@ -322,7 +322,23 @@ void GraphicManager::Draw()
 
 void GraphicManager::Clear()
 {
-	delete(m_MainCamera);
+	//The main camera is owned by the camera storage
+	m_MainCamera = nullptr;
+	m_Views.resize(1);
+	m_Views.front() = VisibilityView();
+}
+
+const VisibilityView* GraphicManager::FindView(const ViewType type, const Entity entity) const
+{
+	for (const auto& view : m_Views)
+	{
+		if (view.type == type && view.entity == entity)
+		{
+			return &view;
+		}
+	}
+
+	return nullptr;
 }
 
 void GraphicManager::SetMainCamera(Camera* camera)
@@ -377,6 +393,8 @@ void GraphicManager::SetRenderStages(std::vector<std::unique_ptr<RenderStage>> r
 
 			m_CommandBuffers[i] = std::make_unique<CommandBuffer>(false);
 		}
+
+		m_UniformRing = std::make_unique<UniformRingBuffer>(UNIFORM_RING_FRAME_SIZE, m_Swapchain->GetImageCount());
 	}
 
 	for (const auto &renderStage : m_RenderStages)
@@ -400,6 +418,11 @@ const std::shared_ptr<CommandPool> &GraphicManager::GetCommandPool(const std::th
 	return m_CommandPools.find(threadId)->second; 
 }
 
+void GraphicManager::WaitFramesInFlight() const
+{
+	CheckVk(vkWaitForFences(*m_LogicalDevice, static_cast<uint32_t>(m_InFlightFences.size()), m_InFlightFences.data(), VK_TRUE, std::numeric_limits<uint64_t>::max()));
+}
+
 void GraphicManager::UpdateMainCamera() const
 {
 	const auto windowSize = Engine::Get()->GetSettings().windowSize;
@@ -448,6 +471,21 @@ bool GraphicManager::StartRenderpass(RenderStage& renderStage)
 	{
 		CheckVk(vkWaitForFences(*m_LogicalDevice, 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max()));
 		m_CommandBuffers[m_Swapchain->GetActiveImageIndex()]->Begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
+
+		//The GPU is done with the uniforms written the last time this frame was recorded
+		m_UniformRing->BeginFrame(static_cast<uint32_t>(m_CurrentFrame));
+
+		//First render pass of the frame
+		for (auto &[key, renderPipelines] : m_RenderManager->GetRendererContainer().GetStages())
+		{
+			for (auto &renderPipeline : renderPipelines)
+			{
+				if (renderPipeline->IsEnabled())
+				{
+					renderPipeline->PreDraw(*m_CommandBuffers[m_Swapchain->GetActiveImageIndex()]);
+				}
+			}
+		}
 	}
 
 	VkRect2D renderArea = {};
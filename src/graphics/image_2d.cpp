@@ -130,7 +130,7 @@ VkDescriptorSetLayoutBinding Image2d::GetDescriptorSetLayout(const uint32_t& bin
 	VkDescriptorSetLayoutBinding descriptorSet = {};
 	descriptorSet.binding = binding;
 	descriptorSet.descriptorType = descriptorType;
-	descriptorSet.descriptorCount = 1;
+	descriptorSet.descriptorCount = count;
 	descriptorSet.stageFlags = stage;
 	descriptorSet.pImmutableSamplers = nullptr;
 	return descriptorSet;
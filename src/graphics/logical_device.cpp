@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <graphics/logical_device.h>
 #include <graphics/graphic_manager.h>
+#include <cstring>
 
 namespace dm
 {
@@ -40,7 +41,8 @@ LogicalDevice::LogicalDevice(const Instance* instance, const PhysicalDevice* phy
 	m_GraphicsQueue(VK_NULL_HANDLE),
 	m_PresentQueue(VK_NULL_HANDLE),
 	m_ComputeQueue(VK_NULL_HANDLE),
-	m_TransferQueue(VK_NULL_HANDLE)
+	m_TransferQueue(VK_NULL_HANDLE),
+	m_DescriptorIndexing(false)
 {
 	CreateQueueIndices();
 	CreateLogicalDevice();
@@ -53,6 +55,24 @@ LogicalDevice::~LogicalDevice()
 	vkDestroyDevice(m_LogicalDevice, nullptr);
 }
 
+bool LogicalDevice::IsExtensionSupported(const char* extensionName) const
+{
+	uint32_t extensionPropertyCount;
+	vkEnumerateDeviceExtensionProperties(*m_PhysicalDevice, nullptr, &extensionPropertyCount, nullptr);
+	std::vector<VkExtensionProperties> extensionProperties(extensionPropertyCount);
+	vkEnumerateDeviceExtensionProperties(*m_PhysicalDevice, nullptr, &extensionPropertyCount, extensionProperties.data());
+
+	for (const auto &extension : extensionProperties)
+	{
+		if (strcmp(extensionName, extension.extensionName) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void LogicalDevice::CreateQueueIndices()
 {
 	uint32_t deviceQueueFamilyPropertyCount;
@@ -208,6 +228,16 @@ void LogicalDevice::CreateLogicalDevice()
 		enabledFeatures.textureCompressionETC2 = VK_TRUE;
 	}
 
+	// Indirect draws reading their instances at an offset, required by the GPU driven culling.
+	if (physicalDeviceFeatures.drawIndirectFirstInstance)
+	{
+		enabledFeatures.drawIndirectFirstInstance = VK_TRUE;
+	}
+	else
+	{
+		std::cout << "Selected GPU does not support indirect draws with a first instance!\n";
+	}
+
 	if (physicalDeviceFeatures.vertexPipelineStoresAndAtomics)
 	{
 		enabledFeatures.vertexPipelineStoresAndAtomics = VK_TRUE;
@@ -274,14 +304,48 @@ void LogicalDevice::CreateLogicalDevice()
 		std::cout << "Selected GPU does not support multi viewports!\n";
 	}
 
+	auto deviceExtensions = m_Instance->GetDeviceExtensions();
+
+	// Descriptor indexing lets the materials sample the textures of the TextureManager by index.
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+	descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+	if (IsExtensionSupported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedIndexingFeatures = {};
+		supportedIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		physicalDeviceFeatures2.pNext = &supportedIndexingFeatures;
+		vkGetPhysicalDeviceFeatures2(*m_PhysicalDevice, &physicalDeviceFeatures2);
+
+		if (supportedIndexingFeatures.shaderSampledImageArrayNonUniformIndexing && supportedIndexingFeatures.runtimeDescriptorArray &&
+			supportedIndexingFeatures.descriptorBindingPartiallyBound && supportedIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind)
+		{
+			descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+			descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+			descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			deviceExtensions.emplace_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			m_DescriptorIndexing = true;
+		}
+	}
+
+	if (!m_DescriptorIndexing)
+	{
+		std::cout << "Selected GPU does not support descriptor indexing, textures are bound per material!\n";
+	}
+
 	VkDeviceCreateInfo deviceCreateInfo = {};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceCreateInfo.pNext = m_DescriptorIndexing ? &descriptorIndexingFeatures : nullptr;
 	deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 	deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(m_Instance->GetInstanceLayers().size());
 	deviceCreateInfo.ppEnabledLayerNames = m_Instance->GetInstanceLayers().data();
-	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(m_Instance->GetDeviceExtensions().size());
-	deviceCreateInfo.ppEnabledExtensionNames = m_Instance->GetDeviceExtensions().data();
+	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+	deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 	deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
 	GraphicManager::CheckVk(vkCreateDevice(*m_PhysicalDevice, &deviceCreateInfo, nullptr, &m_LogicalDevice));
 
@@ -0,0 +1,90 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <graphics/object_buffer.h>
+#include <graphics/descriptor_handle.h>
+#include <graphics/graphic_manager.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace dm
+{
+ObjectBuffer::ObjectBuffer() :
+	m_Count(0),
+	m_FirstIndex(0),
+	m_Capacity(0),
+	m_FrameCount(0)
+{}
+
+void ObjectBuffer::Clear()
+{
+	m_Count = 0;
+}
+
+uint32_t ObjectBuffer::Add(const ObjectData& object)
+{
+	if (m_Count == m_Objects.size())
+	{
+		m_Objects.resize(std::max<size_t>(64, m_Objects.size() + m_Objects.size() / 2));
+	}
+
+	m_Objects[m_Count] = object;
+	return m_Count++;
+}
+
+void ObjectBuffer::Upload()
+{
+	if (m_Count == 0)
+	{
+		return;
+	}
+
+	const auto graphicManager = GraphicManager::Get();
+	const auto frameCount = graphicManager->GetFrameCount();
+
+	if (m_Storage == nullptr || m_Capacity < m_Objects.size() || m_FrameCount != frameCount)
+	{
+		//The previous frames may still read the old buffer and the sets pointing to it
+		graphicManager->WaitFramesInFlight();
+
+		m_Capacity = static_cast<uint32_t>(m_Objects.size());
+		m_FrameCount = frameCount;
+		m_Storage = std::make_unique<StorageBuffer>(sizeof(ObjectData) * m_Capacity * m_FrameCount);
+	}
+
+	//The fence of the current frame is signaled, the GPU is done with its region
+	m_FirstIndex = graphicManager->GetCurrentFrame() * m_Capacity;
+
+	void* mapped;
+	m_Storage->MapMemory(&mapped);
+	std::memcpy(static_cast<char*>(mapped) + sizeof(ObjectData) * m_FirstIndex, m_Objects.data(), sizeof(ObjectData) * m_Count);
+	m_Storage->UnmapMemory();
+}
+
+void ObjectBuffer::PushDescriptor(DescriptorHandle& descriptorSet)
+{
+	descriptorSet.Push("ObjectBuffer", m_Storage);
+}
+}
@@ -0,0 +1,385 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <graphics/occlusion_buffer.h>
+#include <engine/simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace dm
+{
+namespace
+{
+const float INFINITE_DEPTH = std::numeric_limits<float>::max();
+
+//Smallest w kept in front of the camera, below it the perspective divide is meaningless
+const float MIN_CLIP_W = 1e-5f;
+
+const uint32_t ROW_ALIGNMENT = 8;
+
+/**
+ * \brief Triangle in pixel space, evaluated at the texel centers. edgeC is biased so edge i is only positive at a center when the
+ * whole texel is inside it, and depthOrigin so the depth plane gives the farthest depth over the texel
+ */
+struct TriangleSetup
+{
+	float edgeA[3];
+	float edgeB[3];
+	float edgeC[3];
+	float depthX;
+	float depthY;
+	float depthOrigin;
+	uint32_t minX;
+	uint32_t maxX;
+	uint32_t minY;
+	uint32_t maxY;
+};
+
+#ifdef DM_SIMD_ENABLED
+/**
+ * \brief Test Simd::WIDTH pixel centers of a row against the three edges at once, the coverage mask selects the texels
+ * fully inside the triangle where its farthest depth over the texel is kept if it is nearer
+ */
+template<typename Simd>
+void RasterizeRows(const TriangleSetup& triangle, float* depths, const uint32_t width)
+{
+	static const float LANE_OFFSETS[] = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+
+	const auto zero = Simd::Set(0.0f);
+	const auto laneOffsets = Simd::Load(LANE_OFFSETS);
+	const auto startX = triangle.minX / Simd::WIDTH * Simd::WIDTH;
+
+	const auto edgeA0 = Simd::Set(triangle.edgeA[0]);
+	const auto edgeA1 = Simd::Set(triangle.edgeA[1]);
+	const auto edgeA2 = Simd::Set(triangle.edgeA[2]);
+	const auto depthX = Simd::Set(triangle.depthX);
+
+	for (auto y = triangle.minY; y <= triangle.maxY; y++)
+	{
+		const auto centerY = static_cast<float>(y) + 0.5f;
+		const auto row0 = Simd::Set(triangle.edgeB[0] * centerY + triangle.edgeC[0]);
+		const auto row1 = Simd::Set(triangle.edgeB[1] * centerY + triangle.edgeC[1]);
+		const auto row2 = Simd::Set(triangle.edgeB[2] * centerY + triangle.edgeC[2]);
+		const auto rowDepth = Simd::Set(triangle.depthY * centerY + triangle.depthOrigin);
+
+		auto* rowDepths = depths + y * width;
+
+		for (auto x = startX; x <= triangle.maxX; x += Simd::WIDTH)
+		{
+			const auto centerX = Simd::Add(Simd::Set(static_cast<float>(x)), laneOffsets);
+
+			const auto covered = Simd::And(
+				Simd::And(
+					Simd::GreaterEqual(Simd::Add(Simd::Mul(edgeA0, centerX), row0), zero),
+					Simd::GreaterEqual(Simd::Add(Simd::Mul(edgeA1, centerX), row1), zero)),
+				Simd::GreaterEqual(Simd::Add(Simd::Mul(edgeA2, centerX), row2), zero));
+
+			if (Simd::MoveMask(covered) == 0)
+			{
+				continue;
+			}
+
+			const auto depth = Simd::Add(Simd::Mul(depthX, centerX), rowDepth);
+			const auto previousDepth = Simd::Load(rowDepths + x);
+			const auto nearestDepth = Simd::Min(previousDepth, depth);
+
+			Simd::Store(rowDepths + x, Simd::Or(Simd::And(covered, nearestDepth), Simd::AndNot(covered, previousDepth)));
+		}
+	}
+}
+#else
+void RasterizeRowsScalar(const TriangleSetup& triangle, float* depths, const uint32_t width)
+{
+	for (auto y = triangle.minY; y <= triangle.maxY; y++)
+	{
+		const auto centerY = static_cast<float>(y) + 0.5f;
+
+		for (auto x = triangle.minX; x <= triangle.maxX; x++)
+		{
+			const auto centerX = static_cast<float>(x) + 0.5f;
+
+			auto isCovered = true;
+			for (auto edge = 0; edge < 3; edge++)
+			{
+				isCovered &= triangle.edgeA[edge] * centerX + triangle.edgeB[edge] * centerY + triangle.edgeC[edge] >= 0.0f;
+			}
+
+			if (isCovered)
+			{
+				auto& depth = depths[y * width + x];
+				depth = std::min(depth, triangle.depthX * centerX + triangle.depthY * centerY + triangle.depthOrigin);
+			}
+		}
+	}
+}
+#endif
+}
+
+OcclusionBuffer::OcclusionBuffer(const uint32_t width, const uint32_t height)
+{
+	if (width == 0 || height == 0)
+	{
+		throw std::runtime_error("Occlusion buffer must have at least one texel");
+	}
+
+	auto levelWidth = (width + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+	auto levelHeight = height;
+
+	while (true)
+	{
+		m_Levels.push_back({ levelWidth, levelHeight, std::vector<float>(levelWidth * levelHeight, INFINITE_DEPTH) });
+
+		if (levelWidth == 1 && levelHeight == 1)
+		{
+			break;
+		}
+
+		levelWidth = (levelWidth + 1) / 2;
+		levelHeight = (levelHeight + 1) / 2;
+	}
+}
+
+void OcclusionBuffer::Clear(const glm::mat4x4& viewProjection)
+{
+	m_ViewProjection = viewProjection;
+
+	for (auto& level : m_Levels)
+	{
+		std::fill(level.depths.begin(), level.depths.end(), INFINITE_DEPTH);
+	}
+}
+
+void OcclusionBuffer::Rasterize(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4x4& worldMatrix)
+{
+	const auto worldViewProjection = m_ViewProjection * worldMatrix;
+
+	m_ClipPositions.resize(positions.size());
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		m_ClipPositions[i] = worldViewProjection * glm::vec4(positions[i], 1.0f);
+	}
+
+	if (indices.empty())
+	{
+		for (size_t i = 0; i + 2 < m_ClipPositions.size(); i += 3)
+		{
+			RasterizeTriangle(m_ClipPositions[i], m_ClipPositions[i + 1], m_ClipPositions[i + 2]);
+		}
+		return;
+	}
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		RasterizeTriangle(m_ClipPositions[indices[i]], m_ClipPositions[indices[i + 1]], m_ClipPositions[indices[i + 2]]);
+	}
+}
+
+void OcclusionBuffer::RasterizeTriangle(const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2)
+{
+	if (clip0.w < MIN_CLIP_W || clip1.w < MIN_CLIP_W || clip2.w < MIN_CLIP_W)
+	{
+		return;
+	}
+
+	auto& level = m_Levels.front();
+	const auto width = static_cast<float>(level.width);
+	const auto height = static_cast<float>(level.height);
+
+	glm::vec3 screen[3];
+	const glm::vec4* clips[] = { &clip0, &clip1, &clip2 };
+	for (auto i = 0; i < 3; i++)
+	{
+		const auto inverseW = 1.0f / clips[i]->w;
+		screen[i] = glm::vec3(
+			(clips[i]->x * inverseW * 0.5f + 0.5f) * width,
+			(clips[i]->y * inverseW * 0.5f + 0.5f) * height,
+			clips[i]->z * inverseW);
+	}
+
+	auto area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+	if (std::abs(area) < std::numeric_limits<float>::epsilon())
+	{
+		return;
+	}
+
+	//Both faces are occluding, the winding is made counter clockwise so the inside of every edge is positive
+	if (area < 0.0f)
+	{
+		std::swap(screen[1], screen[2]);
+		area = -area;
+	}
+
+	const auto minX = std::max(std::floor(std::min({ screen[0].x, screen[1].x, screen[2].x })), 0.0f);
+	const auto maxX = std::min(std::floor(std::max({ screen[0].x, screen[1].x, screen[2].x })), width - 1.0f);
+	const auto minY = std::max(std::floor(std::min({ screen[0].y, screen[1].y, screen[2].y })), 0.0f);
+	const auto maxY = std::min(std::floor(std::max({ screen[0].y, screen[1].y, screen[2].y })), height - 1.0f);
+
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	TriangleSetup triangle{};
+	for (auto edge = 0; edge < 3; edge++)
+	{
+		const auto& from = screen[edge];
+		const auto& to = screen[(edge + 1) % 3];
+
+		triangle.edgeA[edge] = from.y - to.y;
+		triangle.edgeB[edge] = to.x - from.x;
+
+		//An occluder only writes the texels it fully covers, the edge is evaluated at the corner of the texel the farthest inside it
+		triangle.edgeC[edge] = -(triangle.edgeA[edge] * from.x + triangle.edgeB[edge] * from.y) -
+			0.5f * (std::abs(triangle.edgeA[edge]) + std::abs(triangle.edgeB[edge]));
+	}
+
+	const auto inverseArea = 1.0f / area;
+	triangle.depthX = ((screen[1].z - screen[0].z) * (screen[2].y - screen[0].y) - (screen[2].z - screen[0].z) * (screen[1].y - screen[0].y)) * inverseArea;
+	triangle.depthY = ((screen[2].z - screen[0].z) * (screen[1].x - screen[0].x) - (screen[1].z - screen[0].z) * (screen[2].x - screen[0].x)) * inverseArea;
+
+	//The depth written is the farthest one over the texel, at its corner the farthest along the depth gradient
+	triangle.depthOrigin = screen[0].z - triangle.depthX * screen[0].x - triangle.depthY * screen[0].y +
+		0.5f * (std::abs(triangle.depthX) + std::abs(triangle.depthY));
+
+	triangle.minX = static_cast<uint32_t>(minX);
+	triangle.maxX = static_cast<uint32_t>(maxX);
+	triangle.minY = static_cast<uint32_t>(minY);
+	triangle.maxY = static_cast<uint32_t>(maxY);
+
+#ifdef DM_SIMD_ENABLED
+	RasterizeRows<SimdNative>(triangle, level.depths.data(), level.width);
+#else
+	RasterizeRowsScalar(triangle, level.depths.data(), level.width);
+#endif
+}
+
+void OcclusionBuffer::BuildHierarchy()
+{
+	for (size_t i = 1; i < m_Levels.size(); i++)
+	{
+		const auto& below = m_Levels[i - 1];
+		auto& level = m_Levels[i];
+
+		for (uint32_t y = 0; y < level.height; y++)
+		{
+			const auto y0 = y * 2;
+			const auto y1 = std::min(y0 + 1, below.height - 1);
+
+			for (uint32_t x = 0; x < level.width; x++)
+			{
+				const auto x0 = x * 2;
+				const auto x1 = std::min(x0 + 1, below.width - 1);
+
+				level.depths[y * level.width + x] = std::max({
+					below.depths[y0 * below.width + x0], below.depths[y0 * below.width + x1],
+					below.depths[y1 * below.width + x0], below.depths[y1 * below.width + x1] });
+			}
+		}
+	}
+}
+
+bool OcclusionBuffer::IsOccluded(const glm::vec3& center, const float radius) const
+{
+	return IsOccluded(Aabb::FromSphere(center, radius));
+}
+
+bool OcclusionBuffer::IsOccluded(const Aabb& box) const
+{
+	//Clip space is linear, the corners of the box are the center plus or minus the three scaled axes
+	const auto extents = box.GetExtents();
+	const auto clipCenter = m_ViewProjection * glm::vec4(box.GetCenter(), 1.0f);
+	const auto axisX = m_ViewProjection[0] * extents.x;
+	const auto axisY = m_ViewProjection[1] * extents.y;
+	const auto axisZ = m_ViewProjection[2] * extents.z;
+
+	auto minX = INFINITE_DEPTH;
+	auto minY = INFINITE_DEPTH;
+	auto maxX = -INFINITE_DEPTH;
+	auto maxY = -INFINITE_DEPTH;
+	auto nearestDepth = INFINITE_DEPTH;
+
+	for (auto corner = 0; corner < 8; corner++)
+	{
+		const auto clip = clipCenter +
+			(corner & 1 ? axisX : -axisX) +
+			(corner & 2 ? axisY : -axisY) +
+			(corner & 4 ? axisZ : -axisZ);
+
+		//The box reaches the camera, it can't be behind anything
+		if (clip.w < MIN_CLIP_W)
+		{
+			return false;
+		}
+
+		const auto inverseW = 1.0f / clip.w;
+		minX = std::min(minX, clip.x * inverseW);
+		maxX = std::max(maxX, clip.x * inverseW);
+		minY = std::min(minY, clip.y * inverseW);
+		maxY = std::max(maxY, clip.y * inverseW);
+		nearestDepth = std::min(nearestDepth, clip.z * inverseW);
+	}
+
+	const auto& base = m_Levels.front();
+	const auto width = static_cast<float>(base.width);
+	const auto height = static_cast<float>(base.height);
+
+	const auto screenMinX = (minX * 0.5f + 0.5f) * width;
+	const auto screenMaxX = (maxX * 0.5f + 0.5f) * width;
+	const auto screenMinY = (minY * 0.5f + 0.5f) * height;
+	const auto screenMaxY = (maxY * 0.5f + 0.5f) * height;
+
+	//Outside of the screen is the business of the frustum culling
+	if (screenMaxX < 0.0f || screenMaxY < 0.0f || screenMinX >= width || screenMinY >= height)
+	{
+		return false;
+	}
+
+	const auto x0 = static_cast<uint32_t>(std::max(screenMinX, 0.0f));
+	const auto y0 = static_cast<uint32_t>(std::max(screenMinY, 0.0f));
+	const auto x1 = static_cast<uint32_t>(std::min(screenMaxX, width - 1.0f));
+	const auto y1 = static_cast<uint32_t>(std::min(screenMaxY, height - 1.0f));
+
+	//Coarsest level where the rectangle spans at most two texels per axis
+	size_t levelIndex = 0;
+	while (levelIndex + 1 < m_Levels.size() &&
+		((x1 >> levelIndex) - (x0 >> levelIndex) > 1 || (y1 >> levelIndex) - (y0 >> levelIndex) > 1))
+	{
+		levelIndex++;
+	}
+
+	const auto& level = m_Levels[levelIndex];
+	auto farthestDepth = -INFINITE_DEPTH;
+	for (auto y = y0 >> levelIndex; y <= y1 >> levelIndex; y++)
+	{
+		for (auto x = x0 >> levelIndex; x <= x1 >> levelIndex; x++)
+		{
+			farthestDepth = std::max(farthestDepth, level.depths[y * level.width + x]);
+		}
+	}
+
+	return nearestDepth > farthestDepth;
+}
+}
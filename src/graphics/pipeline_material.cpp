@@ -27,6 +27,7 @@ SOFTWARE.
 #include <graphics/graphic_manager.h>
 #include <engine/engine.h>
 #include <graphics/pipeline_material_manager.h>
+#include <graphics/texture_manager.h>
 
 namespace dm
 {
@@ -67,6 +68,11 @@ bool PipelineMaterial::BindPipeline(const CommandBuffer& commandBuffer)
 	}
 
 	m_Pipeline->BindPipeline(commandBuffer);
+
+	if (m_Pipeline->GetShader()->IsBindless())
+	{
+		TextureManager::Get()->BindDescriptor(commandBuffer, *m_Pipeline);
+	}
 	return true;
 }
 }
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <graphics/pipelines/pipeline_graphic.h>
 
 #include <graphics/graphic_manager.h>
+#include <graphics/texture_manager.h>
 #include "engine/file.h"
 #include <iostream>
 
@@ -195,10 +196,17 @@ void PipelineGraphics::CreatePipelineLayout()
 
 	auto pushConstantRanges = m_Shader->GetPushConstantRanges();
 
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { m_DescriptorSetLayout };
+
+	if (m_Shader->IsBindless())
+	{
+		descriptorSetLayouts.emplace_back(TextureManager::Get()->GetDescriptorSetLayout());
+	}
+
 	VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
 	pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutCreateInfo.setLayoutCount = 1;
-	pipelineLayoutCreateInfo.pSetLayouts = &m_DescriptorSetLayout;
+	pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+	pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
 	pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
 	pipelineLayoutCreateInfo.pPushConstantRanges = pushConstantRanges.data();
 	GraphicManager::CheckVk(vkCreatePipelineLayout(*logicalDevice, &pipelineLayoutCreateInfo, nullptr, &m_PipelineLayout));
@@ -36,6 +36,7 @@ namespace dm
 {
 Shader::Shader(std::string name):
 	m_Name(std::move(name)),
+	m_Bindless(false),
 	m_LastDescriptorBinding(0)
 {}
 
@@ -69,6 +70,10 @@ void Shader::ProcessShader()
 			descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 			m_DescriptorSetLayout.emplace_back(UniformBuffer::GetDescriptorSetLayout(static_cast<uint32_t>(uniformBlock.m_Binding), descriptorType, uniformBlock.m_StageFlags, 1));
 			break;
+		case UniformBlock::Type::Dynamic:
+			descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			m_DescriptorSetLayout.emplace_back(UniformBuffer::GetDescriptorSetLayout(static_cast<uint32_t>(uniformBlock.m_Binding), descriptorType, uniformBlock.m_StageFlags, 1));
+			break;
 		case UniformBlock::Type::Storage:
 			descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			m_DescriptorSetLayout.emplace_back(StorageBuffer::GetDescriptorSetLayout(static_cast<uint32_t>(uniformBlock.m_Binding), descriptorType, uniformBlock.m_StageFlags, 1));
@@ -121,7 +126,7 @@ void Shader::ProcessShader()
 	}
 
 	// FIXME: This is a AMD workaround that works on Nvidia too
-	m_DescriptorPools = std::vector<VkDescriptorPoolSize>(6);
+	m_DescriptorPools = std::vector<VkDescriptorPoolSize>(7);
 	m_DescriptorPools[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	m_DescriptorPools[0].descriptorCount = 4096;
 	m_DescriptorPools[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -134,6 +139,8 @@ void Shader::ProcessShader()
 	m_DescriptorPools[4].descriptorCount = 2048;
 	m_DescriptorPools[5].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 	m_DescriptorPools[5].descriptorCount = 2048;
+	m_DescriptorPools[6].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	m_DescriptorPools[6].descriptorCount = 2048;
 
 	// Sort descriptors by binding.
 	std::sort(m_DescriptorSetLayout.begin(), m_DescriptorSetLayout.end(), [](const VkDescriptorSetLayoutBinding &l, const VkDescriptorSetLayoutBinding &r)
@@ -760,6 +767,11 @@ void Shader::LoadUniformBlock(const glslang::TProgram& program, const VkShaderSt
 
 	auto type = UniformBlock::Type::Uniform;
 
+	if (program.getUniformBlockName(i) == std::string(DYNAMIC_UNIFORM_BLOCK))
+	{
+		type = UniformBlock::Type::Dynamic;
+	}
+
 	if (strcmp(program.getUniformBlockTType(i)->getStorageQualifierString(), "buffer") == 0)
 	{
 		type = UniformBlock::Type::Storage;
@@ -795,6 +807,15 @@ void Shader::LoadUniform(const glslang::TProgram& program, const VkShaderStageFl
 		}
 	}
 
+	auto &qualifier = program.getUniformTType(i)->getQualifier();
+
+	// The texture table is bound by the TextureManager.
+	if (qualifier.hasSet() && qualifier.layoutSet == BINDLESS_SET)
+	{
+		m_Bindless = true;
+		return;
+	}
+
 	for (auto &[uniformName, uniform] : m_Uniform)
 	{
 		if (uniformName == program.getUniformName(i))
@@ -804,7 +825,6 @@ void Shader::LoadUniform(const glslang::TProgram& program, const VkShaderStageFl
 		}
 	}
 
-	auto &qualifier = program.getUniformTType(i)->getQualifier();
 	m_Uniform.emplace(program.getUniformName(i),
 		Uniform(program.getUniformBinding(i), program.getUniformBufferOffset(i), -1, program.getUniformType(i), qualifier.readonly, qualifier.writeonly, stageFlag));
 }
@@ -0,0 +1,61 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <graphics/render_pipeline.h>
+#include <engine/engine.h>
+#include <graphics/graphic_manager.h>
+
+namespace dm
+{
+const EntitySet& RenderPipeline::GetRegisteredEntities()
+{
+	if (m_RegisteredEntities == nullptr)
+	{
+		m_RegisteredEntities = &Engine::Get()->GetEntityManager()->GetQuery(m_Signature);
+	}
+
+	return *m_RegisteredEntities;
+}
+
+const std::vector<Entity>& RenderPipeline::GetVisibleEntities()
+{
+	return GetVisibleEntities(GraphicManager::Get()->GetVisibleEntities());
+}
+
+const std::vector<Entity>& RenderPipeline::GetVisibleEntities(const EntitySet& visibleEntities)
+{
+	const auto entityManager = Engine::Get()->GetEntityManager();
+
+	m_VisibleEntities.clear();
+	for (const auto entity : visibleEntities)
+	{
+		if (entityManager->GetEntityMask(entity).Matches(m_Signature))
+		{
+			m_VisibleEntities.push_back(entity);
+		}
+	}
+
+	return m_VisibleEntities;
+}
+}
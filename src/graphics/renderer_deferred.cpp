@@ -28,7 +28,7 @@ SOFTWARE.
 #include "engine/engine.h"
 #include <component/component_manager.h>
 #include "graphics/pipelines/pipeline_compute.h"
-#include "entity/entity_handle.h"
+#include <component/component_view.h>
 #include "component/lights/spot_light.h"
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
@@ -52,28 +52,18 @@ void RendererDeferred::Draw(const CommandBuffer& commandBuffer)
 {
 	auto camera = GraphicManager::Get()->GetCamera();
 
+	const auto componentManager = Engine::Get()->GetComponentManager();
+
 	if(m_Skybox == nullptr)
 	{
-		auto entities = Engine::Get()->GetEntityManager()->GetEntities();
+		const auto& skyboxes = componentManager->GetManager<MaterialSkybox>()->GetComponents();
 
-		for (auto entity : entities)
+		if (!skyboxes.Empty())
 		{
-			if (entity == INVALID_ENTITY)
-			{
-				break;
-			}
-
-			auto entityHandle = EntityHandle(entity);
-
-			if (entityHandle.HasComponent(ComponentType::MATERIAL_SKYBOX))
-			{
-				m_Skybox = entityHandle.GetComponent<MaterialSkybox>(ComponentType::MATERIAL_SKYBOX)->image;
-
-				m_CurrentPrefiltered = ComputePrefiltered(m_Skybox, 512);
-				m_CurrentIrradiance = ComputeIrradiance(m_Skybox, 64);
+			m_Skybox = skyboxes.begin()->image;
 
-				break;
-			}
+			m_CurrentPrefiltered = ComputePrefiltered(m_Skybox, 512);
+			m_CurrentIrradiance = ComputeIrradiance(m_Skybox, 64);
 		}
 	}
 
@@ -85,66 +75,48 @@ void RendererDeferred::Draw(const CommandBuffer& commandBuffer)
 	glm::vec3 directionalDirection = glm::vec3(-1.0f, -1.0f, 0.0f);
 	glm::vec4 directionalColor;
 
-	for(auto entity : Engine::Get()->GetEntityManager()->GetEntities())
+	//Point lights
+	View<PointLight, Transform>(*componentManager).ForEach([&](Entity, PointLight& light, Transform& transform)
 	{
-		auto entityHandle = EntityHandle(entity);
-
-		if (entity == INVALID_ENTITY)
+		if (pointLightCount + spotLightCount >= MAX_LIGHTS)
 		{
-			break;
+			return;
 		}
 
-		//Point lights
-		if (entityHandle.HasComponent(ComponentType::POINT_LIGHT))
-		{
-			const auto light = entityHandle.GetComponent<PointLight>(ComponentType::POINT_LIGHT);
-			const auto transform = entityHandle.GetComponent<Transform>(ComponentType::TRANSFORM);
-
-			DeferredPointLight deferredLight = {};
-			deferredLight.color = light->color * light->intensity;
-			deferredLight.radius = light->radius;
-			deferredLight.position = transform->position;
+		DeferredPointLight deferredLight = {};
+		deferredLight.color = light.color * light.intensity;
+		deferredLight.radius = light.radius;
+		deferredLight.position = transform.position;
 
-			deferredPointLights[pointLightCount] = deferredLight;
-			pointLightCount++;
+		deferredPointLights[pointLightCount] = deferredLight;
+		pointLightCount++;
+	});
 
-			if (pointLightCount + spotLightCount >= MAX_LIGHTS)
-			{
-				break;
-			}
-		}
+	//Directional
+	View<DirectionalLight>(*componentManager).ForEach([&](Entity, DirectionalLight& light)
+	{
+		directionalDirection = light.direction;
+		directionalColor = glm::vec4(light.color.r, light.color.g, light.color.b, light.color.a) * light.intensity;
+	});
 
-		//Directional
-		if (entityHandle.HasComponent(ComponentType::DIRECTIONAL_LIGHT))
+	//Spot lights
+	View<SpotLight, Transform>(*componentManager).ForEach([&](Entity, SpotLight& light, Transform& transform)
+	{
+		if (pointLightCount + spotLightCount >= MAX_LIGHTS)
 		{
-			const auto light = entityHandle.GetComponent<DirectionalLight>(ComponentType::DIRECTIONAL_LIGHT);
-
-			directionalDirection = light->direction;
-			directionalColor = glm::vec4(light->color.r, light->color.g, light->color.b, light->color.a) * light->intensity;
+			return;
 		}
 
-		//Spot lights
-		if (entityHandle.HasComponent(ComponentType::SPOT_LIGHT))
-		{
-			const auto light = entityHandle.GetComponent<SpotLight>(ComponentType::SPOT_LIGHT);
-			const auto transform = entityHandle.GetComponent<Transform>(ComponentType::TRANSFORM);
-
-			DeferredSpotLight deferredLight = {};
-			deferredLight.color = light->color * light->intensity;
-			deferredLight.target = light->target + transform->position;
-			deferredLight.range = light->range;
-			deferredLight.position = transform->position;
-			deferredLight.angle = light->angle;
-
-			deferredSpotLights[spotLightCount] = deferredLight;
-			spotLightCount++;
-
-			if (pointLightCount + spotLightCount >= MAX_LIGHTS)
-			{
-				break;
-			}
-		}
-	}
+		DeferredSpotLight deferredLight = {};
+		deferredLight.color = light.color * light.intensity;
+		deferredLight.target = light.target + transform.position;
+		deferredLight.range = light.range;
+		deferredLight.position = transform.position;
+		deferredLight.angle = light.angle;
+
+		deferredSpotLights[spotLightCount] = deferredLight;
+		spotLightCount++;
+	});
 
 
 	//Compute lightSpaceMatrix
@@ -26,7 +26,7 @@ SOFTWARE.
 #include "component/model.h"
 #include "graphics/buffers/uniform_handle.h"
 #include "engine/engine.h"
-#include "entity/entity_handle.h"
+#include <component/component_view.h>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 #include <graphics/graphic_manager.h>
@@ -35,12 +35,15 @@ namespace dm
 {
 RendererDirectionalShadow::RendererDirectionalShadow(const Pipeline::Stage& stage): 
 	RenderPipeline(stage),
-	m_Pipeline(stage, { "Shaders/shadow_directional.vert", "Shaders/shadow_directional.frag" }, { VertexMesh::GetVertexInput() }, {}, PipelineGraphics::Mode::MRT, PipelineGraphics::Depth::READ_WRITE, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT)
+	m_Pipeline(stage, { "Shaders/shadow_directional.vert", "Shaders/shadow_directional.frag" }, { VertexMesh::GetVertexInput() }, { { "INSTANCING", "0" } }, PipelineGraphics::Mode::MRT, PipelineGraphics::Depth::READ_WRITE, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT),
+	m_PipelineInstanced(stage, { "Shaders/shadow_directional.vert", "Shaders/shadow_directional.frag" }, { VertexMesh::GetVertexInput(), Instance::GetVertexInput() }, { { "INSTANCING", "1" } }, PipelineGraphics::Mode::MRT, PipelineGraphics::Depth::READ_WRITE, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT),
+	m_UniformObject(false)
 {
 	m_Signature.AddComponent(ComponentType::MESH_RENDERER);
 	m_Signature.AddComponent(ComponentType::SHADOW_RENDERER);
 	m_Signature.AddComponent(ComponentType::MODEL);
 	m_Signature.AddComponent(ComponentType::TRANSFORM);
+	m_Signature.AddComponent(ComponentType::DRAWABLE);
 }
 
 void RendererDirectionalShadow::Update()
@@ -51,117 +54,126 @@ void RendererDirectionalShadow::Draw(const CommandBuffer& commandBuffer)
 {
 	//Get Directional Light
 	glm::vec3 lightDirection = glm::vec3(0, -1, 0);
+	auto lightEntity = INVALID_ENTITY;
 
-	auto entities = Engine::Get()->GetEntityManager()->GetEntities();
+	const auto componentManager = Engine::Get()->GetComponentManager();
+	const auto& directionalLights = componentManager->GetManager<DirectionalLight>()->GetComponents();
 
-	for (auto entity : entities)
+	if (!directionalLights.Empty())
 	{
-		if (entity == INVALID_ENTITY)
-		{
-			break;
-		}
+		lightDirection = directionalLights.begin()->direction;
+		lightEntity = directionalLights.begin().GetEntity();
+	}
 
-		auto entityHandle = EntityHandle(entity);
+	//The culling already built the light box and the casters reaching it, otherwise every caster is drawn
+	const auto shadowView = GraphicManager::Get()->FindView(ViewType::DIRECTIONAL_LIGHT, lightEntity);
 
-		if (entityHandle.HasComponent(ComponentType::DIRECTIONAL_LIGHT))
-		{
-			const auto light = entityHandle.GetComponent<DirectionalLight>(ComponentType::DIRECTIONAL_LIGHT);
+	const auto camera = GraphicManager::Get()->GetCamera();
+	const auto lightSpaceMatrix = shadowView != nullptr ?
+		shadowView->viewProjection :
+		DirectionalLightManager::ComputeLightSpaceMatrix(*camera, lightDirection);
 
-			lightDirection = light->direction;
-			break;
-		}
-	}
+	const View<Transform, Model, ShadowRenderer> view(*componentManager);
 
-	//Compute lightSpaceMatrix
-	const auto camera = GraphicManager::Get()->GetCamera();
+	const auto& casters = shadowView != nullptr ?
+		GetVisibleEntities(shadowView->visibleEntities) :
+		GetRegisteredEntities().GetEntities();
 
-	glm::vec3 frustumCorners[8] = {
-	glm::vec3(-1.0f,  1.0f, -1.0f),
-	glm::vec3(1.0f,  1.0f, -1.0f),
-	glm::vec3(1.0f, -1.0f, -1.0f),
-	glm::vec3(-1.0f, -1.0f, -1.0f),
-	glm::vec3(-1.0f,  1.0f,  1.0f),
-	glm::vec3(1.0f,  1.0f,  1.0f),
-	glm::vec3(1.0f, -1.0f,  1.0f),
-	glm::vec3(-1.0f, -1.0f,  1.0f),
-	};
-
-	// Project frustum corners into world space
-	glm::mat4 invCam = glm::inverse(camera->projectionMatrix * camera->viewMatrix);
-	for (uint32_t i = 0; i < 8; i++) {
-		glm::vec4 invCorner = invCam * glm::vec4(frustumCorners[i], 1.0f);
-		frustumCorners[i] = invCorner / invCorner.w;
+	if (IsInstanced())
+	{
+		DrawInstanced(commandBuffer, lightSpaceMatrix, casters);
+		return;
 	}
 
-	for (uint32_t i = 0; i < 4; i++) {
-		glm::vec3 dist = frustumCorners[i + 4] - frustumCorners[i];
-		frustumCorners[i + 4] = frustumCorners[i] + (dist);
-		frustumCorners[i] = frustumCorners[i] + (dist);
-	}
+	//Every caster shares one descriptor set, only the offset of its matrix in the uniform ring changes
+	auto& uniformRing = *GraphicManager::Get()->GetUniformRing();
 
-	// Get frustum center
-	glm::vec3 frustumCenter = glm::vec3(0.0f);
-	for (uint32_t i = 0; i < 8; i++) {
-		frustumCenter += frustumCorners[i];
-	}
-	frustumCenter /= 8.0f;
+	m_UniformObject.UpdateLayout(m_Pipeline.GetShader()->GetUniformBlock(Shader::DYNAMIC_UNIFORM_BLOCK));
+
+	m_DescriptorSet.Push(Shader::DYNAMIC_UNIFORM_BLOCK, uniformRing);
+	m_DescriptorSet.Push("shadowMap", GraphicManager::Get()->GetAttachment("shadow"));
 
-	float radius = 0.0f;
-	for (uint32_t i = 0; i < 8; i++) {
-		float distance = glm::length(frustumCorners[i] - frustumCenter);
-		radius = glm::max(radius, distance);
+	if (!m_DescriptorSet.Update(m_Pipeline))
+	{
+		return;
 	}
-	radius = std::ceil(radius * 16.0f) / 16.0f;
 
-	glm::vec3 maxExtents = glm::vec3(radius);
-	glm::vec3 minExtents = -maxExtents;
+	m_Pipeline.BindPipeline(commandBuffer);
 
-	glm::vec3 lightDir = lightDirection;
-	
-	glm::mat4 lightView;
-	if(lightDirection == camera->up)
+	view.ForEach(casters, [&](Entity, Transform& transform, Model& mesh, ShadowRenderer&)
 	{
-		lightView = glm::mat4(glm::vec4(1.0f), glm::vec4(0), glm::vec4(0), glm::vec4(0));
-	}else
+		if (mesh.model == nullptr)
+		{
+			return;
+		}
+
+		m_UniformObject.Push("mvp", lightSpaceMatrix * TransformManager::GetWorldMatrix(transform));
+
+		m_DescriptorSet.BindDescriptor(commandBuffer, m_Pipeline, m_UniformObject.Allocate(uniformRing));
+
+		if(mesh.model->CmdRender(commandBuffer)){}
+	});
+}
+
+void RendererDirectionalShadow::DrawInstanced(const CommandBuffer& commandBuffer, const glm::mat4x4& lightSpaceMatrix, const std::vector<Entity>& casters)
+{
+	for (auto& [mesh, group] : m_InstanceGroups)
 	{
-		lightView = glm::lookAt(glm::normalize(-lightDirection) * -minExtents.z, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+		group.instances.clear();
 	}
 
-	glm::mat4 lightProjection = glm::ortho<float>(minExtents.x, maxExtents.x, minExtents.y, maxExtents.y, -(maxExtents.z - minExtents.z), maxExtents.z - minExtents.z);
+	const View<Transform, Model> view(*Engine::Get()->GetComponentManager());
 
-	for (const auto &entity : m_RegisteredEntities)
+	view.ForEach(casters, [&](Entity, Transform& transform, Model& mesh)
 	{
-		auto entityHandle = EntityHandle(entity);
+		if (mesh.model != nullptr)
+		{
+			m_InstanceGroups[mesh.model].instances.push_back({ TransformManager::GetWorldMatrix(transform) });
+		}
+	});
 
-		auto transform = entityHandle.GetComponent<Transform>(ComponentType::TRANSFORM);
-		auto mesh = entityHandle.GetComponent<Model>(ComponentType::MODEL);
-		auto shadowRenderer = entityHandle.GetComponent<ShadowRenderer>(ComponentType::SHADOW_RENDERER);
+	m_Instances.clear();
+	for (auto& [mesh, group] : m_InstanceGroups)
+	{
+		group.firstInstance = static_cast<uint32_t>(m_Instances.size());
+		m_Instances.insert(m_Instances.end(), group.instances.begin(), group.instances.end());
+	}
 
-		m_Pipeline.BindPipeline(commandBuffer);
+	if (m_Instances.empty())
+	{
+		return;
+	}
 
-		glm::mat4x4 matrix = lightProjection * lightView * TransformManager::GetWorldMatrix(*transform);
+	const auto offset = InstanceBuffer::Upload(m_InstanceBuffer, m_Instances.data(), sizeof(Instance) * m_Instances.size());
 
-		shadowRenderer->uniformScene.Push("mvp", matrix);
+	m_PipelineInstanced.BindPipeline(commandBuffer);
 
-		shadowRenderer->descriptorSet.Push("UniformScene", shadowRenderer->uniformScene);
-		shadowRenderer->descriptorSet.Push("shadowMap", GraphicManager::Get()->GetAttachment("shadow"));
+	//Every caster shares the light space matrix, their world matrix comes from the instance buffer
+	auto& uniformRing = *GraphicManager::Get()->GetUniformRing();
 
-		const auto updateSuccess = shadowRenderer->descriptorSet.Update(m_Pipeline);
+	m_UniformObject.UpdateLayout(m_PipelineInstanced.GetShader()->GetUniformBlock(Shader::DYNAMIC_UNIFORM_BLOCK));
+	m_UniformObject.Push("mvp", lightSpaceMatrix);
 
+	m_DescriptorSetInstanced.Push(Shader::DYNAMIC_UNIFORM_BLOCK, uniformRing);
+	m_DescriptorSetInstanced.Push("shadowMap", GraphicManager::Get()->GetAttachment("shadow"));
 
-		if (!updateSuccess)
-		{
-			continue;
-		}
+	if (!m_DescriptorSetInstanced.Update(m_PipelineInstanced))
+	{
+		return;
+	}
 
-		shadowRenderer->descriptorSet.BindDescriptor(commandBuffer, m_Pipeline);
+	m_DescriptorSetInstanced.BindDescriptor(commandBuffer, m_PipelineInstanced, m_UniformObject.Allocate(uniformRing));
 
-		if(mesh->model->CmdRender(commandBuffer)){}
-	}
-}
+	VkBuffer instanceBuffers[] = { m_InstanceBuffer->GetBuffer() };
+	VkDeviceSize offsets[] = { offset };
+	vkCmdBindVertexBuffers(commandBuffer, 1, 1, instanceBuffers, offsets);
 
-void RendererDirectionalShadow::RegisterEntity(const Entity entity)
-{
-	m_RegisteredEntities.push_back(entity);
+	for (const auto& [mesh, group] : m_InstanceGroups)
+	{
+		if (!group.instances.empty() && mesh->CmdBind(commandBuffer))
+		{
+			mesh->CmdDraw(commandBuffer, static_cast<uint32_t>(group.instances.size()), group.firstInstance);
+		}
+	}
 }
 }
@@ -24,7 +24,9 @@ SOFTWARE.
 
 #include <graphics/renderer_forward.h>
 #include <graphics/graphic_manager.h>
-#include "entity/entity_handle.h"
+#include <component/component_view.h>
+#include <engine/engine.h>
+#include <glm/glm.hpp>
 #include "component/model.h"
 #include <component/materials/material_default.h>
 
@@ -45,15 +47,12 @@ RendererForward::RendererForward(const Pipeline::Stage& pipelineStage) :
 
 void RendererForward::Update()
 {
-	for (const auto &meshRender : m_RegisteredEntities)
-	{
-		auto entity = EntityHandle(meshRender);
-		const auto transform = entity.GetComponent<Transform>(ComponentType::TRANSFORM);
-		const auto meshRenderer = entity.GetComponent<MeshRenderer>(ComponentType::MESH_RENDERER);
+	const View<Transform, MeshRenderer, MaterialSkybox> view(*Engine::Get()->GetComponentManager());
 
-		const auto material = entity.GetComponent<MaterialSkybox>(ComponentType::MATERIAL_SKYBOX);
-		MaterialSkyboxManager::PushUniform(*material, TransformManager::GetWorldMatrix(*transform), meshRenderer->uniformObject);
-	}
+	view.ForEach(GetRegisteredEntities(), [](Entity, Transform& transform, MeshRenderer& meshRenderer, MaterialSkybox& material)
+	{
+		MaterialSkyboxManager::PushUniform(material, TransformManager::GetWorldMatrix(transform), meshRenderer.uniformObject);
+	});
 }
 
 void RendererForward::Draw(const CommandBuffer& commandBuffer)
@@ -63,29 +62,16 @@ void RendererForward::Draw(const CommandBuffer& commandBuffer)
 	m_UniformScene.Push("view", camera->viewMatrix);
 	m_UniformScene.Push("cameraPos", camera->position);
 
-	for (const auto &entity : m_RegisteredEntities)
-	{
-		auto entityHandle = EntityHandle(entity);
-		const auto drawable = entityHandle.GetComponent<Drawable>(ComponentType::DRAWABLE);
-		if (!drawable->isDrawable)
-		{
-			continue;
-		}
-
-		const auto meshRenderer = entityHandle.GetComponent<MeshRenderer>(ComponentType::MESH_RENDERER);
-		const auto mesh = entityHandle.GetComponent<Model>(ComponentType::MODEL);
+	const View<Transform, MeshRenderer, Model, MaterialSkybox> view(*Engine::Get()->GetComponentManager());
+	const auto& visibleEntities = GetVisibleEntities();
 
-		MaterialSkybox* material = entityHandle.GetComponent<MaterialSkybox>(ComponentType::MATERIAL_SKYBOX);
-
-
-		if (material == nullptr || mesh == nullptr)
-		{
-			std::cout << "Missing material or mesh => Don't render\n";
-			continue;
-		}
-
-		const auto meshModel = mesh->model;
-		auto materialPipeline = material->pipelineMaterial;
+	m_DrawList.Clear();
+	for (uint32_t i = 0; i < visibleEntities.size(); i++)
+	{
+		const auto entity = visibleEntities[i];
+		const auto meshModel = view.Get<Model>(entity).model;
+		const auto& material = view.Get<MaterialSkybox>(entity);
+		const auto materialPipeline = material.pipelineMaterial;
 
 		if (meshModel == nullptr || materialPipeline == nullptr || materialPipeline->GetStage() != GetStage())
 		{
@@ -105,9 +91,29 @@ void RendererForward::Draw(const CommandBuffer& commandBuffer)
 			continue;
 		}
 
-		const auto bindSuccess = materialPipeline->BindPipeline(commandBuffer);
+		//Front to back inside a state group
+		const auto depth = glm::length(glm::vec3(view.Get<Transform>(entity).worldMatrix[3]) - camera->position) / camera->farFrustum;
 
-		if (!bindSuccess)
+		m_DrawList.Add(DrawList::MakeKey(
+			GetStage().second,
+			m_DrawList.GetStateId(DrawList::State::PIPELINE, materialPipeline),
+			m_DrawList.GetStateId(DrawList::State::MATERIAL, material.image.get()),
+			m_DrawList.GetStateId(DrawList::State::MESH, meshModel),
+			depth), i);
+	}
+	m_DrawList.Sort();
+
+	auto& uniformRing = *GraphicManager::Get()->GetUniformRing();
+
+	m_DrawList.BeginReplay();
+	for (const auto& draw : m_DrawList.GetDraws())
+	{
+		const auto entity = visibleEntities[draw.index];
+		auto& meshRenderer = view.Get<MeshRenderer>(entity);
+		auto& material = view.Get<MaterialSkybox>(entity);
+		auto materialPipeline = material.pipelineMaterial;
+
+		if (!m_DrawList.BindPipeline(commandBuffer, *materialPipeline))
 		{
 			std::cout << "Bind fail\n";
 			continue;
@@ -115,13 +121,18 @@ void RendererForward::Draw(const CommandBuffer& commandBuffer)
 
 		auto &pipeline = *materialPipeline->GetPipeline();
 
-		meshRenderer->descriptorSet.Push("UboScene", m_UniformScene);
-		meshRenderer->descriptorSet.Push("UboObject", meshRenderer->uniformObject);
+		//The object uniforms are pushed by Update once the handle knows the layout
+		if (!meshRenderer.uniformObject.UpdateLayout(pipeline.GetShader()->GetUniformBlock(Shader::DYNAMIC_UNIFORM_BLOCK)))
+		{
+			continue;
+		}
 
-		MaterialSkyboxManager::PushDescriptor(*entityHandle.GetComponent<MaterialSkybox>(ComponentType::MATERIAL_SKYBOX), meshRenderer->descriptorSet);
+		meshRenderer.descriptorSet.Push("UboScene", m_UniformScene);
+		meshRenderer.descriptorSet.Push(Shader::DYNAMIC_UNIFORM_BLOCK, uniformRing);
 
-		const auto updateSuccess = meshRenderer->descriptorSet.Update(pipeline);
+		MaterialSkyboxManager::PushDescriptor(material, meshRenderer.descriptorSet);
 
+		const auto updateSuccess = meshRenderer.descriptorSet.Update(pipeline);
 
 		if (!updateSuccess)
 		{
@@ -129,16 +140,8 @@ void RendererForward::Draw(const CommandBuffer& commandBuffer)
 		}
 
 		// Draws the object.
-		meshRenderer->descriptorSet.BindDescriptor(commandBuffer, pipeline);
-		if (meshModel->CmdRender(commandBuffer)) {
-
-		}
+		m_DrawList.BindDescriptor(commandBuffer, meshRenderer.descriptorSet, pipeline, meshRenderer.uniformObject.Allocate(uniformRing));
+		m_DrawList.DrawMesh(commandBuffer, *view.Get<Model>(entity).model);
 	}
 }
-
-void RendererForward::RegisterEntity(const Entity entity)
-{
-	m_RegisteredEntities.push_back(entity);
-
-}
 }
@@ -24,11 +24,17 @@ SOFTWARE.
 
 #include <graphics/renderer_meshes.h>
 #include <graphics/graphic_manager.h>
-#include "entity/entity_handle.h"
+#include <component/component_view.h>
+#include <engine/engine.h>
+#include <glm/glm.hpp>
 #include "component/model.h"
 #include <component/materials/material_default.h>
 
 #include <component/mesh_renderer.h>
+#include <graphics/frustum.h>
+#include <graphics/texture_manager.h>
+
+#include <limits>
 
 namespace dm
 {
@@ -45,15 +51,7 @@ RendererMeshes::RendererMeshes(const Pipeline::Stage& pipelineStage) :
 
 void RendererMeshes::Update()
 {
-	for (const auto &meshRender : m_RegisteredEntities)
-	{
-		auto entity = EntityHandle(meshRender);
-		const auto transform = entity.GetComponent<Transform>(ComponentType::TRANSFORM);
-		const auto meshRenderer = entity.GetComponent<MeshRenderer>(ComponentType::MESH_RENDERER);
-
-		const auto material = entity.GetComponent<MaterialDefault>(ComponentType::MATERIAL_DEFAULT);
-		MaterialDefaultManager::PushUniform(*material, TransformManager::GetWorldMatrix(*transform), meshRenderer->uniformObject);
-	}
+	//The objects are written in the ObjectBuffer while drawing, in the order of the sorted draws
 }
 
 void RendererMeshes::Draw(const CommandBuffer& commandBuffer)
@@ -63,80 +61,279 @@ void RendererMeshes::Draw(const CommandBuffer& commandBuffer)
 	m_UniformScene.Push("view", camera->viewMatrix);
 	m_UniformScene.Push("cameraPos", camera->position);
 
-	for (const auto &entity : m_RegisteredEntities)
+	if (IsGpuDriven())
 	{
-		auto entityHandle = EntityHandle(entity);
-		const auto drawable = entityHandle.GetComponent<Drawable>(ComponentType::DRAWABLE);
-		if(!drawable->isDrawable)
-		{
-			continue;
-		}
-
-		const auto meshRenderer = entityHandle.GetComponent<MeshRenderer>(ComponentType::MESH_RENDERER);
-		const auto mesh = entityHandle.GetComponent<Model>(ComponentType::MODEL);
-
-		MaterialDefault* material = entityHandle.GetComponent<MaterialDefault>(ComponentType::MATERIAL_DEFAULT);
-
+		DrawIndirect(commandBuffer);
+		return;
+	}
 
-		if (material == nullptr || mesh == nullptr)
-		{
-			std::cout << "Missing material or mesh => Don't render\n";
-			continue;
-		}
+	const auto componentManager = Engine::Get()->GetComponentManager();
+	const View<Transform, MeshRenderer, Model, MaterialDefault> view(*componentManager);
+	const auto& boundingSpheres = componentManager->GetManager<BoundingSphere>()->GetComponents();
+	const auto& visibleEntities = GetVisibleEntities();
+	const auto bindless = TextureManager::Get()->IsBindless();
 
-		const auto meshModel = mesh->model;
-		auto materialPipeline = material->pipelineMaterial;
+	m_DrawList.Clear();
+	m_MaterialIds.clear();
+	for (uint32_t i = 0; i < visibleEntities.size(); i++)
+	{
+		const auto entity = visibleEntities[i];
+		const auto meshModel = view.Get<Model>(entity).model;
+		const auto& material = view.Get<MaterialDefault>(entity);
+		const auto materialPipeline = material.pipelineMaterial;
 
 		if (meshModel == nullptr || materialPipeline == nullptr || materialPipeline->GetStage() != GetStage())
 		{
 			std::cout << "Missing model or material pipeline or stage is not the same : \n";
-			if(meshModel == nullptr)
+			if (meshModel == nullptr)
 			{
 				std::cout << "	- Missing model\n";
-			}else if (materialPipeline == nullptr)
+			}
+			else if (materialPipeline == nullptr)
 			{
 				std::cout << "	- Missing materialPipeline\n";
-			}else 
+			}
+			else
 			{
 				std::cout << "	- MaterialPipeline->GetStage() != GetStage()\n";
 			}
 			continue;
 		}
 
-		const auto bindSuccess = materialPipeline->BindPipeline(commandBuffer);
+		//Front to back inside a state group
+		const auto depth = glm::length(glm::vec3(view.Get<Transform>(entity).worldMatrix[3]) - camera->position) / camera->farFrustum;
+
+		m_DrawList.Add(DrawList::MakeKey(
+			GetStage().second,
+			m_DrawList.GetStateId(DrawList::State::PIPELINE, materialPipeline),
+			GetMaterialId(material, bindless),
+			m_DrawList.GetStateId(DrawList::State::MESH, meshModel),
+			depth), i);
+	}
+	m_DrawList.Sort();
+
+	//The object of a draw is at its position in the sorted list
+	const auto& draws = m_DrawList.GetDraws();
+
+	m_ObjectBuffer.Clear();
+	for (const auto& draw : draws)
+	{
+		const auto entity = visibleEntities[draw.index];
+		auto object = MaterialDefaultManager::GetObjectData(view.Get<MaterialDefault>(entity), TransformManager::GetWorldMatrix(view.Get<Transform>(entity)));
+
+		if (boundingSpheres.Contains(entity))
+		{
+			object.sphere = glm::vec4(boundingSpheres.Get(entity)->worldCenter, boundingSpheres.Get(entity)->worldRadius);
+		}
+
+		m_ObjectBuffer.Add(object);
+	}
+	m_ObjectBuffer.Upload();
+
+	m_DrawList.BeginReplay();
+	for (uint32_t first = 0; first < draws.size();)
+	{
+		const auto entity = visibleEntities[draws[first].index];
+		auto& meshRenderer = view.Get<MeshRenderer>(entity);
+		auto& material = view.Get<MaterialDefault>(entity);
+		const auto key = GetBatchKey(view.Get<Model>(entity), material, bindless);
+
+		//Consecutive draws sharing the mesh, the pipeline and the textures are instances of one draw
+		uint32_t count = 1;
+		while (first + count < draws.size())
+		{
+			const auto next = visibleEntities[draws[first + count].index];
+			const auto nextKey = GetBatchKey(view.Get<Model>(next), view.Get<MaterialDefault>(next), bindless);
+
+			if (!(nextKey == key))
+			{
+				break;
+			}
+			count++;
+		}
+
+		const auto firstInstance = m_ObjectBuffer.GetFirstIndex() + first;
+		first += count;
 
-		if (!bindSuccess)
+		if (!m_DrawList.BindPipeline(commandBuffer, *material.pipelineMaterial))
 		{
 			std::cout << "Bind fail\n";
 			continue;
 		}
 
-		auto &pipeline = *materialPipeline->GetPipeline();
+		auto &pipeline = *material.pipelineMaterial->GetPipeline();
 
-		meshRenderer->descriptorSet.Push("UboScene", m_UniformScene);
-		meshRenderer->descriptorSet.Push("UboObject", meshRenderer->uniformObject);
+		//Without textures to push the draws of a pipeline share one set
+		const auto bindlessPipeline = pipeline.GetShader()->IsBindless();
+		auto &descriptorSet = bindlessPipeline ? m_DescriptorSets[material.pipelineMaterial] : meshRenderer.descriptorSet;
 
-		MaterialDefaultManager::PushDescriptor(*material, meshRenderer->descriptorSet);
+		descriptorSet.Push("UboScene", m_UniformScene);
+		m_ObjectBuffer.PushDescriptor(descriptorSet);
 
-		const auto updateSuccess = meshRenderer->descriptorSet.Update(pipeline);
+		if (!bindlessPipeline)
+		{
+			MaterialDefaultManager::PushDescriptor(material, descriptorSet);
+		}
+
+		const auto updateSuccess = descriptorSet.Update(pipeline);
 
-		
 		if (!updateSuccess)
 		{
 			continue;
 		}
 
-		// Draws the object.
-		meshRenderer->descriptorSet.BindDescriptor(commandBuffer, pipeline);
-		if (meshModel->CmdRender(commandBuffer)) {
+		// Draws the objects.
+		m_DrawList.BindDescriptor(commandBuffer, descriptorSet, pipeline);
+		m_DrawList.DrawMesh(commandBuffer, *key.mesh, count, firstInstance);
+	}
+}
 
+void RendererMeshes::PreDraw(const CommandBuffer& commandBuffer)
+{
+	if (!IsGpuDriven())
+	{
+		return;
+	}
+
+	m_GpuCulling->Clear();
+	for (auto& [key, batch] : m_IndirectBatches)
+	{
+		batch.objects.clear();
+		batch.batch = GpuCulling::INVALID_BATCH;
+	}
+
+	const auto componentManager = Engine::Get()->GetComponentManager();
+	const View<Transform, Model, MaterialDefault> view(*componentManager);
+	const auto& boundingSpheres = componentManager->GetManager<BoundingSphere>()->GetComponents();
+
+	//Every drawable goes to the GPU, the compute pass does the culling
+	view.ForEach(GetRegisteredEntities(), [&](const Entity entity, Transform& transform, Model& mesh, MaterialDefault& material)
+	{
+		if (mesh.model == nullptr || material.pipelineMaterial == nullptr)
+		{
+			return;
 		}
+
+		const auto key = GetBatchKey(mesh, material, TextureManager::Get()->IsBindless());
+
+		auto it = m_IndirectBatches.find(key);
+		if (it == m_IndirectBatches.end())
+		{
+			it = m_IndirectBatches.try_emplace(key).first;
+			it->second.material = material;
+			it->second.pipelineMaterial = PipelineMaterial::Create(GetStage(),
+				PipelineGraphicsCreate(
+					{ "../Shaders/shader.vert", "../Shaders/shader.frag" },
+					{ ModelComponentManager::GetVertexInput() },
+					MaterialDefaultManager::GetDefines(material, true),
+					PipelineGraphics::Mode::MRT));
+		}
+
+		auto object = MaterialDefaultManager::GetObjectData(material, transform.worldMatrix);
+
+		//Without bounding sphere the object is always visible
+		glm::vec3 center = glm::vec3(transform.worldMatrix[3]);
+		auto radius = std::numeric_limits<float>::max();
+		if (boundingSpheres.Contains(entity))
+		{
+			center = boundingSpheres.Get(entity)->worldCenter;
+			radius = boundingSpheres.Get(entity)->worldRadius;
+		}
+		object.sphere = glm::vec4(center, radius);
+
+		it->second.objects.push_back(object);
+	});
+
+	for (auto& [key, batch] : m_IndirectBatches)
+	{
+		if (!batch.objects.empty())
+		{
+			batch.batch = m_GpuCulling->AddBatch(*key.mesh, batch.objects);
+		}
+	}
+
+	const auto camera = GraphicManager::Get()->GetCamera();
+	if (camera == nullptr)
+	{
+		return;
 	}
+
+	m_GpuCulling->Dispatch(commandBuffer, Frustum::FromMatrix(camera->projectionMatrix * camera->viewMatrix));
 }
 
-void RendererMeshes::RegisterEntity(const Entity entity)
+void RendererMeshes::SetGpuDriven(const bool gpuDriven)
 {
-	m_RegisteredEntities.push_back(entity);
-	
+	if (gpuDriven && m_GpuCulling == nullptr && GpuCulling::IsSupported())
+	{
+		m_GpuCulling = std::make_unique<GpuCulling>();
+	}
+	else if (!gpuDriven)
+	{
+		m_GpuCulling = nullptr;
+		m_IndirectBatches.clear();
+	}
+}
+
+RendererMeshes::BatchKey RendererMeshes::GetBatchKey(const Model& mesh, const MaterialDefault& material, const bool bindless)
+{
+	if (bindless)
+	{
+		return BatchKey{ mesh.model, material.pipelineMaterial, nullptr, nullptr, nullptr };
+	}
+
+	return BatchKey{
+		mesh.model, material.pipelineMaterial,
+		material.diffuseTexture.get(), material.materialTexture.get(), material.normalTexture.get() };
+}
+
+uint32_t RendererMeshes::GetMaterialId(const MaterialDefault& material, const bool bindless)
+{
+	//Bindless pipelines read the textures from the table, their materials share one state
+	const auto textures = bindless ?
+		MaterialTextures() :
+		MaterialTextures(material.diffuseTexture.get(), material.materialTexture.get(), material.normalTexture.get());
+
+	return m_MaterialIds.emplace(textures, static_cast<uint32_t>(m_MaterialIds.size())).first->second;
+}
+
+void RendererMeshes::DrawIndirect(const CommandBuffer& commandBuffer)
+{
+	for (auto& [key, batch] : m_IndirectBatches)
+	{
+		if (batch.batch == GpuCulling::INVALID_BATCH || !batch.pipelineMaterial->BindPipeline(commandBuffer))
+		{
+			continue;
+		}
+
+		auto &pipeline = *batch.pipelineMaterial->GetPipeline();
+
+		const auto frame = m_GpuCulling->GetFrame();
+		if (batch.descriptorSets.size() <= frame)
+		{
+			batch.descriptorSets.resize(frame + 1);
+		}
+		auto &descriptorSet = batch.descriptorSets[frame];
+
+		descriptorSet.Push("UboScene", m_UniformScene);
+		descriptorSet.Push("ObjectBuffer", m_GpuCulling->GetObjectBuffer());
+		descriptorSet.Push("InstanceBuffer", m_GpuCulling->GetInstanceBuffer());
+
+		if (!pipeline.GetShader()->IsBindless())
+		{
+			MaterialDefaultManager::PushDescriptor(batch.material, descriptorSet);
+		}
+
+		if (!descriptorSet.Update(pipeline))
+		{
+			continue;
+		}
+
+		descriptorSet.BindDescriptor(commandBuffer, pipeline);
+
+		if (key.mesh->CmdBind(commandBuffer))
+		{
+			m_GpuCulling->DrawBatch(commandBuffer, batch.batch);
+		}
+	}
 }
 }
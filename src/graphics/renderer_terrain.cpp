@@ -24,7 +24,8 @@ SOFTWARE.
 
 #include <graphics/renderer_terrain.h>
 #include <graphics/graphic_manager.h>
-#include "entity/entity_handle.h"
+#include <component/component_view.h>
+#include <engine/engine.h>
 #include "component/model.h"
 #include <component/materials/material_default.h>
 
@@ -45,15 +46,12 @@ RendererTerrain::RendererTerrain(const Pipeline::Stage& pipelineStage) :
 
 void RendererTerrain::Update()
 {
-	/*for (const auto &meshRender : m_RegisteredEntities)
-	{
-		auto entity = EntityHandle(meshRender);
-		const auto transform = entity.GetComponent<Transform>(ComponentType::TRANSFORM);
-		const auto meshRenderer = entity.GetComponent<MeshRenderer>(ComponentType::MESH_RENDERER);
+	/*const View<Transform, MeshRenderer, MaterialTerrain> view(*Engine::Get()->GetComponentManager());
 
-		const auto material = entity.GetComponent<MaterialTerrain>(ComponentType::MATERIAL_TERRAIN);
-		MaterialTerrainManager::PushUniform(*material, TransformManager::GetWorldMatrix(*transform), meshRenderer->uniformObject);
-	}*/
+	view.ForEach(GetRegisteredEntities(), [](Entity, Transform& transform, MeshRenderer& meshRenderer, MaterialTerrain& material)
+	{
+		MaterialTerrainManager::PushUniform(material, TransformManager::GetWorldMatrix(transform), meshRenderer.uniformObject);
+	});*/
 }
 
 void RendererTerrain::Draw(const CommandBuffer& commandBuffer)
@@ -62,29 +60,12 @@ void RendererTerrain::Draw(const CommandBuffer& commandBuffer)
 	m_UniformScene.Push("projection", camera->projectionMatrix);
 	m_UniformScene.Push("view", camera->viewMatrix);
 
-	for (const auto &entity : m_RegisteredEntities)
-	{
-		auto entityHandle = EntityHandle(entity);
-		const auto drawable = entityHandle.GetComponent<Drawable>(ComponentType::DRAWABLE);
-		if (!drawable->isDrawable)
-		{
-			continue;
-		}
-
-		const auto meshRenderer = entityHandle.GetComponent<MeshRenderer>(ComponentType::MESH_RENDERER);
-		const auto mesh = entityHandle.GetComponent<Model>(ComponentType::MODEL);
-
-		auto* material = entityHandle.GetComponent<MaterialTerrain>(ComponentType::MATERIAL_TERRAIN);
-
+	const View<MeshRenderer, Model, MaterialTerrain, Transform> view(*Engine::Get()->GetComponentManager());
 
-		if (material == nullptr || mesh == nullptr)
-		{
-			std::cout << "Missing material or mesh => Don't render\n";
-			continue;
-		}
-
-		const auto meshModel = mesh->model;
-		auto materialPipeline = material->pipelineMaterial;
+	view.ForEach(GetVisibleEntities(), [&](Entity, MeshRenderer& meshRenderer, Model& mesh, MaterialTerrain& material, Transform& transform)
+	{
+		const auto meshModel = mesh.model;
+		auto materialPipeline = material.pipelineMaterial;
 
 		if (meshModel == nullptr || materialPipeline == nullptr || materialPipeline->GetStage() != GetStage())
 		{
@@ -101,7 +82,7 @@ void RendererTerrain::Draw(const CommandBuffer& commandBuffer)
 			{
 				std::cout << "	- MaterialPipeline->GetStage() != GetStage()\n";
 			}
-			continue;
+			return;
 		}
 
 		const auto bindSuccess = materialPipeline->BindPipeline(commandBuffer);
@@ -109,35 +90,29 @@ void RendererTerrain::Draw(const CommandBuffer& commandBuffer)
 		if (!bindSuccess)
 		{
 			std::cout << "Bind fail\n";
-			continue;
+			return;
 		}
 
 		auto &pipeline = *materialPipeline->GetPipeline();
-		m_UniformScene.Push("transform", TransformManager::GetWorldMatrix(*entityHandle.GetComponent<Transform>(ComponentType::TRANSFORM)));
+		m_UniformScene.Push("transform", TransformManager::GetWorldMatrix(transform));
 
-		meshRenderer->descriptorSet.Push("UboScene", m_UniformScene);
+		meshRenderer.descriptorSet.Push("UboScene", m_UniformScene);
 
-		MaterialTerrainManager::PushDescriptor(*entityHandle.GetComponent<MaterialTerrain>(ComponentType::MATERIAL_TERRAIN), meshRenderer->descriptorSet);
+		MaterialTerrainManager::PushDescriptor(material, meshRenderer.descriptorSet);
 
-		const auto updateSuccess = meshRenderer->descriptorSet.Update(pipeline);
+		const auto updateSuccess = meshRenderer.descriptorSet.Update(pipeline);
 
 
 		if (!updateSuccess)
 		{
-			continue;
+			return;
 		}
 
 		// Draws the object.
-		meshRenderer->descriptorSet.BindDescriptor(commandBuffer, pipeline);
+		meshRenderer.descriptorSet.BindDescriptor(commandBuffer, pipeline);
 		if (meshModel->CmdRender(commandBuffer)) {
 
 		}
-	}
-}
-
-void RendererTerrain::RegisterEntity(const Entity entity)
-{
-	m_RegisteredEntities.push_back(entity);
-
+	});
 }
 }
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include <graphics/texture_manager.h>
 #include "graphics/graphic_manager.h"
+#include "editor/log.h"
+
+#include <algorithm>
 
 namespace dm
 {
@@ -31,4 +34,138 @@ TextureManager* TextureManager::Get()
 {
 	return GraphicManager::Get()->GetTextureManager();
 }
+
+TextureManager::TextureManager() :
+	m_TableSize(0),
+	m_DescriptorSetLayout(VK_NULL_HANDLE),
+	m_DescriptorPool(VK_NULL_HANDLE),
+	m_DescriptorSet(VK_NULL_HANDLE)
+{
+	if (GraphicManager::Get()->GetLogicalDevice()->IsDescriptorIndexingEnabled())
+	{
+		CreateDescriptorTable();
+	}
+}
+
+TextureManager::~TextureManager()
+{
+	const auto logicalDevice = GraphicManager::Get()->GetLogicalDevice();
+
+	vkDestroyDescriptorPool(*logicalDevice, m_DescriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(*logicalDevice, m_DescriptorSetLayout, nullptr);
+}
+
+uint32_t TextureManager::GetTextureIndex(const std::shared_ptr<Image2d>& texture)
+{
+	if (texture == nullptr || !IsBindless())
+	{
+		return NO_TEXTURE;
+	}
+
+	const auto it = m_TextureIndices.find(texture.get());
+
+	if (it != m_TextureIndices.end())
+	{
+		return it->second;
+	}
+
+	if (m_Slots.size() >= m_TableSize)
+	{
+		//Kept as NO_TEXTURE so the error is reported once per texture
+		Debug::Log("[Error] Texture table is full (" + std::to_string(m_TableSize) + " slots), " + texture->GetFilename() + " is not sampled");
+		m_TextureIndices.emplace(texture.get(), NO_TEXTURE);
+		return NO_TEXTURE;
+	}
+
+	const auto index = static_cast<uint32_t>(m_Slots.size());
+	m_Slots.push_back(texture);
+	m_TextureIndices.emplace(texture.get(), index);
+
+	// The slot was never read, it can be written while the table is bound by the frames in flight.
+	auto writeDescriptorSet = texture->GetWriteDescriptor(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, std::nullopt);
+	auto descriptorWrite = writeDescriptorSet.GetWriteDescriptorSet();
+	descriptorWrite.dstSet = m_DescriptorSet;
+	descriptorWrite.dstArrayElement = index;
+
+	const auto logicalDevice = GraphicManager::Get()->GetLogicalDevice();
+	vkUpdateDescriptorSets(*logicalDevice, 1, &descriptorWrite, 0, nullptr);
+	return index;
+}
+
+void TextureManager::BindDescriptor(const CommandBuffer& commandBuffer, const Pipeline& pipeline) const
+{
+	vkCmdBindDescriptorSets(commandBuffer, pipeline.GetPipelineBindPoint(), pipeline.GetPipelineLayout(), Shader::BINDLESS_SET, 1, &m_DescriptorSet, 0, nullptr);
+}
+
+uint32_t TextureManager::GetDeviceTableSize()
+{
+	VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties = {};
+	indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+	VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+	physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	physicalDeviceProperties2.pNext = &indexingProperties;
+	vkGetPhysicalDeviceProperties2(*GraphicManager::Get()->GetPhysicalDevice(), &physicalDeviceProperties2);
+
+	// A combined image sampler counts as a sampler and as a sampled image, the per stage limits also count the other sets.
+	const auto setLimit = std::min(indexingProperties.maxDescriptorSetUpdateAfterBindSamplers, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+	const auto stageLimit = std::min(indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers, indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+	const auto stageTableLimit = stageLimit > RESERVED_SAMPLERS ? stageLimit - RESERVED_SAMPLERS : 0;
+
+	return std::min({ MAX_TEXTURES, setLimit, stageTableLimit });
+}
+
+void TextureManager::CreateDescriptorTable()
+{
+	const auto logicalDevice = GraphicManager::Get()->GetLogicalDevice();
+
+	m_TableSize = GetDeviceTableSize();
+	if (m_TableSize == 0)
+	{
+		Debug::Log("[Error] The device limits leave no room for the texture table, textures are bound per material");
+		return;
+	}
+
+	if (m_TableSize < MAX_TEXTURES)
+	{
+		Debug::Log("Texture table clamped to the device limits: " + std::to_string(m_TableSize) + " slots");
+	}
+
+	auto descriptorSetLayoutBinding = Image2d::GetDescriptorSetLayout(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, m_TableSize);
+
+	// Unused slots are never read and new textures are written while the table is bound.
+	VkDescriptorBindingFlagsEXT bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo = {};
+	bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	bindingFlagsCreateInfo.bindingCount = 1;
+	bindingFlagsCreateInfo.pBindingFlags = &bindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {};
+	descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	descriptorSetLayoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+	descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+	descriptorSetLayoutCreateInfo.bindingCount = 1;
+	descriptorSetLayoutCreateInfo.pBindings = &descriptorSetLayoutBinding;
+	GraphicManager::CheckVk(vkCreateDescriptorSetLayout(*logicalDevice, &descriptorSetLayoutCreateInfo, nullptr, &m_DescriptorSetLayout));
+
+	VkDescriptorPoolSize descriptorPoolSize = {};
+	descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorPoolSize.descriptorCount = m_TableSize;
+
+	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
+	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+	descriptorPoolCreateInfo.maxSets = 1;
+	descriptorPoolCreateInfo.poolSizeCount = 1;
+	descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
+	GraphicManager::CheckVk(vkCreateDescriptorPool(*logicalDevice, &descriptorPoolCreateInfo, nullptr, &m_DescriptorPool));
+
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.descriptorPool = m_DescriptorPool;
+	descriptorSetAllocateInfo.descriptorSetCount = 1;
+	descriptorSetAllocateInfo.pSetLayouts = &m_DescriptorSetLayout;
+	GraphicManager::CheckVk(vkAllocateDescriptorSets(*logicalDevice, &descriptorSetAllocateInfo, &m_DescriptorSet));
 }
+}
\ No newline at end of file
@@ -26,6 +26,11 @@ SOFTWARE.
 #include <physic/bounding_sphere.h>
 #include "imgui.h"
 #include <graphics/Mesh.h>
+#include <component/component_manager.h>
+#include <engine/engine.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
 
 namespace dm
 {
@@ -33,10 +38,66 @@ BoundingSphere BoundingSphereManager::GetBoundingSphere(Mesh& mesh)
 {
 	BoundingSphere boundingSphere;
 	boundingSphere.componentType = ComponentType::BOUNDING_SPHERE;
+	boundingSphere.center = mesh.GetCenter();
 	boundingSphere.radius = mesh.GetRadius();
+	boundingSphere.aabb = mesh.GetAabb();
 	return boundingSphere;
 }
 
+void BoundingSphereManager::GetWorldSphere(const glm::mat4x4& worldMatrix, const BoundingSphere& boundingSphere, glm::vec3& center, float& radius)
+{
+	const auto scale = std::max({
+		glm::length(glm::vec3(worldMatrix[0])),
+		glm::length(glm::vec3(worldMatrix[1])),
+		glm::length(glm::vec3(worldMatrix[2])) });
+
+	center = glm::vec3(worldMatrix * glm::vec4(boundingSphere.center, 1.0f));
+	radius = boundingSphere.radius * scale;
+}
+
+Aabb BoundingSphereManager::GetWorldAabb(const glm::mat4x4& worldMatrix, const Aabb& aabb)
+{
+	const auto center = glm::vec3(worldMatrix * glm::vec4(aabb.GetCenter(), 1.0f));
+	const auto extents = aabb.GetExtents();
+
+	const auto worldExtents =
+		glm::abs(glm::vec3(worldMatrix[0])) * extents.x +
+		glm::abs(glm::vec3(worldMatrix[1])) * extents.y +
+		glm::abs(glm::vec3(worldMatrix[2])) * extents.z;
+
+	return Aabb{ center - worldExtents, center + worldExtents };
+}
+
+void BoundingSphereManager::UpdateWorldBounds(const glm::mat4x4& worldMatrix, BoundingSphere& boundingSphere)
+{
+	GetWorldSphere(worldMatrix, boundingSphere, boundingSphere.worldCenter, boundingSphere.worldRadius);
+	boundingSphere.worldAabb = GetWorldAabb(worldMatrix, boundingSphere.aabb);
+}
+
+void BoundingSphereSoA::Add(const glm::vec3& center, const float sphereRadius)
+{
+	centerX.push_back(center.x);
+	centerY.push_back(center.y);
+	centerZ.push_back(center.z);
+	radius.push_back(sphereRadius);
+}
+
+void BoundingSphereSoA::Reserve(const size_t size)
+{
+	for (auto array : { &centerX, &centerY, &centerZ, &radius })
+	{
+		array->reserve(size);
+	}
+}
+
+void BoundingSphereSoA::Clear()
+{
+	for (auto array : { &centerX, &centerY, &centerZ, &radius })
+	{
+		array->clear();
+	}
+}
+
 BoundingSphereManager::BoundingSphereManager()
 {
 	
@@ -50,49 +111,103 @@ void BoundingSphereManager::Init()
 
 void BoundingSphereManager::Update()
 {
+	//Must run after TransformManager::Update, only the moved entities and the new components are recomputed
+	for (const auto entity : m_PendingEntities)
+	{
+		UpdateEntityBounds(entity);
+	}
+	m_PendingEntities.clear();
+
+	for (const auto entity : Engine::Get()->GetComponentManager()->GetTransformManager()->GetUpdatedEntities())
+	{
+		UpdateEntityBounds(entity);
+	}
+}
+
+void BoundingSphereManager::UpdateEntityBounds(const Entity entity)
+{
+	if (!m_Components.Contains(entity))
+	{
+		return;
+	}
+
+	const auto& transforms = Engine::Get()->GetComponentManager()->GetTransformManager()->GetComponents();
+	if (!transforms.Contains(entity))
+	{
+		return;
+	}
+
+	UpdateWorldBounds(transforms.Get(entity)->worldMatrix, *m_Components.Get(entity));
 }
 
 BoundingSphere* BoundingSphereManager::CreateComponent(const Entity entity)
 {
 	auto b = BoundingSphere();
 	b.radius = 1;
-	m_Components[entity - 1] = b;
-
-	return &m_Components[entity - 1];
+	m_PendingEntities.push_back(entity);
+	return m_Components.Insert(entity, b);
 }
 
 BoundingSphere* BoundingSphereManager::AddComponent(const Entity entity, BoundingSphere& component)
 {
-	m_Components[entity - 1] = component;
+	m_PendingEntities.push_back(entity);
+	return m_Components.Insert(entity, component);
+}
 
-	return &m_Components[entity - 1];
+void BoundingSphereManager::DestroyComponent(const Entity entity)
+{
+	m_Components.Remove(entity);
 }
 
-void BoundingSphereManager::DestroyComponent(Entity entity)
+void BoundingSphereManager::Clear()
 {
+	m_Components.Clear();
+	m_PendingEntities.clear();
 }
 
 void BoundingSphereManager::OnDrawInspector(Entity entity)
 {
+	const auto boundingSphere = m_Components.Get(entity);
+
 	ImGui::Separator();
 	ImGui::TextWrapped("Bounding Sphere");
-	ImGui::TextWrapped("Radius : %f ", m_Components[entity - 1].radius);
+	ImGui::TextWrapped("Center : %f, %f, %f ", boundingSphere->center.x, boundingSphere->center.y, boundingSphere->center.z);
+	ImGui::TextWrapped("Radius : %f ", boundingSphere->radius);
+	ImGui::TextWrapped("World radius : %f ", boundingSphere->worldRadius);
 }
 
 void BoundingSphereManager::DecodeComponent(json& componentJson, const Entity entity)
 {
 	BoundingSphere boundingSphere;
 
+	if (CheckJsonExists(componentJson, "center"))
+		boundingSphere.center = GetVector3FromJson(componentJson, "center");
+
 	if (CheckJsonExists(componentJson, "radius") && CheckJsonNumber(componentJson, "radius"))
 		boundingSphere.radius = componentJson["radius"];
 
-	m_Components[entity - 1] = boundingSphere;
+	//Older scenes only store the radius, the box is the one around the sphere
+	boundingSphere.aabb = Aabb::FromSphere(boundingSphere.center, boundingSphere.radius);
+
+	if (CheckJsonExists(componentJson, "min") && CheckJsonExists(componentJson, "max"))
+	{
+		boundingSphere.aabb.min = GetVector3FromJson(componentJson, "min");
+		boundingSphere.aabb.max = GetVector3FromJson(componentJson, "max");
+	}
+
+	m_PendingEntities.push_back(entity);
+	m_Components.Insert(entity, boundingSphere);
 }
 
 void BoundingSphereManager::EncodeComponent(json& componentJson, const Entity entity)
 {
+	const auto boundingSphere = m_Components.Get(entity);
+
 	componentJson["type"] = ComponentType::BOUNDING_SPHERE;
 
-	componentJson["radius"] = m_Components[entity - 1].radius;
+	SetVector3ToJson(componentJson, "center", boundingSphere->center);
+	componentJson["radius"] = boundingSphere->radius;
+	SetVector3ToJson(componentJson, "min", boundingSphere->aabb.min);
+	SetVector3ToJson(componentJson, "max", boundingSphere->aabb.max);
 }
 }
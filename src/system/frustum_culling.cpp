@@ -23,103 +23,264 @@ SOFTWARE.
 */
 
 #include <system/frustum_culling.h>
-#include <glm/vec3.hpp>
 #include <glm/glm.hpp>
-#include <glm/gtx/rotate_vector.hpp>
 #include <component/camera.h>
 #include <engine/engine.h>
 #include <component/component_manager.h>
-#include <entity/entity_handle.h>
+#include <component/component_view.h>
+#include <graphics/graphic_manager.h>
+#include <component/lights/directional_light.h>
+
+#include <algorithm>
 
 namespace dm
 {
-FrustumCulling::FrustumCulling() :
-	m_CameraForCulling(nullptr)
+FrustumCulling::FrustumCulling()
 {
-	m_Signature.AddComponent(ComponentType::BOUNDING_SPHERE);
 	m_Signature.AddComponent(ComponentType::TRANSFORM);
 	m_Signature.AddComponent(ComponentType::DRAWABLE);
+
+	AddReadAccess(ComponentType::BOUNDING_SPHERE);
+	AddReadAccess(ComponentType::TRANSFORM);
+	AddReadAccess(ComponentType::CAMERA);
+	AddReadAccess(ComponentType::DIRECTIONAL_LIGHT);
+	AddReadAccess(ComponentType::DRAWABLE);
+	AddReadAccess(ComponentType::MODEL);
 }
 
 void FrustumCulling::Update()
 {
-	//Get the rendering camera
-	//TODO optimiser cette partie pour setter une seule fois la camra
-	auto cameras = Engine::Get()->GetComponentManager()->GetCameraManager()->GetComponents();
+	SyncSpatialIndex();
+	RefitSpatialIndex();
+
+	auto& views = GraphicManager::Get()->GetViews();
+	const auto hasCullingCamera = BuildViews(views);
 
-	for (Camera& camera : cameras)
+	BoundingVolumeHierarchy::FrustumQuery queries[BoundingVolumeHierarchy::MAX_QUERY_NMB];
+	size_t queryNmb = 0;
+
+	for (size_t i = 0; i < views.size(); i++)
 	{
-		if(camera.isCulling)
+		auto& view = views[i];
+		view.visibleEntities.Clear();
+		m_QueriedEntities[i].clear();
+
+		//Without culling camera the main view keeps every drawable
+		if (i == 0 && !hasCullingCamera)
 		{
-			m_CameraForCulling = &camera;
-			break;
+			view.visibleEntities.Insert(GetRegisteredEntities().GetEntities());
+			continue;
 		}
+
+		view.visibleEntities.Insert(m_UnboundedEntities.GetEntities());
+
+		//Casters between the light and its box still throw shadows inside it
+		const auto planeMask = view.type == ViewType::DIRECTIONAL_LIGHT ?
+			Frustum::ALL_PLANES & ~(1u << Frustum::NEAR_PLANE) :
+			Frustum::ALL_PLANES;
+
+		m_Frustums[i] = Frustum::FromMatrix(view.viewProjection);
+		queries[queryNmb++] = { &m_Frustums[i], planeMask, &m_QueriedEntities[i] };
 	}
 
-	//Compute camera planes
-	const auto aspect = m_CameraForCulling->aspect;
+	m_SpatialIndex.Query(queries, queryNmb);
+
+	if (hasCullingCamera)
+	{
+		CullOccluded(views.front().viewProjection, m_QueriedEntities[0]);
+	}
+
+	for (size_t i = 0; i < views.size(); i++)
+	{
+		views[i].visibleEntities.Insert(m_QueriedEntities[i]);
+	}
+}
+
+bool FrustumCulling::BuildViews(std::vector<VisibilityView>& views) const
+{
+	struct ViewDescription
+	{
+		ViewType type;
+		Entity entity;
+		glm::mat4x4 viewProjection;
+	};
 
-	float angle = glm::radians(45.0f) / 2.0f;
+	ViewDescription descriptions[BoundingVolumeHierarchy::MAX_QUERY_NMB];
+	size_t viewNmb = 1;
+	auto hasCullingCamera = false;
 
-	const auto leftDir = glm::normalize(glm::rotate(m_CameraForCulling->front, angle * aspect, m_CameraForCulling->up));
-	const auto leftNormal = glm::normalize(glm::cross(leftDir, m_CameraForCulling->up));
+	const auto componentManager = Engine::Get()->GetComponentManager();
+	auto& cameras = componentManager->GetCameraManager()->GetComponents();
+
+	descriptions[0] = { ViewType::CAMERA, INVALID_ENTITY, glm::mat4x4(1.0f) };
+
+	for (auto it = cameras.begin(); it != cameras.end(); ++it)
+	{
+		const auto viewProjection = it->projectionMatrix * it->viewMatrix;
+
+		if (it->isCulling && !hasCullingCamera)
+		{
+			descriptions[0] = { ViewType::CAMERA, it.GetEntity(), viewProjection };
+			hasCullingCamera = true;
+		}
+		else if (viewNmb < BoundingVolumeHierarchy::MAX_QUERY_NMB)
+		{
+			descriptions[viewNmb++] = { ViewType::CAMERA, it.GetEntity(), viewProjection };
+		}
+	}
+
+	//The shadow box follows the main camera, as in RendererDirectionalShadow
+	auto& directionalLights = componentManager->GetManager<DirectionalLight>()->GetComponents();
+	const auto mainCamera = GraphicManager::Get()->GetCamera();
+
+	if (!directionalLights.Empty() && mainCamera != nullptr && viewNmb < BoundingVolumeHierarchy::MAX_QUERY_NMB)
+	{
+		const auto light = directionalLights.begin();
+		descriptions[viewNmb++] = {
+			ViewType::DIRECTIONAL_LIGHT,
+			light.GetEntity(),
+			DirectionalLightManager::ComputeLightSpaceMatrix(*mainCamera, light->direction) };
+	}
+
+	views.resize(viewNmb);
+	for (size_t i = 0; i < viewNmb; i++)
+	{
+		views[i].type = descriptions[i].type;
+		views[i].entity = descriptions[i].entity;
+		views[i].viewProjection = descriptions[i].viewProjection;
+	}
+
+	return hasCullingCamera;
+}
 
-	const auto rightDir = glm::normalize(glm::rotate(m_CameraForCulling->front, -angle * aspect, m_CameraForCulling->up));
-	const auto rightNormal = glm::normalize(-glm::cross(rightDir, m_CameraForCulling->up));
+void FrustumCulling::SyncSpatialIndex()
+{
+	const auto& registeredEntities = GetRegisteredEntities();
 
-	const auto upDir = glm::normalize(glm::rotate(m_CameraForCulling->front, -angle, m_CameraForCulling->right));
-	const auto upNormal = glm::normalize(glm::cross(upDir, m_CameraForCulling->right));
+	if (m_BoundedEntities == nullptr)
+	{
+		auto boundedSignature = m_Signature;
+		boundedSignature.AddComponent(ComponentType::BOUNDING_SPHERE);
+		m_BoundedEntities = &Engine::Get()->GetEntityManager()->GetQuery(boundedSignature);
+	}
 
-	const auto downDir = glm::normalize(glm::rotate(m_CameraForCulling->front, angle, m_CameraForCulling->right));
-	const auto downNormal = glm::normalize(-glm::cross(downDir, m_CameraForCulling->right));
+	//Nothing was attached or detached since the last frame, the hierarchy is up to date
+	if (registeredEntities.GetVersion() == m_RegisteredVersion && m_BoundedEntities->GetVersion() == m_BoundedVersion)
+	{
+		return;
+	}
 
-	for (auto entity : m_RegisteredEntities)
+	//The leaf of a destroyed entity is removed even if its index was recycled, Contains compares the generation
+	for (EntityIndex index = 0; index < m_Proxies.size(); index++)
 	{
-		auto entityHandle = EntityHandle(entity);
-		auto boundingSphere = entityHandle.GetComponent<BoundingSphere>(ComponentType::BOUNDING_SPHERE);
-		auto transform = entityHandle.GetComponent<Transform>(ComponentType::TRANSFORM);
-		auto drawable = entityHandle.GetComponent<Drawable>(ComponentType::DRAWABLE);
-		drawable->isDrawable = true;
+		const auto proxy = m_Proxies[index];
+		if (proxy != BoundingVolumeHierarchy::INVALID_PROXY && !m_BoundedEntities->Contains(m_SpatialIndex.GetEntity(proxy)))
+		{
+			m_SpatialIndex.Remove(proxy);
+			m_Proxies[index] = BoundingVolumeHierarchy::INVALID_PROXY;
+		}
+	}
 
-		const auto cameraToSphere = transform->position - m_CameraForCulling->position;
+	const View<BoundingSphere> boundingSpheres(*Engine::Get()->GetComponentManager());
 
-		//near culling
-		if (glm::dot(cameraToSphere, m_CameraForCulling->front) < m_CameraForCulling->nearFrustum + boundingSphere->radius)
+	for (const auto entity : *m_BoundedEntities)
+	{
+		const auto index = GetEntityIndex(entity);
+		if (index >= m_Proxies.size())
 		{
-			continue;
+			m_Proxies.resize(index + 1, BoundingVolumeHierarchy::INVALID_PROXY);
 		}
 
-		//far culling
-		if (glm::dot(cameraToSphere, m_CameraForCulling->front) > m_CameraForCulling->farFrustum - boundingSphere->radius)
+		if (m_Proxies[index] != BoundingVolumeHierarchy::INVALID_PROXY)
 		{
 			continue;
 		}
 
-		//left culling
-		if (glm::dot(cameraToSphere, leftNormal) < -boundingSphere->radius)
+		const auto& boundingSphere = boundingSpheres.Get<BoundingSphere>(entity);
+		m_Proxies[index] = m_SpatialIndex.Insert(entity, boundingSphere.worldCenter, boundingSphere.worldRadius);
+	}
+
+	m_UnboundedEntities.Clear();
+	for (const auto entity : registeredEntities)
+	{
+		if (!m_BoundedEntities->Contains(entity))
 		{
-			continue;
+			m_UnboundedEntities.Insert(entity);
 		}
+	}
+
+	m_RegisteredVersion = registeredEntities.GetVersion();
+	m_BoundedVersion = m_BoundedEntities->GetVersion();
+}
+
+void FrustumCulling::RefitSpatialIndex()
+{
+	const auto transformManager = Engine::Get()->GetComponentManager()->GetTransformManager();
+	const View<BoundingSphere> boundingSpheres(*Engine::Get()->GetComponentManager());
 
-		//right culling
-		if (glm::dot(cameraToSphere, rightNormal) < -boundingSphere->radius)
+	for (const auto entity : transformManager->GetUpdatedEntities())
+	{
+		const auto index = GetEntityIndex(entity);
+		if (index >= m_Proxies.size() || m_Proxies[index] == BoundingVolumeHierarchy::INVALID_PROXY ||
+			m_SpatialIndex.GetEntity(m_Proxies[index]) != entity)
 		{
 			continue;
 		}
 
-		//up culling
-		if (glm::dot(cameraToSphere, upNormal) > boundingSphere->radius)
+		//The world sphere was refreshed by BoundingSphereManager::Update for the same updated entities
+		const auto& boundingSphere = boundingSpheres.Get<BoundingSphere>(entity);
+		m_SpatialIndex.Move(m_Proxies[index], boundingSphere.worldCenter, boundingSphere.worldRadius);
+	}
+}
+
+void FrustumCulling::CullOccluded(const glm::mat4x4& viewProjection, std::vector<Entity>& candidates)
+{
+	if (m_OccluderEntities == nullptr)
+	{
+		auto occluderSignature = m_Signature;
+		occluderSignature.AddComponent(ComponentType::BOUNDING_SPHERE);
+		occluderSignature.AddComponent(ComponentType::MODEL);
+		m_OccluderEntities = &Engine::Get()->GetEntityManager()->GetQuery(occluderSignature);
+	}
+
+	const View<Transform, Drawable, Model> occluderView(*Engine::Get()->GetComponentManager());
+
+	//Only the occluders inside the frustum are rasterized
+	auto hasOccluder = false;
+	m_OcclusionBuffer.Clear(viewProjection);
+
+	for (const auto entity : candidates)
+	{
+		if (!m_OccluderEntities->Contains(entity) || !occluderView.Get<Drawable>(entity).isOccluder)
 		{
 			continue;
 		}
 
-		//down culling
-		if (glm::dot(cameraToSphere, downNormal) > boundingSphere->radius)
+		const auto mesh = occluderView.Get<Model>(entity).model;
+		if (mesh == nullptr)
 		{
 			continue;
 		}
 
-		drawable->isDrawable = true;
+		const auto& geometry = mesh->GetOccluderGeometry();
+		m_OcclusionBuffer.Rasterize(geometry.positions, geometry.indices, occluderView.Get<Transform>(entity).worldMatrix);
+		hasOccluder = true;
+	}
+
+	if (!hasOccluder)
+	{
+		return;
 	}
+
+	m_OcclusionBuffer.BuildHierarchy();
+
+	const View<BoundingSphere> sphereView(*Engine::Get()->GetComponentManager());
+
+	//The world box is tighter than the box around the sphere for elongated meshes
+	const auto last = std::remove_if(candidates.begin(), candidates.end(), [&](const Entity entity)
+	{
+		return m_OcclusionBuffer.IsOccluded(sphereView.Get<BoundingSphere>(entity).worldAabb);
+	});
+	candidates.erase(last, candidates.end());
 }
 }
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include <system/system.h>
+#include <engine/engine.h>
 
 namespace dm
 {
@@ -35,32 +36,60 @@ void System::Update()
 
 void System::Destroy()
 {
-	m_RegisteredEntities.clear();
+	m_RegisteredEntities = nullptr;
 }
 
-void System::RegisterEntity(const Entity entity)
+const EntitySet& System::GetRegisteredEntities()
 {
-	m_RegisteredEntities.push_back(entity);
-	//TODO Remove push back and use index
+	if (m_RegisteredEntities == nullptr)
+	{
+		m_RegisteredEntities = &Engine::Get()->GetEntityManager()->GetQuery(m_Signature);
+	}
+
+	return *m_RegisteredEntities;
+}
+
+ComponentMask System::GetSignature() const
+{
+	return m_Signature;
+}
+
+ComponentMask System::GetReadAccess() const
+{
+	return m_ReadAccess;
 }
 
-void System::UnRegisterEntity(const Entity entity)
+ComponentMask System::GetWriteAccess() const
 {
-	for (auto it = m_RegisteredEntities.begin(); it != m_RegisteredEntities.end(); ++it)
+	if (m_ReadAccess.IsEmpty() && m_WriteAccess.IsEmpty())
 	{
-		const auto e = *it;
+		return m_Signature;
+	}
 
-		if (e == entity)
-		{
-			m_RegisteredEntities.erase(it);
-			return;
-		}
+	return m_WriteAccess;
+}
+
+bool System::ConflictsWith(const System& other) const
+{
+	const auto write = GetWriteAccess();
+	const auto otherWrite = other.GetWriteAccess();
+
+	//Nothing declared at all, the system can touch anything
+	if ((write.IsEmpty() && m_ReadAccess.IsEmpty()) || (otherWrite.IsEmpty() && other.m_ReadAccess.IsEmpty()))
+	{
+		return true;
 	}
-	//TODO remove iterator and use index
+
+	return write.Intersects(other.GetReadAccess()) || write.Intersects(otherWrite) || otherWrite.Intersects(m_ReadAccess);
 }
 
-ComponentMask System::GetSignature() const
+void System::AddReadAccess(const ComponentType componentType)
 {
-	return m_Signature;
+	m_ReadAccess.AddComponent(componentType);
+}
+
+void System::AddWriteAccess(const ComponentType componentType)
+{
+	m_WriteAccess.AddComponent(componentType);
 }
 }
@@ -25,11 +25,13 @@ SOFTWARE.
 #include <system/system_manager.h>
 #include <graphics/renderer_meshes.h>
 #include <system/frustum_culling.h>
+#include <engine/engine.h>
+#include <engine/job_system.h>
 
 namespace dm {
 SystemManager::SystemManager()
 {
-	m_Systems.push_back(std::make_unique<FrustumCulling>());
+	AddSystem<FrustumCulling>();
 }
 
 void SystemManager::Init()
@@ -42,17 +44,37 @@ void SystemManager::Init()
 
 void SystemManager::Update()
 {
-	for (auto& system : m_Systems)
+	const auto jobSystem = Engine::Get()->GetJobSystem();
+
+	if (jobSystem == nullptr || m_Systems.size() < 2)
 	{
-		system->Update();
+		for (auto& system : m_Systems)
+		{
+			system->Update();
+		}
+		return;
 	}
+
+	BuildDependencies();
+
+	//Systems without dependency start now, the others are scheduled by their last dependency
+	JobCounter counter;
+	for (size_t i = 0; i < m_Systems.size(); i++)
+	{
+		if (m_RemainingDependencies[i] == 0)
+		{
+			ScheduleSystem(i, *jobSystem, counter);
+		}
+	}
+
+	jobSystem->Wait(counter);
 }
 
 void SystemManager::Clear()
 {
 	m_Systems.clear();
 
-	m_Systems.push_back(std::make_unique<FrustumCulling>());
+	AddSystem<FrustumCulling>();
 }
 
 void SystemManager::Draw()
@@ -67,27 +89,49 @@ void SystemManager::Destroy()
 	}
 }
 
-void SystemManager::AddComponent(const Entity entity, const ComponentMask oldMask, ComponentMask newMask)
+void SystemManager::BuildDependencies()
 {
-	for (auto& system : m_Systems)
+	const auto systemNmb = m_Systems.size();
+
+	if (m_RemainingDependencies.size() != systemNmb)
+	{
+		m_RemainingDependencies = std::vector<std::atomic<uint32_t>>(systemNmb);
+	}
+
+	m_Dependents.resize(systemNmb);
+	for (size_t i = 0; i < systemNmb; i++)
 	{
-		const auto systemMask = system->GetSignature();
-		if (newMask.IsNewMatch(oldMask, systemMask))
+		m_Dependents[i].clear();
+
+		uint32_t dependencyNmb = 0;
+		for (size_t j = 0; j < i; j++)
 		{
-			system->RegisterEntity(entity);
+			//Conflicting systems keep their insertion order
+			if (m_Systems[i]->ConflictsWith(*m_Systems[j]))
+			{
+				m_Dependents[j].push_back(i);
+				dependencyNmb++;
+			}
 		}
+
+		m_RemainingDependencies[i].store(dependencyNmb, std::memory_order_relaxed);
 	}
 }
 
-void SystemManager::DestroyComponent(const Entity entity, const ComponentMask oldMask, ComponentMask newMask)
+void SystemManager::ScheduleSystem(const size_t systemIndex, JobSystem& jobSystem, JobCounter& counter)
 {
-	for (auto& system : m_Systems)
+	jobSystem.Schedule([this, systemIndex, &jobSystem, &counter]()
 	{
-		const auto systemMask = system->GetSignature();
-		if (newMask.IsNoLongerMatch(oldMask, systemMask))
+		m_Systems[systemIndex]->Update();
+
+		//Dependents are scheduled before this job is counted as done, the counter can't reach zero in between
+		for (const auto dependent : m_Dependents[systemIndex])
 		{
-			system->UnRegisterEntity(entity);
+			if (m_RemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				ScheduleSystem(dependent, jobSystem, counter);
+			}
 		}
-	}
+	}, &counter);
 }
 }
@@ -0,0 +1,459 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <component/transform.h>
+#include <component/drawable.h>
+#include <physic/bounding_sphere.h>
+#include <component/component_storage.h>
+#include <entity/archetype.h>
+#include <graphics/frustum.h>
+#include <graphics/bounding_volume_hierarchy.h>
+#include <graphics/occlusion_buffer.h>
+#include <graphics/draw_list.h>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+namespace
+{
+const size_t BENCHMARK_ENTITY_NMB = 1000000;
+const size_t BENCHMARK_TRANSFORM_NMB = 200003;
+
+template<typename Func>
+float MeasureMilliseconds(Func func)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	func();
+	const auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end - start).count();
+}
+
+bool IsInsideSphere(const dm::Transform& transform, const dm::BoundingSphere& boundingSphere)
+{
+	return transform.position.x * transform.position.x + transform.position.z * transform.position.z < (100.0f + boundingSphere.radius) * (100.0f + boundingSphere.radius);
+}
+}
+
+TEST(Benchmark, ArchetypeIteration)
+{
+	//Per manager sparse sets, gathered entity by entity like the systems do with the registered entities
+	dm::ComponentStorage<dm::Transform> transforms;
+	dm::ComponentStorage<dm::BoundingSphere> boundingSpheres;
+	dm::ComponentStorage<dm::Drawable> drawables;
+	std::vector<dm::Entity> registeredEntities;
+	registeredEntities.reserve(BENCHMARK_ENTITY_NMB);
+
+	dm::ArchetypeStorage archetypeStorage;
+	archetypeStorage.RegisterComponent<dm::Transform>(ComponentType::TRANSFORM);
+	archetypeStorage.RegisterComponent<dm::BoundingSphere>(ComponentType::BOUNDING_SPHERE);
+	archetypeStorage.RegisterComponent<dm::Drawable>(ComponentType::DRAWABLE);
+
+	for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i++)
+	{
+		const auto entity = dm::MakeEntity(static_cast<dm::EntityIndex>(i), 0);
+
+		dm::Transform transform;
+		transform.position = glm::vec3(static_cast<float>(i % 1000), 0.0f, static_cast<float>(i / 1000));
+
+		transforms.Insert(entity, transform);
+		boundingSpheres.Insert(entity, dm::BoundingSphere());
+		drawables.Insert(entity, dm::Drawable());
+		registeredEntities.push_back(entity);
+
+		archetypeStorage.AddComponent(entity, ComponentType::TRANSFORM, transform);
+		archetypeStorage.AddComponent(entity, ComponentType::BOUNDING_SPHERE, dm::BoundingSphere());
+		archetypeStorage.AddComponent(entity, ComponentType::DRAWABLE, dm::Drawable());
+	}
+
+	EXPECT_EQ(archetypeStorage.GetArchetypeCount(), 3);
+
+	size_t sparseVisible = 0;
+	const auto sparseTime = MeasureMilliseconds([&]()
+	{
+		for (auto entity : registeredEntities)
+		{
+			auto drawable = drawables.Get(entity);
+			drawable->isDrawable = IsInsideSphere(*transforms.Get(entity), *boundingSpheres.Get(entity));
+			sparseVisible += drawable->isDrawable;
+		}
+	});
+
+	dm::ComponentMask signature;
+	signature.AddComponent(ComponentType::TRANSFORM);
+	signature.AddComponent(ComponentType::BOUNDING_SPHERE);
+	signature.AddComponent(ComponentType::DRAWABLE);
+
+	size_t archetypeVisible = 0;
+	const auto archetypeTime = MeasureMilliseconds([&]()
+	{
+		archetypeStorage.ForEachChunk(signature, [&](const dm::ArchetypeChunkView& chunk)
+		{
+			const auto transformColumn = chunk.GetColumn<dm::Transform>(ComponentType::TRANSFORM);
+			const auto boundingSphereColumn = chunk.GetColumn<dm::BoundingSphere>(ComponentType::BOUNDING_SPHERE);
+			const auto drawableColumn = chunk.GetColumn<dm::Drawable>(ComponentType::DRAWABLE);
+
+			for (uint32_t i = 0; i < chunk.Size(); i++)
+			{
+				drawableColumn[i].isDrawable = IsInsideSphere(transformColumn[i], boundingSphereColumn[i]);
+				archetypeVisible += drawableColumn[i].isDrawable;
+			}
+		});
+	});
+
+	std::cout << "Sparse set iteration of " << BENCHMARK_ENTITY_NMB << " entities: " << sparseTime << " ms\n";
+	std::cout << "Archetype iteration of " << BENCHMARK_ENTITY_NMB << " entities: " << archetypeTime << " ms\n";
+
+	EXPECT_EQ(sparseVisible, archetypeVisible);
+}
+
+TEST(Benchmark, WorldMatrixBatch)
+{
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+	std::vector<dm::Transform> transforms(BENCHMARK_TRANSFORM_NMB);
+	dm::TransformSoA transformsSoA;
+	transformsSoA.Reserve(BENCHMARK_TRANSFORM_NMB);
+
+	for (auto& transform : transforms)
+	{
+		transform.position = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+		transform.rotation = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+		transform.scale = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+		transformsSoA.Add(transform);
+	}
+
+	std::vector<glm::mat4x4> batchMatrices(BENCHMARK_TRANSFORM_NMB);
+	std::vector<glm::mat4x4*> batchOutputs(BENCHMARK_TRANSFORM_NMB);
+	for (size_t i = 0; i < BENCHMARK_TRANSFORM_NMB; i++)
+	{
+		batchOutputs[i] = &batchMatrices[i];
+	}
+
+	const auto glmTime = MeasureMilliseconds([&]()
+	{
+		for (auto& transform : transforms)
+		{
+			transform.worldMatrix = dm::TransformManager::ComputeWorldMatrix(transform);
+		}
+	});
+
+	const auto batchTime = MeasureMilliseconds([&]()
+	{
+		dm::TransformManager::ComputeWorldMatrices(transformsSoA, batchOutputs.data());
+	});
+
+	std::cout << "glm world matrices of " << BENCHMARK_TRANSFORM_NMB << " transforms: " << glmTime << " ms\n";
+	std::cout << "Batched world matrices of " << BENCHMARK_TRANSFORM_NMB << " transforms: " << batchTime << " ms\n";
+
+	for (size_t i = 0; i < BENCHMARK_TRANSFORM_NMB; i++)
+	{
+		for (auto column = 0; column < 4; column++)
+		{
+			for (auto row = 0; row < 4; row++)
+			{
+				ASSERT_NEAR(transforms[i].worldMatrix[column][row], batchMatrices[i][column][row], 1e-4f);
+			}
+		}
+	}
+}
+
+TEST(Benchmark, FrustumCullingBatch)
+{
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> positionDistribution(-150.0f, 150.0f);
+	std::uniform_real_distribution<float> radiusDistribution(0.1f, 5.0f);
+
+	dm::BoundingSphereSoA spheres;
+	spheres.Reserve(BENCHMARK_ENTITY_NMB);
+	for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i++)
+	{
+		spheres.Add(
+			glm::vec3(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator)),
+			radiusDistribution(generator));
+	}
+
+	const auto view = glm::lookAt(glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const auto projection = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+	const auto frustum = dm::Frustum::FromMatrix(projection * view);
+
+	std::vector<uint32_t> scalarIndices;
+	const auto scalarTime = MeasureMilliseconds([&]()
+	{
+		for (size_t i = 0; i < spheres.Size(); i++)
+		{
+			if (frustum.IsVisible(glm::vec3(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]), spheres.radius[i]))
+			{
+				scalarIndices.push_back(static_cast<uint32_t>(i));
+			}
+		}
+	});
+
+	std::vector<uint32_t> batchIndices;
+	const auto batchTime = MeasureMilliseconds([&]()
+	{
+		frustum.CullSpheres(spheres, batchIndices);
+	});
+
+	std::cout << "Scalar culling of " << BENCHMARK_ENTITY_NMB << " spheres: " << scalarTime << " ms\n";
+	std::cout << "Batched culling of " << BENCHMARK_ENTITY_NMB << " spheres: " << batchTime << " ms, " << batchIndices.size() << " visible\n";
+
+	ASSERT_FALSE(batchIndices.empty());
+	ASSERT_LT(batchIndices.size(), spheres.Size());
+	ASSERT_EQ(scalarIndices, batchIndices);
+
+	//The camera looks toward +z, a sphere behind it is culled and one in front is kept
+	ASSERT_TRUE(frustum.IsVisible(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f));
+	ASSERT_FALSE(frustum.IsVisible(glm::vec3(0.0f, 0.0f, -20.0f), 1.0f));
+}
+
+TEST(Benchmark, BoundingVolumeHierarchyCulling)
+{
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> positionDistribution(-1000.0f, 1000.0f);
+	std::uniform_real_distribution<float> radiusDistribution(0.1f, 5.0f);
+
+	dm::BoundingSphereSoA spheres;
+	spheres.Reserve(BENCHMARK_ENTITY_NMB);
+	dm::BoundingVolumeHierarchy hierarchy;
+	std::vector<dm::BoundingVolumeHierarchy::ProxyId> proxies;
+	proxies.reserve(BENCHMARK_ENTITY_NMB);
+
+	for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i++)
+	{
+		const auto center = glm::vec3(positionDistribution(generator), 0.0f, positionDistribution(generator));
+		const auto radius = radiusDistribution(generator);
+		spheres.Add(center, radius);
+		proxies.push_back(hierarchy.Insert(static_cast<dm::Entity>(i), center, radius));
+	}
+
+	//Move a part of the world, small moves stay in the enlarged leaves and the others are reinserted
+	for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i += 10)
+	{
+		const auto center = glm::vec3(spheres.centerX[i] + (i % 20 == 0 ? 0.01f : 50.0f), 0.0f, spheres.centerZ[i]);
+		spheres.centerX[i] = center.x;
+		hierarchy.Move(proxies[i], center, spheres.radius[i]);
+	}
+
+	const auto view = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, 10.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const auto projection = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 300.0f);
+	const auto frustum = dm::Frustum::FromMatrix(projection * view);
+
+	std::vector<uint32_t> linearIndices;
+	const auto linearTime = MeasureMilliseconds([&]()
+	{
+		frustum.CullSpheres(spheres, linearIndices);
+	});
+
+	std::vector<dm::Entity> hierarchyEntities;
+	const auto hierarchyTime = MeasureMilliseconds([&]()
+	{
+		hierarchy.Query(frustum, hierarchyEntities);
+	});
+
+	std::cout << "Linear culling of " << BENCHMARK_ENTITY_NMB << " spheres: " << linearTime << " ms\n";
+	std::cout << "Hierarchy culling of " << BENCHMARK_ENTITY_NMB << " spheres: " << hierarchyTime << " ms, height " << hierarchy.GetHeight() << "\n";
+
+	std::sort(hierarchyEntities.begin(), hierarchyEntities.end());
+	ASSERT_FALSE(hierarchyEntities.empty());
+	ASSERT_EQ(linearIndices.size(), hierarchyEntities.size());
+	for (size_t i = 0; i < linearIndices.size(); i++)
+	{
+		ASSERT_EQ(linearIndices[i], hierarchyEntities[i]);
+	}
+}
+
+TEST(Benchmark, MultiViewCulling)
+{
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> positionDistribution(-1000.0f, 1000.0f);
+	std::uniform_real_distribution<float> radiusDistribution(0.1f, 5.0f);
+
+	dm::BoundingVolumeHierarchy hierarchy;
+
+	for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i++)
+	{
+		const auto center = glm::vec3(positionDistribution(generator), 0.0f, positionDistribution(generator));
+		hierarchy.Insert(static_cast<dm::Entity>(i), center, radiusDistribution(generator));
+	}
+
+	//Two cameras looking at different part of the world and a shadow box overlapping the first one
+	const auto projection = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 300.0f);
+	const auto lightView = glm::lookAt(glm::vec3(0.0f, 200.0f, 100.0f), glm::vec3(0.0f, 0.0f, 100.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	const dm::Frustum frustums[] = {
+		dm::Frustum::FromMatrix(projection * glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, 10.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f))),
+		dm::Frustum::FromMatrix(projection * glm::lookAt(glm::vec3(500.0f, 10.0f, 0.0f), glm::vec3(500.0f, 10.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f))),
+		dm::Frustum::FromMatrix(glm::ortho(-150.0f, 150.0f, -150.0f, 150.0f, 150.0f, 250.0f) * lightView)
+	};
+	const uint32_t planeMasks[] = {
+		dm::Frustum::ALL_PLANES,
+		dm::Frustum::ALL_PLANES,
+		dm::Frustum::ALL_PLANES & ~(1u << dm::Frustum::NEAR_PLANE)
+	};
+	const size_t viewNmb = 3;
+
+	std::vector<dm::Entity> sharedEntities[viewNmb];
+	dm::BoundingVolumeHierarchy::FrustumQuery queries[viewNmb];
+	for (size_t i = 0; i < viewNmb; i++)
+	{
+		queries[i] = { &frustums[i], planeMasks[i], &sharedEntities[i] };
+	}
+
+	const auto sharedTime = MeasureMilliseconds([&]()
+	{
+		hierarchy.Query(queries, viewNmb);
+	});
+
+	std::vector<dm::Entity> separateEntities[viewNmb];
+	const auto separateTime = MeasureMilliseconds([&]()
+	{
+		for (size_t i = 0; i < viewNmb; i++)
+		{
+			const dm::BoundingVolumeHierarchy::FrustumQuery query = { &frustums[i], planeMasks[i], &separateEntities[i] };
+			hierarchy.Query(&query, 1);
+		}
+	});
+
+	std::cout << "Shared traversal of " << viewNmb << " views: " << sharedTime << " ms\n";
+	std::cout << "Separate traversals of " << viewNmb << " views: " << separateTime << " ms\n";
+
+	for (size_t i = 0; i < viewNmb; i++)
+	{
+		std::sort(sharedEntities[i].begin(), sharedEntities[i].end());
+		std::sort(separateEntities[i].begin(), separateEntities[i].end());
+		ASSERT_FALSE(sharedEntities[i].empty());
+		ASSERT_EQ(separateEntities[i], sharedEntities[i]);
+	}
+}
+
+TEST(Benchmark, OcclusionCulling)
+{
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> positionDistribution(-150.0f, 150.0f);
+	std::uniform_real_distribution<float> depthDistribution(1.0f, 280.0f);
+	std::uniform_real_distribution<float> radiusDistribution(0.1f, 5.0f);
+
+	const auto view = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, 10.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const auto projection = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 300.0f);
+
+	//A wall hiding the left half of the screen, its edge is aligned with the camera
+	const std::vector<glm::vec3> wallPositions = {
+		glm::vec3(-100.0f, -500.0f, 50.0f), glm::vec3(0.0f, -500.0f, 50.0f),
+		glm::vec3(0.0f, 500.0f, 50.0f), glm::vec3(-100.0f, 500.0f, 50.0f) };
+	const std::vector<uint32_t> wallIndices = { 0, 1, 2, 0, 2, 3 };
+
+	std::vector<glm::vec3> centers;
+	std::vector<float> radiuses;
+	for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i++)
+	{
+		centers.emplace_back(positionDistribution(generator), 10.0f, depthDistribution(generator));
+		radiuses.push_back(radiusDistribution(generator));
+	}
+
+	dm::OcclusionBuffer occlusionBuffer;
+	const auto rasterizationTime = MeasureMilliseconds([&]()
+	{
+		occlusionBuffer.Clear(projection * view);
+		occlusionBuffer.Rasterize(wallPositions, wallIndices, glm::mat4x4(1.0f));
+		occlusionBuffer.BuildHierarchy();
+	});
+
+	std::vector<bool> occluded(BENCHMARK_ENTITY_NMB);
+	const auto testTime = MeasureMilliseconds([&]()
+	{
+		for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i++)
+		{
+			occluded[i] = occlusionBuffer.IsOccluded(centers[i], radiuses[i]);
+		}
+	});
+
+	size_t hiddenNmb = 0;
+	size_t occludedNmb = 0;
+	for (size_t i = 0; i < BENCHMARK_ENTITY_NMB; i++)
+	{
+		const auto isHidden = centers[i].x + radiuses[i] < 0.0f && centers[i].z - radiuses[i] > 50.0f;
+		hiddenNmb += isHidden;
+		occludedNmb += occluded[i];
+
+		//The test is conservative, a sphere in sight is never occluded
+		ASSERT_TRUE(isHidden || !occluded[i]);
+	}
+
+	std::cout << "Occluder rasterization: " << rasterizationTime << " ms\n";
+	std::cout << "Occlusion test of " << BENCHMARK_ENTITY_NMB << " spheres: " << testTime << " ms, " << occludedNmb << " occluded of " << hiddenNmb << " hidden\n";
+
+	ASSERT_GT(occludedNmb, hiddenNmb / 2);
+}
+
+TEST(Benchmark, DrawListSort)
+{
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<uint32_t> pipelineDistribution(0, 7);
+	std::uniform_int_distribution<uint32_t> materialDistribution(0, 255);
+	std::uniform_int_distribution<uint32_t> meshDistribution(0, 63);
+	std::uniform_real_distribution<float> depthDistribution(0.0f, 1.0f);
+
+	dm::DrawList drawList;
+	std::vector<dm::DrawList::Draw> expectedDraws;
+	for (uint32_t i = 0; i < BENCHMARK_TRANSFORM_NMB; i++)
+	{
+		const auto key = dm::DrawList::MakeKey(0,
+			pipelineDistribution(generator),
+			materialDistribution(generator),
+			meshDistribution(generator),
+			depthDistribution(generator));
+		drawList.Add(key, i);
+		expectedDraws.push_back({ key, i });
+	}
+
+	const auto radixTime = MeasureMilliseconds([&]()
+	{
+		drawList.Sort();
+	});
+
+	const auto comparisonTime = MeasureMilliseconds([&]()
+	{
+		std::stable_sort(expectedDraws.begin(), expectedDraws.end(), [](const dm::DrawList::Draw& a, const dm::DrawList::Draw& b)
+		{
+			return a.key < b.key;
+		});
+	});
+
+	//The radix sort is stable, draws with the same key keep their insertion order
+	const auto& draws = drawList.GetDraws();
+	ASSERT_EQ(expectedDraws.size(), draws.size());
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		ASSERT_EQ(expectedDraws[i].key, draws[i].key);
+		ASSERT_EQ(expectedDraws[i].index, draws[i].index);
+	}
+
+	std::cout << "Radix sort of " << BENCHMARK_TRANSFORM_NMB << " draws: " << radixTime << " ms\n";
+	std::cout << "Comparison sort of " << BENCHMARK_TRANSFORM_NMB << " draws: " << comparisonTime << " ms\n";
+}
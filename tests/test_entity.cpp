@@ -30,7 +30,15 @@ SOFTWARE.
 #include <entity/entity_handle.h>
 #include <graphics/graphic_manager.h>
 #include <component/model.h>
+#include <physic/bounding_sphere.h>
 #include <engine/engine.h>
+#include <entity/entity_command_buffer.h>
+#include <entity/archetype.h>
+#include <component/camera.h>
+#include <component/drawable.h>
+#include <system/system_manager.h>
+#include <algorithm>
+#include <thread>
 
 
 TEST(Entity, CreateEntity)
@@ -84,6 +92,30 @@ TEST(Entity, CreateAndDestroyEntity)
 	GTEST_TEST_NO_THROW_(CreateAndDelete(entityManager), GTEST_FATAL_FAILURE_);
 }
 
+TEST(Entity, RecycleEntity)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	const auto entityManager = engine.GetEntityManager();
+
+	const auto e0 = entityManager->CreateEntity();
+	const auto e1 = entityManager->CreateEntity();
+
+	entityManager->DestroyEntity(e0);
+	ASSERT_FALSE(entityManager->IsAlive(e0));
+	ASSERT_TRUE(entityManager->IsAlive(e1));
+
+	const auto e2 = entityManager->CreateEntity();
+
+	ASSERT_EQ(dm::GetEntityIndex(e0), dm::GetEntityIndex(e2));
+	ASSERT_EQ(dm::GetEntityGeneration(e0) + 1, dm::GetEntityGeneration(e2));
+	ASSERT_NE(e0, e2);
+	ASSERT_FALSE(entityManager->IsAlive(e0));
+	ASSERT_TRUE(entityManager->IsAlive(e2));
+	ASSERT_EQ(2u, entityManager->GetEntities().size());
+}
+
 TEST(Entity, TransformComponentEntity)
 {
 	dm::Engine engine;
@@ -166,6 +198,55 @@ TEST(Entity, DestroyComponentEntity)
 	ASSERT_FALSE(entity.HasComponent(ComponentType::TRANSFORM));
 }
 
+TEST(Entity, SparseComponentStorage)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto cameraManager = engine.GetComponentManager()->GetCameraManager();
+
+	for (size_t i = 0; i < 50; i++)
+	{
+		entityManager->CreateEntity();
+	}
+
+	const auto e0 = entityManager->CreateEntity();
+	auto entity = dm::EntityHandle(e0);
+	entity.CreateComponent<dm::Camera>(ComponentType::CAMERA);
+
+	ASSERT_EQ(1u, cameraManager->GetComponents().Size());
+	ASSERT_NE(nullptr, cameraManager->GetComponent(e0));
+
+	entity.DestroyComponent(ComponentType::CAMERA);
+
+	ASSERT_EQ(0u, cameraManager->GetComponents().Size());
+	ASSERT_EQ(nullptr, cameraManager->GetComponent(e0));
+}
+
+TEST(Entity, DestroyEntityReleaseComponents)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto cameraManager = engine.GetComponentManager()->GetCameraManager();
+
+	const auto e0 = entityManager->CreateEntity();
+	dm::EntityHandle(e0).CreateComponent<dm::Camera>(ComponentType::CAMERA);
+	ASSERT_EQ(1u, cameraManager->GetComponents().Size());
+
+	entityManager->DestroyEntity(e0);
+	ASSERT_EQ(0u, cameraManager->GetComponents().Size());
+
+	//The new entity recycles the slot of e0 and must not inherit its camera
+	const auto e1 = entityManager->CreateEntity();
+	ASSERT_EQ(dm::GetEntityIndex(e0), dm::GetEntityIndex(e1));
+	ASSERT_FALSE(entityManager->HasComponent(e1, ComponentType::CAMERA));
+	ASSERT_EQ(nullptr, cameraManager->GetComponent(e1));
+	ASSERT_EQ(nullptr, cameraManager->GetComponent(e0));
+}
+
 TEST(Entity, SystemAddComponent)
 {
 	dm::Engine engine;
@@ -187,4 +268,405 @@ TEST(Entity, SystemAddComponent)
 	cameraInfo.projectionMatrix = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
 
 	auto camera = entity.AddComponent<dm::Camera>(cameraInfo);
-}
\ No newline at end of file
+}
+
+TEST(Entity, CommandBuffer)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto transformManager = engine.GetComponentManager()->GetTransformManager();
+
+	const auto e0 = entityManager->CreateEntity();
+	dm::EntityHandle(e0).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+
+	std::thread recorder([entityManager, e0]()
+	{
+		auto& commandBuffer = entityManager->GetCommandBuffer();
+
+		const auto newEntity = commandBuffer.CreateEntity();
+		dm::Transform transform;
+		transform.position = glm::vec3(1.0f, 2.0f, 3.0f);
+		commandBuffer.AddComponent(newEntity, ComponentType::TRANSFORM, transform);
+
+		commandBuffer.DestroyEntity(e0);
+	});
+	recorder.join();
+
+	//Nothing is applied before the sync point
+	ASSERT_TRUE(entityManager->IsAlive(e0));
+	ASSERT_EQ(1u, entityManager->GetEntityCount());
+
+	entityManager->PlaybackCommandBuffers();
+
+	ASSERT_FALSE(entityManager->IsAlive(e0));
+	ASSERT_EQ(1u, entityManager->GetEntityCount());
+	ASSERT_EQ(1u, transformManager->GetComponents().Size());
+
+	const auto e1 = entityManager->GetEntities()[0];
+	ASSERT_TRUE(entityManager->HasComponent(e1, ComponentType::TRANSFORM));
+	ASSERT_EQ(2.0f, transformManager->GetComponent(e1)->position.y);
+}
+
+TEST(Entity, CreateEntitiesInBatch)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto transformManager = engine.GetComponentManager()->GetTransformManager();
+
+	const size_t entityNmb = INIT_ENTITY_NMB * 10;
+	const auto entities = entityManager->CreateEntities(entityNmb);
+
+	ASSERT_EQ(entityNmb, entities.size());
+	ASSERT_EQ(entityNmb, entityManager->GetEntityCount());
+
+	dm::ComponentMask mask;
+	mask.AddComponent(ComponentType::TRANSFORM);
+	mask.AddComponent(ComponentType::BOUNDING_SPHERE);
+	entityManager->AddComponents(entities, mask);
+
+	ASSERT_EQ(entityNmb, transformManager->GetComponents().Size());
+	for (auto entity : entities)
+	{
+		ASSERT_TRUE(entityManager->HasComponent(entity, ComponentType::TRANSFORM));
+		ASSERT_TRUE(entityManager->HasComponent(entity, ComponentType::BOUNDING_SPHERE));
+		ASSERT_FALSE(entityManager->HasComponent(entity, ComponentType::CAMERA));
+	}
+}
+
+TEST(Entity, AddComponentsGroupedMasks)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto transformManager = engine.GetComponentManager()->GetTransformManager();
+
+	dm::ComponentMask signature;
+	signature.AddComponent(ComponentType::TRANSFORM);
+	signature.AddComponent(ComponentType::DRAWABLE);
+	const auto& query = entityManager->GetQuery(signature);
+
+	const auto entities = entityManager->CreateEntities(8);
+
+	//Half of the entities already have a transform, as a decoded one not yet in the mask or as an attached one
+	dm::Transform transform;
+	transform.componentType = ComponentType::TRANSFORM;
+	transform.position.x = 3.0f;
+	for (size_t i = 0; i < entities.size(); i += 2)
+	{
+		transformManager->AddComponent(entities[i], transform);
+		if (i % 4 == 0)
+		{
+			entityManager->AddComponent(entities[i], ComponentType::TRANSFORM);
+		}
+	}
+
+	entityManager->AddComponents(entities, signature);
+
+	ASSERT_EQ(entities.size(), query.Size());
+	ASSERT_EQ(entities.size(), transformManager->GetComponents().Size());
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		ASSERT_TRUE(query.Contains(entities[i]));
+		ASSERT_EQ(signature, entityManager->GetEntityMask(entities[i]));
+		ASSERT_EQ(i % 2 == 0 ? 3.0f : 0.0f, transformManager->GetComponent(entities[i])->position.x);
+	}
+}
+
+TEST(Entity, StableComponentPointers)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto transformManager = engine.GetComponentManager()->GetTransformManager();
+
+	const auto e0 = entityManager->CreateEntity();
+	const auto transform = dm::EntityHandle(e0).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+
+	dm::Camera cameraInfo;
+	cameraInfo.componentType = ComponentType::CAMERA;
+	cameraInfo.isMain = true;
+	const auto camera = dm::EntityHandle(e0).AddComponent<dm::Camera>(cameraInfo);
+
+	//Grow the entities and the storages over several pages, then remove half of the components
+	std::vector<dm::Entity> entities;
+	for (size_t i = 0; i < INIT_ENTITY_NMB * 20; i++)
+	{
+		const auto entity = entityManager->CreateEntity();
+		dm::EntityHandle(entity).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+		entities.push_back(entity);
+	}
+
+	for (size_t i = 0; i < entities.size(); i += 2)
+	{
+		dm::EntityHandle(entities[i]).DestroyComponent(ComponentType::TRANSFORM);
+	}
+
+	ASSERT_EQ(transform, transformManager->GetComponent(e0));
+	ASSERT_EQ(camera, dm::GraphicManager::Get()->GetCamera());
+	ASSERT_EQ(entities.size() / 2 + 1, transformManager->GetComponents().Size());
+}
+
+TEST(Entity, TransformDirtyTracking)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto transformManager = engine.GetComponentManager()->GetTransformManager();
+
+	const auto e0 = entityManager->CreateEntity();
+	auto transform = dm::EntityHandle(e0).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+	transform->position = glm::vec3(1.0f, 2.0f, 3.0f);
+
+	ASSERT_TRUE(transform->dirty);
+	transformManager->Update();
+	ASSERT_FALSE(transform->dirty);
+	ASSERT_FLOAT_EQ(2.0f, dm::TransformManager::GetWorldMatrix(*transform)[3].y);
+
+	//The cached matrix is only refreshed by the next update
+	transform->SetPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+	ASSERT_TRUE(transform->dirty);
+	ASSERT_FLOAT_EQ(2.0f, dm::TransformManager::GetWorldMatrix(*transform)[3].y);
+
+	transformManager->Update();
+	ASSERT_FLOAT_EQ(5.0f, dm::TransformManager::GetWorldMatrix(*transform)[3].y);
+}
+
+TEST(Entity, TransformHierarchy)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto transformManager = engine.GetComponentManager()->GetTransformManager();
+
+	const auto cart = entityManager->CreateEntity();
+	const auto lamp = entityManager->CreateEntity();
+
+	auto cartTransform = dm::EntityHandle(cart).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+	auto lampTransform = dm::EntityHandle(lamp).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+	cartTransform->position = glm::vec3(10.0f, 0.0f, 0.0f);
+	lampTransform->position = glm::vec3(0.0f, 2.0f, 0.0f);
+
+	transformManager->SetParent(lamp, cart);
+	ASSERT_EQ(cart, transformManager->GetParent(lamp));
+	ASSERT_THROW(transformManager->SetParent(cart, lamp), std::runtime_error);
+
+	transformManager->Update();
+	ASSERT_FLOAT_EQ(10.0f, lampTransform->worldMatrix[3].x);
+	ASSERT_FLOAT_EQ(2.0f, lampTransform->worldMatrix[3].y);
+
+	//Moving the parent moves the child without touching it
+	cartTransform->SetPosition(glm::vec3(-5.0f, 0.0f, 0.0f));
+	transformManager->Update();
+	ASSERT_FLOAT_EQ(-5.0f, lampTransform->worldMatrix[3].x);
+	ASSERT_FALSE(lampTransform->dirty);
+
+	//Removing the parent turns the child into a root
+	dm::EntityHandle(cart).DestroyComponent(ComponentType::TRANSFORM);
+	transformManager->Update();
+	ASSERT_EQ(dm::INVALID_ENTITY, transformManager->GetParent(lamp));
+	ASSERT_FLOAT_EQ(0.0f, lampTransform->worldMatrix[3].x);
+}
+
+TEST(Entity, BoundingSphereWorldCache)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto componentManager = engine.GetComponentManager();
+
+	const auto e0 = entityManager->CreateEntity();
+	auto transform = dm::EntityHandle(e0).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+	transform->position = glm::vec3(10.0f, 0.0f, 0.0f);
+	transform->scale = glm::vec3(2.0f, 1.0f, 1.0f);
+
+	//Mesh space bounds of a pole standing on its pivot
+	dm::BoundingSphere component;
+	component.componentType = ComponentType::BOUNDING_SPHERE;
+	component.center = glm::vec3(0.0f, 2.0f, 0.0f);
+	component.radius = 2.0f;
+	component.aabb = dm::Aabb{ glm::vec3(-0.5f, 0.0f, -0.5f), glm::vec3(0.5f, 4.0f, 0.5f) };
+	auto boundingSphere = dm::EntityHandle(e0).AddComponent<dm::BoundingSphere>(component);
+
+	componentManager->Update();
+	ASSERT_FLOAT_EQ(10.0f, boundingSphere->worldCenter.x);
+	ASSERT_FLOAT_EQ(2.0f, boundingSphere->worldCenter.y);
+	ASSERT_FLOAT_EQ(4.0f, boundingSphere->worldRadius);
+	ASSERT_FLOAT_EQ(9.0f, boundingSphere->worldAabb.min.x);
+	ASSERT_FLOAT_EQ(11.0f, boundingSphere->worldAabb.max.x);
+	ASSERT_FLOAT_EQ(4.0f, boundingSphere->worldAabb.max.y);
+
+	//The cache is only refreshed when the transform is updated
+	boundingSphere->worldRadius = 0.0f;
+	componentManager->Update();
+	ASSERT_FLOAT_EQ(0.0f, boundingSphere->worldRadius);
+
+	transform->SetPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+	componentManager->Update();
+	ASSERT_FLOAT_EQ(7.0f, boundingSphere->worldCenter.y);
+	ASSERT_FLOAT_EQ(4.0f, boundingSphere->worldRadius);
+	ASSERT_FLOAT_EQ(5.0f, boundingSphere->worldAabb.min.y);
+}
+
+TEST(Entity, QueryCache)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+
+	const auto e0 = entityManager->CreateEntity();
+	const auto e1 = entityManager->CreateEntity();
+	dm::EntityHandle(e0).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+
+	dm::ComponentMask signature;
+	signature.AddComponent(ComponentType::TRANSFORM);
+	signature.AddComponent(ComponentType::MODEL);
+
+	//The query is built from the entities alive when first requested
+	const auto& query = entityManager->GetQuery(signature);
+	ASSERT_EQ(0u, query.Size());
+
+	entityManager->AddComponent(e0, ComponentType::MODEL);
+	ASSERT_TRUE(query.Contains(e0));
+	ASSERT_EQ(&query, &entityManager->GetQuery(signature));
+
+	entityManager->AddComponents({ e1 }, signature);
+	ASSERT_EQ(2u, query.Size());
+
+	entityManager->DestroyComponent(e0, ComponentType::MODEL);
+	ASSERT_FALSE(query.Contains(e0));
+
+	dm::EntityHandle(e1).Destroy();
+	ASSERT_EQ(0u, query.Size());
+}
+
+dm::Entity CreateBoundedDrawable(dm::EntityManager* entityManager, const glm::vec3& position)
+{
+	const auto entity = entityManager->CreateEntity();
+	auto transform = dm::EntityHandle(entity).CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+	transform->position = position;
+	dm::EntityHandle(entity).CreateComponent<dm::Drawable>(ComponentType::DRAWABLE);
+
+	dm::BoundingSphere component;
+	component.componentType = ComponentType::BOUNDING_SPHERE;
+	component.radius = 1.0f;
+	dm::EntityHandle(entity).AddComponent<dm::BoundingSphere>(component);
+	return entity;
+}
+
+bool IsVisible(dm::GraphicManager* graphicManager, const dm::Entity entity)
+{
+	const auto& visibleEntities = graphicManager->GetViews().front().visibleEntities.GetEntities();
+	return std::find(visibleEntities.begin(), visibleEntities.end(), entity) != visibleEntities.end();
+}
+
+TEST(Entity, CullingRecycledEntity)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	auto entityManager = engine.GetEntityManager();
+	auto componentManager = engine.GetComponentManager();
+
+	const auto cameraEntity = entityManager->CreateEntity();
+	dm::Camera cameraInfo;
+	cameraInfo.componentType = ComponentType::CAMERA;
+	cameraInfo.isCulling = true;
+	cameraInfo.viewMatrix = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	cameraInfo.projectionMatrix = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+	dm::EntityHandle(cameraEntity).AddComponent<dm::Camera>(cameraInfo);
+
+	//Behind the camera
+	const auto e0 = CreateBoundedDrawable(entityManager, glm::vec3(0.0f, 0.0f, 50.0f));
+	componentManager->Update();
+	engine.GetSystemManager()->Update();
+	ASSERT_FALSE(IsVisible(engine.GetGraphicManager(), e0));
+
+	//The slot of e0 is recycled before the next culling, the new entity is in front of the camera
+	entityManager->DestroyEntity(e0);
+	const auto e1 = CreateBoundedDrawable(entityManager, glm::vec3(0.0f));
+	ASSERT_EQ(dm::GetEntityIndex(e0), dm::GetEntityIndex(e1));
+
+	componentManager->Update();
+	engine.GetSystemManager()->Update();
+	ASSERT_TRUE(IsVisible(engine.GetGraphicManager(), e1));
+	ASSERT_FALSE(IsVisible(engine.GetGraphicManager(), e0));
+}
+
+TEST(Entity, ArchetypeMove)
+{
+	dm::ArchetypeStorage archetypeStorage;
+	archetypeStorage.RegisterComponent<dm::Transform>(ComponentType::TRANSFORM);
+	archetypeStorage.RegisterComponent<dm::Drawable>(ComponentType::DRAWABLE);
+
+	const auto entity0 = dm::MakeEntity(0, 0);
+	const auto entity1 = dm::MakeEntity(1, 0);
+
+	dm::Transform transform;
+	transform.position = glm::vec3(1.0f, 2.0f, 3.0f);
+	archetypeStorage.AddComponent(entity0, ComponentType::TRANSFORM, transform);
+	archetypeStorage.AddComponent(entity1, ComponentType::TRANSFORM, dm::Transform());
+	archetypeStorage.AddComponent(entity0, ComponentType::DRAWABLE, dm::Drawable());
+
+	EXPECT_EQ(archetypeStorage.GetComponent<dm::Transform>(entity0, ComponentType::TRANSFORM)->position.y, 2.0f);
+	EXPECT_TRUE(archetypeStorage.HasComponent(entity0, ComponentType::DRAWABLE));
+	EXPECT_FALSE(archetypeStorage.HasComponent(entity1, ComponentType::DRAWABLE));
+
+	archetypeStorage.RemoveComponent(entity0, ComponentType::DRAWABLE);
+	EXPECT_FALSE(archetypeStorage.HasComponent(entity0, ComponentType::DRAWABLE));
+	EXPECT_EQ(archetypeStorage.GetComponent<dm::Transform>(entity0, ComponentType::TRANSFORM)->position.z, 3.0f);
+
+	archetypeStorage.RemoveEntity(entity1);
+	EXPECT_EQ(archetypeStorage.GetComponent<dm::Transform>(entity1, ComponentType::TRANSFORM), nullptr);
+	EXPECT_EQ(archetypeStorage.GetComponent<dm::Transform>(entity0, ComponentType::TRANSFORM)->position.x, 1.0f);
+}
+
+TEST(Entity, ArchetypeAddComponentTwice)
+{
+	dm::ArchetypeStorage archetypeStorage;
+	archetypeStorage.RegisterComponent<dm::Transform>(ComponentType::TRANSFORM);
+
+	const auto entity0 = dm::MakeEntity(0, 0);
+	const auto entity1 = dm::MakeEntity(1, 0);
+
+	archetypeStorage.AddComponent(entity0, ComponentType::TRANSFORM, dm::Transform());
+	archetypeStorage.AddComponent(entity1, ComponentType::TRANSFORM, dm::Transform());
+
+	//The second add assigns the component in place, the rows of both entities are kept
+	dm::Transform transform;
+	transform.position = glm::vec3(4.0f, 5.0f, 6.0f);
+	archetypeStorage.AddComponent(entity0, ComponentType::TRANSFORM, transform);
+
+	EXPECT_EQ(archetypeStorage.GetArchetypeCount(), 1);
+	EXPECT_EQ(archetypeStorage.GetComponent<dm::Transform>(entity0, ComponentType::TRANSFORM)->position.x, 4.0f);
+	EXPECT_EQ(archetypeStorage.GetComponent<dm::Transform>(entity1, ComponentType::TRANSFORM)->position.x, 0.0f);
+
+	dm::ComponentMask signature;
+	signature.AddComponent(ComponentType::TRANSFORM);
+
+	size_t entityNmb = 0;
+	float positionSum = 0.0f;
+	archetypeStorage.ForEachChunk(signature, [&](const dm::ArchetypeChunkView& chunk)
+	{
+		const auto transformColumn = chunk.GetColumn<dm::Transform>(ComponentType::TRANSFORM);
+		for (uint32_t i = 0; i < chunk.Size(); i++)
+		{
+			positionSum += transformColumn[i].position.x;
+		}
+		entityNmb += chunk.Size();
+	});
+	EXPECT_EQ(entityNmb, 2);
+	EXPECT_EQ(positionSum, 4.0f);
+
+	archetypeStorage.RemoveEntity(entity1);
+	EXPECT_EQ(archetypeStorage.GetComponent<dm::Transform>(entity0, ComponentType::TRANSFORM)->position.z, 6.0f);
+}
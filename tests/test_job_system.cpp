@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+#include <engine/job_system.h>
+
+TEST(JobSystem, ParallelFor)
+{
+	dm::JobSystem jobSystem(4);
+	jobSystem.Init();
+
+	std::vector<int> values(100000, 1);
+	std::atomic<int> sum{ 0 };
+
+	jobSystem.ParallelFor(0, values.size(), [&](const size_t begin, const size_t end)
+	{
+		auto localSum = 0;
+		for (auto i = begin; i < end; i++)
+		{
+			localSum += values[i];
+		}
+		sum += localSum;
+	});
+
+	EXPECT_EQ(sum, 100000);
+}
+
+TEST(JobSystem, Dependencies)
+{
+	dm::JobSystem jobSystem(4);
+	jobSystem.Init();
+
+	std::atomic<int> firstStage{ 0 };
+	std::atomic<int> secondStageErrors{ 0 };
+
+	dm::JobCounter firstCounter;
+	dm::JobCounter secondCounter;
+
+	for (auto i = 0; i < 100; i++)
+	{
+		jobSystem.Schedule([&]() { ++firstStage; }, &firstCounter);
+	}
+
+	for (auto i = 0; i < 10; i++)
+	{
+		jobSystem.ScheduleAfter(firstCounter, [&]()
+		{
+			if (firstStage != 100)
+			{
+				++secondStageErrors;
+			}
+		}, &secondCounter);
+	}
+
+	jobSystem.Wait(secondCounter);
+
+	EXPECT_TRUE(firstCounter.IsDone());
+	EXPECT_EQ(secondStageErrors, 0);
+}
@@ -47,6 +47,9 @@ SOFTWARE.
 #include "component/lights/spot_light.h"
 #include "component/materials/material_terrain.h"
 #include "engine/prefab_factory.h"
+#include "graphics/renderer_meshes.h"
+
+#include <optional>
 
 TEST(Models, Cube)
 {
@@ -414,6 +417,115 @@ TEST(Models, FrustumCulling)
 	}
 }
 
+/**
+ * \brief Editor stopping the engine after a few frames with the number of instances kept by the culling of the last frame
+ */
+class GpuCullingEditor : public dm::Editor
+{
+public:
+	void Update() override
+	{
+		dm::Editor::Update();
+
+		if (++m_FrameNmb < FRAME_NMB)
+		{
+			return;
+		}
+
+		const auto rendererMeshes = dm::GraphicManager::Get()->GetRendererContainer()->Get<dm::RendererMeshes>();
+		if (rendererMeshes != nullptr && rendererMeshes->GetGpuCulling() != nullptr)
+		{
+			visibleCount = rendererMeshes->GetGpuCulling()->ReadVisibleCount();
+		}
+
+		dm::Engine::Get()->Stop();
+	}
+
+	static constexpr uint32_t FRAME_NMB = 8;
+
+	std::optional<uint32_t> visibleCount;
+private:
+	uint32_t m_FrameNmb = 0;
+};
+
+TEST(Models, GpuDrivenCulling)
+{
+	dm::EngineSettings settings;
+	settings.windowSize = dm::Vec2i(800, 600);
+	settings.gpuDrivenMeshes = true;
+	dm::Engine engine = dm::Engine(settings);
+	engine.Init();
+
+	engine.SetApplication(new GpuCullingEditor());
+
+	auto editor = static_cast<GpuCullingEditor*>(engine.GetApplication());
+
+	auto entityManager = engine.GetEntityManager();
+
+	//Camera at (0, 0, -10) looking toward +z
+	const auto e0 = entityManager->CreateEntity();
+	auto entity = dm::EntityHandle(e0);
+
+	dm::Camera cameraInfo;
+	cameraInfo.componentType = ComponentType::CAMERA;
+	cameraInfo.isMain = true;
+	cameraInfo.isCulling = true;
+	cameraInfo.viewMatrix = glm::lookAt(cameraInfo.position, cameraInfo.position + cameraInfo.front, cameraInfo.up);
+	cameraInfo.fov = 45;
+	cameraInfo.farFrustum = 1024.0f;
+	cameraInfo.nearFrustum = 0.1f;
+	cameraInfo.aspect = 800.0f / 600.0f;
+	cameraInfo.projectionMatrix = glm::perspective(glm::radians(cameraInfo.fov), cameraInfo.aspect, cameraInfo.nearFrustum, cameraInfo.farFrustum);
+
+	auto camera = entity.AddComponent<dm::Camera>(cameraInfo);
+
+	std::shared_ptr<dm::GizmoType> gizmoType = dm::GizmoType::Create(dm::Engine::Get()->GetModelManager()->GetModel("ModelSphere"), 1, dm::Color::White);
+
+	//Skybox
+	CreateSkybox(entityManager);
+
+	//Cubes sharing one mesh and one material are drawn with a single indirect draw.
+	//A row is 20 units in front of the camera, well inside the frustum, the other one 20 units behind it
+	const size_t rowCube = 10;
+
+	dm::MaterialDefault material;
+	material.componentType = ComponentType::MATERIAL_DEFAULT;
+	material.color = dm::Color(0.85f, 0.85f, 0.85f, 1);
+
+	for(size_t i = 0; i < rowCube; i++)
+	{
+		const auto x = i - rowCube / 2.0f;
+		CreateCube(glm::vec3(x, 0, 10), entityManager, editor, gizmoType, material);
+		CreateCube(glm::vec3(x, 0, -30), entityManager, editor, gizmoType, material);
+	}
+
+	//PointLight
+
+	const auto e1 = entityManager->CreateEntity();
+	auto light = dm::EntityHandle(e1);
+	light.CreateComponent<dm::Transform>(ComponentType::TRANSFORM);
+	dm::PointLight lightComponent;
+	lightComponent.componentType = ComponentType::POINT_LIGHT;
+	light.AddComponent(lightComponent);
+
+	try
+	{
+		engine.Start();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+	}
+
+	if (!editor->visibleCount)
+	{
+		GTEST_SKIP() << "The device can't draw indirect instances at an offset";
+	}
+
+	//Only the row in front of the camera is drawn
+	EXPECT_EQ(*editor->visibleCount, rowCube);
+}
+
 TEST(Models, PBR)
 {
 	dm::EngineSettings settings;
@@ -790,4 +902,119 @@ TEST(Models, Terrain)
 	{
 		std::cerr << e.what() << "\n";
 	}
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Editor stopping the engine after a few frames with the draw stats of the default meshes of the last frame
+ */
+class DrawStatsEditor : public dm::Editor
+{
+public:
+	void Update() override
+	{
+		dm::Editor::Update();
+
+		if (++m_FrameNmb < FRAME_NMB)
+		{
+			return;
+		}
+
+		const auto rendererMeshes = dm::GraphicManager::Get()->GetRendererContainer()->Get<dm::RendererMeshes>();
+		if (rendererMeshes != nullptr)
+		{
+			drawStats = *rendererMeshes->GetDrawStats();
+		}
+
+		dm::Engine::Get()->Stop();
+	}
+
+	static constexpr uint32_t FRAME_NMB = 8;
+
+	std::optional<dm::DrawStats> drawStats;
+private:
+	uint32_t m_FrameNmb = 0;
+};
+
+TEST(Models, InstancedForest)
+{
+	dm::EngineSettings settings;
+	settings.windowSize = dm::Vec2i(720, 640);
+	settings.instancedMeshes = true;
+	dm::Engine engine = dm::Engine(settings);
+	engine.Init();
+
+	engine.SetApplication(new DrawStatsEditor());
+
+	auto editor = static_cast<DrawStatsEditor*>(engine.GetApplication());
+
+	auto entityManager = engine.GetEntityManager();
+
+	//Camera above the forest looking down at its center, every prefab is inside the frustum
+	const auto e0 = entityManager->CreateEntity();
+	auto entity = dm::EntityHandle(e0);
+
+	dm::Camera cameraInfo;
+	cameraInfo.componentType = ComponentType::CAMERA;
+	cameraInfo.position = glm::vec3(0.0f, 120.0f, -120.0f);
+	cameraInfo.front = glm::normalize(-cameraInfo.position);
+	cameraInfo.up = glm::vec3(0.0f, 1.0f, 0.0f);
+	cameraInfo.isMain = true;
+	cameraInfo.isCulling = true;
+	cameraInfo.viewMatrix = glm::lookAt(cameraInfo.position, cameraInfo.position + cameraInfo.front, cameraInfo.up);
+	cameraInfo.fov = 45;
+	cameraInfo.farFrustum = 1000.0f;
+	cameraInfo.nearFrustum = 0.1f;
+	cameraInfo.aspect = (1920.0f / 1080.0f);
+	cameraInfo.projectionMatrix = glm::perspective(glm::radians(cameraInfo.fov), cameraInfo.aspect, cameraInfo.nearFrustum, cameraInfo.farFrustum);
+
+	auto camera = entity.AddComponent<dm::Camera>(cameraInfo);
+
+	//Skybox
+	CreateSkybox(entityManager);
+
+	dm::PrefabFactor::CreatePlane(glm::vec3(0, 0, 0));
+
+	//Every prefab shares its mesh and its textures, each kind is drawn with one instanced draw
+	const int forestSize = 40;
+	for (int x = 0; x < forestSize; x++)
+	{
+		for (int z = 0; z < forestSize; z++)
+		{
+			const auto position = glm::vec3((x - forestSize / 2) * 3.0f, 0, (z - forestSize / 2) * 3.0f);
+
+			switch ((x + z * 3) % 7)
+			{
+			case 0: dm::PrefabFactor::CreateTree1(position); break;
+			case 1: dm::PrefabFactor::CreateTree2(position); break;
+			case 2: dm::PrefabFactor::CreateTree3(position); break;
+			case 3: dm::PrefabFactor::CreateTree4(position); break;
+			case 4: dm::PrefabFactor::CreateTree5(position); break;
+			case 5: dm::PrefabFactor::CreateRock1(position); break;
+			default: dm::PrefabFactor::CreateRock2(position); break;
+			}
+		}
+	}
+
+	//DirectionalLight
+	const auto e1 = entityManager->CreateEntity();
+	auto sun = dm::EntityHandle(e1);
+	dm::DirectionalLight sunLightComponent;
+	sunLightComponent.componentType = ComponentType::DIRECTIONAL_LIGHT;
+	sun.AddComponent(sunLightComponent);
+
+	try
+	{
+		engine.Start();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << "\n";
+	}
+
+	ASSERT_TRUE(editor->drawStats.has_value());
+
+	//The ground plane is the only other default mesh
+	const uint32_t treeNmb = forestSize * forestSize;
+	EXPECT_EQ(treeNmb + 1, editor->drawStats->instanceCount);
+	EXPECT_LT(editor->drawStats->drawCount, treeNmb);
+}
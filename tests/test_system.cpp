@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2019 Nicolas Schneider
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <engine/engine.h>
+#include <system/system_manager.h>
+
+namespace
+{
+/**
+ * \brief Steps of the systems of a test and the number of systems running at the same time
+ */
+struct Timeline
+{
+	std::atomic<uint32_t> step{ 0 };
+	std::atomic<uint32_t> running{ 0 };
+	std::atomic<uint32_t> maxRunning{ 0 };
+};
+
+/**
+ * \brief System reading or writing one component. It records the step of its start and of its end, a system waiting for
+ * another one stays running until two systems ran at the same time or a timeout, the others sleep a bit
+ */
+class AccessSystem : public dm::System
+{
+public:
+	AccessSystem(Timeline& timeline, const ComponentType componentType, const bool write, const bool waitForOther) :
+		m_Timeline(timeline),
+		m_WaitForOther(waitForOther)
+	{
+		if (write)
+		{
+			AddWriteAccess(componentType);
+		}
+		else
+		{
+			AddReadAccess(componentType);
+		}
+	}
+
+	void Update() override
+	{
+		start = m_Timeline.step++;
+
+		const auto running = ++m_Timeline.running;
+		auto maxRunning = m_Timeline.maxRunning.load();
+		while (maxRunning < running && !m_Timeline.maxRunning.compare_exchange_weak(maxRunning, running)) {}
+
+		if (m_WaitForOther)
+		{
+			const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+			while (m_Timeline.maxRunning < 2 && std::chrono::steady_clock::now() < timeout)
+			{
+				std::this_thread::yield();
+			}
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+
+		--m_Timeline.running;
+		end = m_Timeline.step++;
+	}
+
+	uint32_t start = 0;
+	uint32_t end = 0;
+private:
+	Timeline& m_Timeline;
+	bool m_WaitForOther;
+};
+}
+
+TEST(System, ReadersRunConcurrently)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	Timeline timeline;
+	auto systemManager = engine.GetSystemManager();
+	systemManager->AddSystem<AccessSystem>(timeline, ComponentType::TRANSFORM, false, true);
+	systemManager->AddSystem<AccessSystem>(timeline, ComponentType::TRANSFORM, false, true);
+
+	systemManager->Update();
+
+	//Each reader waits for the other one, they only both finish without timeout if they overlap
+	EXPECT_EQ(timeline.maxRunning, 2);
+}
+
+TEST(System, WriterAfterReader)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	Timeline timeline;
+	auto systemManager = engine.GetSystemManager();
+	const auto reader = systemManager->AddSystem<AccessSystem>(timeline, ComponentType::TRANSFORM, false, false);
+	const auto writer = systemManager->AddSystem<AccessSystem>(timeline, ComponentType::TRANSFORM, true, false);
+
+	systemManager->Update();
+
+	EXPECT_LT(reader->end, writer->start);
+	EXPECT_EQ(timeline.maxRunning, 1);
+}
+
+TEST(System, WritersSerialized)
+{
+	dm::Engine engine;
+	engine.Init();
+
+	Timeline timeline;
+	auto systemManager = engine.GetSystemManager();
+	const auto first = systemManager->AddSystem<AccessSystem>(timeline, ComponentType::TRANSFORM, true, false);
+	const auto second = systemManager->AddSystem<AccessSystem>(timeline, ComponentType::TRANSFORM, true, false);
+	const auto third = systemManager->AddSystem<AccessSystem>(timeline, ComponentType::TRANSFORM, true, false);
+
+	systemManager->Update();
+
+	EXPECT_LT(first->end, second->start);
+	EXPECT_LT(second->end, third->start);
+	EXPECT_EQ(timeline.maxRunning, 1);
+}